@@ -0,0 +1,216 @@
+#include "FloatPixelConverter.hpp"
+
+#include <emmintrin.h>
+
+#include <cstring>
+
+namespace
+{
+// Four source pixels, one per register in R, G, B, A order
+struct PixelQuad
+{
+    __m128 Pixels[4];
+};
+
+// Converts the magnitude of four floats to floats with a 5 bit exponent and MantissaBits bits of mantissa, 10 for
+// half floats and 6 or 5 for the channels of R11G11B10_FLOAT, leaving the sign to the caller.
+// Bit twiddling instead of F16C keeps this to SSE2, which every x64 CPU has.
+template <int32_t MantissaBits>
+__m128i EncodeSmallFloat(const __m128i magnitude)
+{
+    constexpr int32_t MantissaShift = 23 - MantissaBits;
+    constexpr int32_t Infinity = 0x1F << MantissaBits;
+
+    // At 2^16 and above the exponent does not fit anymore, those become infinity while NaNs stay NaN
+    const __m128i isOverflow = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(((127 + 16) << 23) - 1));
+    const __m128i isNan = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(255 << 23));
+    const __m128i overflow = _mm_or_si128(
+        _mm_set1_epi32(Infinity),
+        _mm_and_si128(isNan, _mm_set1_epi32(1 << (MantissaBits - 1))));
+
+    // Below 2^-14 the result is denormal, adding a magic number shifts the mantissa into place and lets the FPU round it
+    const __m128i denormalMagic = _mm_set1_epi32(((127 - 15) + MantissaShift + 1) << 23);
+    const __m128i isDenormal = _mm_cmplt_epi32(magnitude, _mm_set1_epi32((127 - 14) << 23));
+    const __m128i denormal = _mm_sub_epi32(
+        _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(magnitude), _mm_castsi128_ps(denormalMagic))),
+        denormalMagic);
+
+    // Normal values get their exponent rebiased, the dropped mantissa bits round to nearest even
+    const __m128i isMantissaOdd = _mm_and_si128(_mm_srli_epi32(magnitude, MantissaShift), _mm_set1_epi32(1));
+    __m128i normal = _mm_add_epi32(magnitude, _mm_set1_epi32(((15 - 127) << 23) + (1 << (MantissaShift - 1)) - 1));
+    normal = _mm_srli_epi32(_mm_add_epi32(normal, isMantissaOdd), MantissaShift);
+
+    const __m128i finite = _mm_or_si128(_mm_and_si128(isDenormal, denormal), _mm_andnot_si128(isDenormal, normal));
+    return _mm_or_si128(_mm_and_si128(isOverflow, overflow), _mm_andnot_si128(isOverflow, finite));
+}
+
+// Half floats in the low 16 bits of each lane, sign extended so _mm_packs_epi32 keeps them intact
+__m128i EncodeHalf(const __m128 value)
+{
+    const __m128i bits = _mm_castps_si128(value);
+    const __m128i sign = _mm_and_si128(bits, _mm_set1_epi32(static_cast<int32_t>(0x80000000)));
+    return _mm_or_si128(EncodeSmallFloat<10>(_mm_xor_si128(bits, sign)), _mm_srai_epi32(sign, 16));
+}
+
+template <int32_t MantissaBits>
+__m128i EncodeUnsignedSmallFloat(const __m128 value)
+{
+    const __m128i bits = _mm_castps_si128(value);
+    const __m128i isNegative = _mm_srai_epi32(bits, 31);
+    return _mm_andnot_si128(isNegative, EncodeSmallFloat<MantissaBits>(bits));
+}
+
+// 0..65535 biased by -32768 so _mm_packs_epi32 does not saturate them, NaN becomes 0
+__m128i EncodeUnorm16(const __m128 value)
+{
+    const __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    const __m128i scaled = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(65535.0f)), _mm_set1_ps(0.5f)));
+    return _mm_sub_epi32(scaled, _mm_set1_epi32(32768));
+}
+
+__m128i PackUnorm16(
+    const __m128i first,
+    const __m128i second)
+{
+    return _mm_xor_si128(_mm_packs_epi32(first, second), _mm_set1_epi16(static_cast<int16_t>(0x8000)));
+}
+
+// Writes four texels, destination has room for 4 * GetPackedPixelSize(format) bytes
+void PackPixelQuad(
+    PixelQuad quad,
+    const DXGI_FORMAT format,
+    uint8_t* destination)
+{
+    __m128i* texels = reinterpret_cast<__m128i*>(destination);
+    switch (format)
+    {
+    case DXGI_FORMAT::DXGI_FORMAT_R16G16B16A16_FLOAT:
+        _mm_storeu_si128(texels, _mm_packs_epi32(EncodeHalf(quad.Pixels[0]), EncodeHalf(quad.Pixels[1])));
+        _mm_storeu_si128(texels + 1, _mm_packs_epi32(EncodeHalf(quad.Pixels[2]), EncodeHalf(quad.Pixels[3])));
+        return;
+    case DXGI_FORMAT::DXGI_FORMAT_R16G16B16A16_UNORM:
+        _mm_storeu_si128(texels, PackUnorm16(EncodeUnorm16(quad.Pixels[0]), EncodeUnorm16(quad.Pixels[1])));
+        _mm_storeu_si128(texels + 1, PackUnorm16(EncodeUnorm16(quad.Pixels[2]), EncodeUnorm16(quad.Pixels[3])));
+        return;
+    default:
+        break;
+    }
+
+    // The remaining formats work on one channel of four pixels at a time, afterwards Pixels[0] holds the reds of all four
+    _MM_TRANSPOSE4_PS(quad.Pixels[0], quad.Pixels[1], quad.Pixels[2], quad.Pixels[3]);
+    switch (format)
+    {
+    case DXGI_FORMAT::DXGI_FORMAT_R16_FLOAT:
+        {
+            const __m128i halves = EncodeHalf(quad.Pixels[0]);
+            _mm_storel_epi64(texels, _mm_packs_epi32(halves, halves));
+        }
+        return;
+    case DXGI_FORMAT::DXGI_FORMAT_R16_UNORM:
+        {
+            const __m128i values = EncodeUnorm16(quad.Pixels[0]);
+            _mm_storel_epi64(texels, PackUnorm16(values, values));
+        }
+        return;
+    case DXGI_FORMAT::DXGI_FORMAT_R11G11B10_FLOAT:
+        {
+            const __m128i red = EncodeUnsignedSmallFloat<6>(quad.Pixels[0]);
+            const __m128i green = EncodeUnsignedSmallFloat<6>(quad.Pixels[1]);
+            const __m128i blue = EncodeUnsignedSmallFloat<5>(quad.Pixels[2]);
+            _mm_storeu_si128(texels, _mm_or_si128(_mm_or_si128(red, _mm_slli_epi32(green, 11)), _mm_slli_epi32(blue, 22)));
+        }
+        return;
+    default:
+        return;
+    }
+}
+} // namespace
+
+void DecodeHighPrecisionPixels(
+    const uint8_t* sourcePixels,
+    const uint32_t sourcePitch,
+    const uint32_t sourceChannelCount,
+    const bool isFloat,
+    const uint32_t width,
+    const uint32_t height,
+    float* destinationPixels)
+{
+    const uint32_t channelSize = isFloat ? 4 : 2;
+    for (uint32_t y = 0; y < height; y++)
+    {
+        const uint8_t* sourceRow = sourcePixels + static_cast<size_t>(height - 1 - y) * sourcePitch;
+        float* destinationRow = destinationPixels + static_cast<size_t>(y) * width * 4;
+        for (uint32_t x = 0; x < width; x++)
+        {
+            float pixel[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+            for (uint32_t channel = 0; channel < sourceChannelCount; channel++)
+            {
+                const uint8_t* value = sourceRow + (x * sourceChannelCount + channel) * channelSize;
+                if (isFloat)
+                {
+                    std::memcpy(&pixel[channel], value, sizeof(float));
+                }
+                else
+                {
+                    uint16_t integer = 0;
+                    std::memcpy(&integer, value, sizeof(uint16_t));
+                    pixel[channel] = static_cast<float>(integer) * (1.0f / 65535.0f);
+                }
+            }
+
+            std::memcpy(destinationRow + x * 4, pixel, sizeof(pixel));
+        }
+    }
+}
+
+uint32_t GetPackedPixelSize(const DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT::DXGI_FORMAT_R16G16B16A16_FLOAT:
+    case DXGI_FORMAT::DXGI_FORMAT_R16G16B16A16_UNORM:
+        return 8;
+    case DXGI_FORMAT::DXGI_FORMAT_R11G11B10_FLOAT:
+        return 4;
+    case DXGI_FORMAT::DXGI_FORMAT_R16_FLOAT:
+    case DXGI_FORMAT::DXGI_FORMAT_R16_UNORM:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+bool PackFloatPixels(
+    const float* pixels,
+    const size_t pixelCount,
+    const DXGI_FORMAT format,
+    uint8_t* destination)
+{
+    const uint32_t pixelSize = GetPackedPixelSize(format);
+    if (pixelSize == 0)
+    {
+        return false;
+    }
+
+    size_t pixel = 0;
+    for (; pixel + 4 <= pixelCount; pixel += 4)
+    {
+        const float* source = pixels + pixel * 4;
+        PixelQuad quad = { { _mm_loadu_ps(source), _mm_loadu_ps(source + 4), _mm_loadu_ps(source + 8), _mm_loadu_ps(source + 12) } };
+        PackPixelQuad(quad, format, destination + pixel * pixelSize);
+    }
+
+    // The last few pixels go through the same kernel padded to a whole quad
+    if (pixel < pixelCount)
+    {
+        const size_t remainingCount = pixelCount - pixel;
+        float remainingPixels[16] = {};
+        uint8_t packedPixels[32] = {};
+        std::memcpy(remainingPixels, pixels + pixel * 4, remainingCount * 4 * sizeof(float));
+        PixelQuad quad = { { _mm_loadu_ps(remainingPixels), _mm_loadu_ps(remainingPixels + 4), _mm_loadu_ps(remainingPixels + 8), _mm_loadu_ps(remainingPixels + 12) } };
+        PackPixelQuad(quad, format, packedPixels);
+        std::memcpy(destination + pixel * pixelSize, packedPixels, remainingCount * pixelSize);
+    }
+
+    return true;
+}
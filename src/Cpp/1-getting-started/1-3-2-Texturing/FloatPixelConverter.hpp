@@ -0,0 +1,30 @@
+#pragma once
+
+#include <d3d11.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// Decodes an image with 1 to 4 channels of 16 bit unsigned integers or 32 bit floats, stored bottom up in R, G, B, A
+// order the way FreeImage keeps its UINT16, RGB16, RGBA16, FLOAT, RGBF and RGBAF images, into top down rows of four
+// floats per pixel. Integers are normalized to 0..1, missing color channels become 0 and missing alpha 1.
+void DecodeHighPrecisionPixels(
+    const uint8_t* sourcePixels,
+    uint32_t sourcePitch,
+    uint32_t sourceChannelCount,
+    bool isFloat,
+    uint32_t width,
+    uint32_t height,
+    float* destinationPixels);
+
+// Packs pixels of four floats each into R16G16B16A16_FLOAT, R16_FLOAT, R11G11B10_FLOAT, R16G16B16A16_UNORM or
+// R16_UNORM texels, four pixels at a time. Floats are rounded to nearest even, values too large for the format become
+// infinity and R11G11B10_FLOAT has no sign, negative values become zero. Returns false for any other format.
+bool PackFloatPixels(
+    const float* pixels,
+    size_t pixelCount,
+    DXGI_FORMAT format,
+    uint8_t* destination);
+
+// Bytes per texel of the formats PackFloatPixels writes, 0 for any other format
+[[nodiscard]] uint32_t GetPackedPixelSize(DXGI_FORMAT format);
@@ -0,0 +1,400 @@
+#include "MipGenerator.hpp"
+
+#include <JobSystem.hpp>
+
+#include <DirectXMath.h>
+
+#include <cmath>
+#include <functional>
+
+namespace
+{
+constexpr float Pi = 3.14159265358979f;
+constexpr float WindowedSincRadius = 3.0f;
+constexpr float KaiserAlpha = 4.0f;
+// Levels smaller than this are filtered on the calling thread alone, waking the workers would cost more
+constexpr uint32_t MinParallelPixelCount = 1 << 14;
+constexpr uint32_t RowsPerJob = 16;
+
+// The taps of one output pixel along one axis, starting at FirstSource[i] in the level above
+struct AxisWeights
+{
+    uint32_t TapCount = 0;
+    std::vector<int32_t> FirstSource;
+    std::vector<float> Weights;
+};
+
+float Sinc(const float x)
+{
+    if (std::fabs(x) < 1e-5f)
+    {
+        return 1.0f;
+    }
+
+    return std::sin(Pi * x) / (Pi * x);
+}
+
+// Zeroth order modified Bessel function of the first kind, its series converges quickly for the window's range
+float BesselI0(const float x)
+{
+    const float halfXSquared = x * x * 0.25f;
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (uint32_t k = 1; k < 32 && term > sum * 1e-8f; k++)
+    {
+        term *= halfXSquared / static_cast<float>(k * k);
+        sum += term;
+    }
+
+    return sum;
+}
+
+float GetFilterRadius(const MipFilter filter)
+{
+    return filter == MipFilter::Box ? 0.5f : WindowedSincRadius;
+}
+
+float EvaluateFilter(
+    const MipFilter filter,
+    const float x)
+{
+    const float distance = std::fabs(x);
+    if (filter == MipFilter::Box)
+    {
+        return distance <= 0.5f ? 1.0f : 0.0f;
+    }
+
+    if (distance >= WindowedSincRadius)
+    {
+        return 0.0f;
+    }
+
+    if (filter == MipFilter::Lanczos)
+    {
+        return Sinc(x) * Sinc(x / WindowedSincRadius);
+    }
+
+    const float t = distance / WindowedSincRadius;
+    return Sinc(x) * BesselI0(KaiserAlpha * std::sqrt(1.0f - t * t)) / BesselI0(KaiserAlpha);
+}
+
+// Filter distances are measured in pixels of the smaller level, so the kernel covers twice as many source pixels
+AxisWeights ComputeAxisWeights(
+    const uint32_t sourceSize,
+    const uint32_t destinationSize,
+    const MipFilter filter)
+{
+    const float scale = static_cast<float>(sourceSize) / static_cast<float>(destinationSize);
+    const float support = GetFilterRadius(filter) * scale;
+
+    AxisWeights axisWeights = {};
+    axisWeights.TapCount = static_cast<uint32_t>(std::ceil(support * 2.0f)) + 1;
+    axisWeights.FirstSource.resize(destinationSize);
+    axisWeights.Weights.resize(static_cast<size_t>(destinationSize) * axisWeights.TapCount);
+    for (uint32_t i = 0; i < destinationSize; i++)
+    {
+        const float center = (static_cast<float>(i) + 0.5f) * scale;
+        const int32_t firstSource = static_cast<int32_t>(std::floor(center - support));
+        float* weights = &axisWeights.Weights[static_cast<size_t>(i) * axisWeights.TapCount];
+        float weightSum = 0.0f;
+        for (uint32_t tap = 0; tap < axisWeights.TapCount; tap++)
+        {
+            const float sourceCenter = static_cast<float>(firstSource + static_cast<int32_t>(tap)) + 0.5f;
+            weights[tap] = EvaluateFilter(filter, (sourceCenter - center) / scale);
+            weightSum += weights[tap];
+        }
+
+        for (uint32_t tap = 0; tap < axisWeights.TapCount; tap++)
+        {
+            weights[tap] = weightSum != 0.0f ? weights[tap] / weightSum : 0.0f;
+        }
+
+        axisWeights.FirstSource[i] = firstSource;
+    }
+
+    return axisWeights;
+}
+
+// Taps past the edge read the edge pixel again
+uint32_t ClampSource(
+    const int32_t source,
+    const uint32_t size)
+{
+    if (source < 0)
+    {
+        return 0;
+    }
+
+    return static_cast<uint32_t>(source) < size ? static_cast<uint32_t>(source) : size - 1;
+}
+
+void RunRowJobs(
+    const uint32_t jobCount,
+    const bool isParallel,
+    const std::function<void(uint32_t)>& job)
+{
+    if (!isParallel)
+    {
+        for (uint32_t jobIndex = 0; jobIndex < jobCount; jobIndex++)
+        {
+            job(jobIndex);
+        }
+        return;
+    }
+
+    JobSystem::Get().RunJobs(jobCount, [&](const uint32_t jobIndex)
+    {
+        job(jobIndex);
+        return true;
+    });
+}
+
+DirectX::XMVECTOR DecodePixel(
+    const uint8_t* pixel,
+    const uint32_t channelCount,
+    const bool isSrgb)
+{
+    float channels[4] = {};
+    for (uint32_t channel = 0; channel < channelCount; channel++)
+    {
+        channels[channel] = static_cast<float>(pixel[channel]) * (1.0f / 255.0f);
+    }
+
+    const DirectX::XMVECTOR color = DirectX::XMVectorSet(channels[0], channels[1], channels[2], channels[3]);
+    return isSrgb ? DirectX::XMColorSRGBToRGB(color) : color;
+}
+
+void EncodePixel(
+    DirectX::FXMVECTOR color,
+    const uint32_t channelCount,
+    const bool isSrgb,
+    uint8_t* pixel)
+{
+    DirectX::XMVECTOR encodedColor = color;
+    if (isSrgb)
+    {
+        encodedColor = DirectX::XMColorRGBToSRGB(encodedColor);
+    }
+
+    DirectX::XMFLOAT4 channels;
+    DirectX::XMStoreFloat4(&channels, DirectX::XMVectorMultiplyAdd(encodedColor, DirectX::XMVectorReplicate(255.0f), DirectX::XMVectorReplicate(0.5f)));
+    const float values[4] = { channels.x, channels.y, channels.z, channels.w };
+    for (uint32_t channel = 0; channel < channelCount; channel++)
+    {
+        pixel[channel] = static_cast<uint8_t>(values[channel]);
+    }
+}
+// The levels below width x height, RowPitch and Offset count pixelSize elements
+std::vector<MipLevel> ComputeMipLevels(
+    const uint32_t width,
+    const uint32_t height,
+    const uint32_t pixelSize)
+{
+    std::vector<MipLevel> mipLevels;
+    uint32_t levelWidth = width;
+    uint32_t levelHeight = height;
+    size_t offset = 0;
+    while (levelWidth > 1 || levelHeight > 1)
+    {
+        levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+        levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+
+        MipLevel mipLevel = {};
+        mipLevel.Width = levelWidth;
+        mipLevel.Height = levelHeight;
+        mipLevel.RowPitch = levelWidth * pixelSize;
+        mipLevel.Offset = offset;
+        mipLevels.push_back(mipLevel);
+        offset += static_cast<size_t>(mipLevel.RowPitch) * levelHeight;
+    }
+
+    return mipLevels;
+}
+
+size_t GetMipDataSize(const std::vector<MipLevel>& mipLevels)
+{
+    return mipLevels.empty() ? 0 : mipLevels.back().Offset + static_cast<size_t>(mipLevels.back().RowPitch) * mipLevels.back().Height;
+}
+
+// Filters every level in mipLevels from the one above it, starting with source which holds the linear pixels of the
+// image itself, and hands each finished row to storeRow
+void FilterMipChain(
+    std::vector<DirectX::XMFLOAT4A>& source,
+    const uint32_t width,
+    const uint32_t height,
+    const MipFilter filter,
+    const bool isHdr,
+    const std::vector<MipLevel>& mipLevels,
+    const std::function<void(const MipLevel&, uint32_t, const DirectX::XMFLOAT4A*)>& storeRow)
+{
+    uint32_t sourceWidth = width;
+    uint32_t sourceHeight = height;
+    std::vector<DirectX::XMFLOAT4A> horizontal;
+    std::vector<DirectX::XMFLOAT4A> destination;
+    for (const MipLevel& mipLevel : mipLevels)
+    {
+        const uint32_t destinationWidth = mipLevel.Width;
+        const uint32_t destinationHeight = mipLevel.Height;
+        const AxisWeights horizontalWeights = ComputeAxisWeights(sourceWidth, destinationWidth, filter);
+        const AxisWeights verticalWeights = ComputeAxisWeights(sourceHeight, destinationHeight, filter);
+        const bool isParallel = sourceWidth * sourceHeight >= MinParallelPixelCount;
+
+        // Separable, the rows are narrowed first and the narrowed columns shortened afterwards
+        horizontal.resize(static_cast<size_t>(destinationWidth) * sourceHeight);
+        RunRowJobs((sourceHeight + RowsPerJob - 1) / RowsPerJob, isParallel, [&](const uint32_t jobIndex)
+        {
+            const uint32_t lastRow = (jobIndex + 1) * RowsPerJob < sourceHeight ? (jobIndex + 1) * RowsPerJob : sourceHeight;
+            for (uint32_t y = jobIndex * RowsPerJob; y < lastRow; y++)
+            {
+                const DirectX::XMFLOAT4A* sourceRow = &source[static_cast<size_t>(y) * sourceWidth];
+                for (uint32_t x = 0; x < destinationWidth; x++)
+                {
+                    const float* weights = &horizontalWeights.Weights[static_cast<size_t>(x) * horizontalWeights.TapCount];
+                    DirectX::XMVECTOR sum = DirectX::XMVectorZero();
+                    for (uint32_t tap = 0; tap < horizontalWeights.TapCount; tap++)
+                    {
+                        const uint32_t sourceX = ClampSource(horizontalWeights.FirstSource[x] + static_cast<int32_t>(tap), sourceWidth);
+                        sum = DirectX::XMVectorMultiplyAdd(DirectX::XMLoadFloat4A(&sourceRow[sourceX]), DirectX::XMVectorReplicate(weights[tap]), sum);
+                    }
+
+                    DirectX::XMStoreFloat4A(&horizontal[static_cast<size_t>(y) * destinationWidth + x], sum);
+                }
+            }
+        });
+
+        destination.resize(static_cast<size_t>(destinationWidth) * destinationHeight);
+        RunRowJobs((destinationHeight + RowsPerJob - 1) / RowsPerJob, isParallel, [&](const uint32_t jobIndex)
+        {
+            const uint32_t lastRow = (jobIndex + 1) * RowsPerJob < destinationHeight ? (jobIndex + 1) * RowsPerJob : destinationHeight;
+            for (uint32_t y = jobIndex * RowsPerJob; y < lastRow; y++)
+            {
+                const float* weights = &verticalWeights.Weights[static_cast<size_t>(y) * verticalWeights.TapCount];
+                DirectX::XMFLOAT4A* destinationRow = &destination[static_cast<size_t>(y) * destinationWidth];
+                for (uint32_t x = 0; x < destinationWidth; x++)
+                {
+                    DirectX::XMVECTOR sum = DirectX::XMVectorZero();
+                    for (uint32_t tap = 0; tap < verticalWeights.TapCount; tap++)
+                    {
+                        const uint32_t sourceY = ClampSource(verticalWeights.FirstSource[y] + static_cast<int32_t>(tap), sourceHeight);
+                        sum = DirectX::XMVectorMultiplyAdd(
+                            DirectX::XMLoadFloat4A(&horizontal[static_cast<size_t>(sourceY) * destinationWidth + x]),
+                            DirectX::XMVectorReplicate(weights[tap]),
+                            sum);
+                    }
+
+                    // Clamped before the next level is filtered from it, ringing would build up over the chain otherwise.
+                    // HDR values have no upper bound, only the negative lobes are cut off
+                    sum = isHdr ? DirectX::XMVectorMax(sum, DirectX::XMVectorZero()) : DirectX::XMVectorSaturate(sum);
+                    DirectX::XMStoreFloat4A(&destinationRow[x], sum);
+                }
+
+                storeRow(mipLevel, y, destinationRow);
+            }
+        });
+
+        source.swap(destination);
+        sourceWidth = destinationWidth;
+        sourceHeight = destinationHeight;
+    }
+}
+
+// Decodes the rows of an image into source, a job per RowsPerJob rows
+void DecodeRows(
+    const uint32_t width,
+    const uint32_t height,
+    std::vector<DirectX::XMFLOAT4A>& source,
+    const std::function<DirectX::XMVECTOR(uint32_t, uint32_t)>& decodePixel)
+{
+    source.resize(static_cast<size_t>(width) * height);
+    RunRowJobs((height + RowsPerJob - 1) / RowsPerJob, width * height >= MinParallelPixelCount, [&](const uint32_t jobIndex)
+    {
+        const uint32_t lastRow = (jobIndex + 1) * RowsPerJob < height ? (jobIndex + 1) * RowsPerJob : height;
+        for (uint32_t y = jobIndex * RowsPerJob; y < lastRow; y++)
+        {
+            for (uint32_t x = 0; x < width; x++)
+            {
+                DirectX::XMStoreFloat4A(&source[static_cast<size_t>(y) * width + x], decodePixel(x, y));
+            }
+        }
+    });
+}
+} // namespace
+
+void GenerateMipChain(
+    const uint8_t* pixels,
+    const uint32_t width,
+    const uint32_t height,
+    const uint32_t rowPitch,
+    const uint32_t channelCount,
+    const bool isSrgb,
+    const MipFilter filter,
+    std::vector<uint8_t>& mipData,
+    std::vector<MipLevel>& mipLevels)
+{
+    mipData.clear();
+    mipLevels.clear();
+    if (width == 0 || height == 0 || channelCount == 0 || channelCount > 4)
+    {
+        return;
+    }
+
+    // Alpha is never sRGB encoded, XMColorSRGBToRGB leaves the w component alone
+    const bool isSrgbImage = isSrgb && channelCount >= 3;
+
+    mipLevels = ComputeMipLevels(width, height, channelCount);
+    mipData.resize(GetMipDataSize(mipLevels));
+
+    // Every level is kept as linear floats while the next one is filtered from it
+    std::vector<DirectX::XMFLOAT4A> source;
+    DecodeRows(width, height, source, [&](const uint32_t x, const uint32_t y)
+    {
+        return DecodePixel(pixels + static_cast<size_t>(y) * rowPitch + x * channelCount, channelCount, isSrgbImage);
+    });
+
+    FilterMipChain(source, width, height, filter, false, mipLevels, [&](const MipLevel& mipLevel, const uint32_t y, const DirectX::XMFLOAT4A* row)
+    {
+        uint8_t* encodedRow = &mipData[mipLevel.Offset + static_cast<size_t>(y) * mipLevel.RowPitch];
+        for (uint32_t x = 0; x < mipLevel.Width; x++)
+        {
+            EncodePixel(DirectX::XMLoadFloat4A(&row[x]), channelCount, isSrgbImage, encodedRow + x * channelCount);
+        }
+    });
+}
+
+void GenerateMipChain(
+    const float* pixels,
+    const uint32_t width,
+    const uint32_t height,
+    const bool isSrgb,
+    const bool isHdr,
+    const MipFilter filter,
+    std::vector<float>& mipData,
+    std::vector<MipLevel>& mipLevels)
+{
+    mipData.clear();
+    mipLevels.clear();
+    if (width == 0 || height == 0)
+    {
+        return;
+    }
+
+    mipLevels = ComputeMipLevels(width, height, 4);
+    mipData.resize(GetMipDataSize(mipLevels));
+
+    std::vector<DirectX::XMFLOAT4A> source;
+    DecodeRows(width, height, source, [&](const uint32_t x, const uint32_t y)
+    {
+        const DirectX::XMVECTOR color = DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(pixels + (static_cast<size_t>(y) * width + x) * 4));
+        return isSrgb ? DirectX::XMColorSRGBToRGB(color) : color;
+    });
+
+    FilterMipChain(source, width, height, filter, isHdr, mipLevels, [&](const MipLevel& mipLevel, const uint32_t y, const DirectX::XMFLOAT4A* row)
+    {
+        float* encodedRow = &mipData[mipLevel.Offset + static_cast<size_t>(y) * mipLevel.RowPitch];
+        for (uint32_t x = 0; x < mipLevel.Width; x++)
+        {
+            const DirectX::XMVECTOR color = DirectX::XMLoadFloat4A(&row[x]);
+            DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(encodedRow + x * 4), isSrgb ? DirectX::XMColorRGBToSRGB(color) : color);
+        }
+    });
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class MipFilter
+{
+    Box,
+    Kaiser,
+    Lanczos
+};
+
+struct MipLevel
+{
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t RowPitch = 0;
+    size_t Offset = 0;
+};
+
+// Builds the mip chain below an image with 8 bits per channel and 1 to 4 channels, down to 1x1.
+// Every level is filtered from the one above it in linear space: the color channels of sRGB images
+// are decoded first and encoded again afterwards, alpha and non color images are filtered as they are.
+// mipLevels describes level 1 onwards, their pixels are packed one after another into mipData.
+void GenerateMipChain(
+    const uint8_t* pixels,
+    uint32_t width,
+    uint32_t height,
+    uint32_t rowPitch,
+    uint32_t channelCount,
+    bool isSrgb,
+    MipFilter filter,
+    std::vector<uint8_t>& mipData,
+    std::vector<MipLevel>& mipLevels);
+
+// The same for images with four float channels per pixel, such as HDR images or images with 16 bits per channel
+// that were normalized to 0..1. HDR images are linear and only clamped to zero between levels, normalized ones are
+// saturated. For these RowPitch and Offset count floats instead of bytes.
+void GenerateMipChain(
+    const float* pixels,
+    uint32_t width,
+    uint32_t height,
+    bool isSrgb,
+    bool isHdr,
+    MipFilter filter,
+    std::vector<float>& mipData,
+    std::vector<MipLevel>& mipLevels);
@@ -0,0 +1,130 @@
+#include "PixelConverter.hpp"
+
+#include <intrin.h>
+#include <tmmintrin.h>
+
+#include <cstring>
+
+namespace
+{
+// pshufb needs SSSE3, which is not part of the x64 baseline the samples are built for
+bool IsSsse3Supported()
+{
+    int cpuInfo[4] = {};
+    __cpuid(cpuInfo, 1);
+    return (cpuInfo[2] & (1 << 9)) != 0;
+}
+
+uint8_t PremultiplyChannel(
+    const uint32_t channel,
+    const uint32_t alpha)
+{
+    // channel * alpha / 255, rounded, without a division
+    const uint32_t product = channel * alpha + 128;
+    return static_cast<uint8_t>((product + (product >> 8)) >> 8);
+}
+
+// Four RGBA pixels, every color channel multiplied by its pixel's alpha the same way PremultiplyChannel does
+__m128i PremultiplyPixels(const __m128i pixels)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i opaque = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    const __m128i rounding = _mm_set1_epi16(128);
+
+    __m128i halves[2] = { _mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero) };
+    for (__m128i& half : halves)
+    {
+        // Alpha itself is multiplied by 255 so it comes out unchanged
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(half, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        alpha = _mm_or_si128(_mm_andnot_si128(alphaLanes, alpha), opaque);
+        const __m128i product = _mm_add_epi16(_mm_mullo_epi16(half, alpha), rounding);
+        half = _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+    }
+
+    return _mm_packus_epi16(halves[0], halves[1]);
+}
+
+void ConvertPixel(
+    const uint8_t* source,
+    const uint32_t sourceChannelCount,
+    const bool isPremultiplyingAlpha,
+    uint8_t* destination)
+{
+    const uint8_t alpha = sourceChannelCount == 4 ? source[3] : 255;
+    if (isPremultiplyingAlpha)
+    {
+        destination[0] = PremultiplyChannel(source[2], alpha);
+        destination[1] = PremultiplyChannel(source[1], alpha);
+        destination[2] = PremultiplyChannel(source[0], alpha);
+    }
+    else
+    {
+        destination[0] = source[2];
+        destination[1] = source[1];
+        destination[2] = source[0];
+    }
+    destination[3] = alpha;
+}
+} // namespace
+
+uint32_t GetConvertedChannelCount(const uint32_t sourceChannelCount)
+{
+    return sourceChannelCount == 3 ? 4 : sourceChannelCount;
+}
+
+void ConvertPixels(
+    const uint8_t* sourcePixels,
+    const uint32_t sourcePitch,
+    const uint32_t sourceChannelCount,
+    const uint32_t width,
+    const uint32_t height,
+    const bool isPremultiplyingAlpha,
+    uint8_t* destinationPixels,
+    const uint32_t destinationPitch)
+{
+    static const bool isSsse3Supported = IsSsse3Supported();
+
+    // Each output pixel takes its bytes from the same pixel in BGR(A) order, 0x80 writes a zero which opaque alpha fills in
+    const __m128i bgrToRgba = _mm_setr_epi8(2, 1, 0, -128, 5, 4, 3, -128, 8, 7, 6, -128, 11, 10, 9, -128);
+    const __m128i bgraToRgba = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    const __m128i opaqueAlpha = _mm_set1_epi32(static_cast<int32_t>(0xFF000000));
+    // Premultiplying opaque pixels changes nothing
+    const bool isPremultiplying = isPremultiplyingAlpha && sourceChannelCount == 4;
+    const uint32_t rowSize = width * sourceChannelCount;
+
+    for (uint32_t y = 0; y < height; y++)
+    {
+        const uint8_t* sourceRow = sourcePixels + static_cast<size_t>(height - 1 - y) * sourcePitch;
+        uint8_t* destinationRow = destinationPixels + static_cast<size_t>(y) * destinationPitch;
+        if (sourceChannelCount < 3)
+        {
+            std::memcpy(destinationRow, sourceRow, rowSize);
+            continue;
+        }
+
+        // Four pixels at a time, a 16 byte load must not read past the end of the row
+        uint32_t x = 0;
+        if (isSsse3Supported)
+        {
+            const __m128i shuffle = sourceChannelCount == 3 ? bgrToRgba : bgraToRgba;
+            const __m128i alpha = sourceChannelCount == 3 ? opaqueAlpha : _mm_setzero_si128();
+            for (; x + 4 <= width && x * sourceChannelCount + 16 <= rowSize; x += 4)
+            {
+                const __m128i sourceBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceRow + x * sourceChannelCount));
+                __m128i pixels = _mm_or_si128(_mm_shuffle_epi8(sourceBytes, shuffle), alpha);
+                if (isPremultiplying)
+                {
+                    pixels = PremultiplyPixels(pixels);
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destinationRow + x * 4), pixels);
+            }
+        }
+
+        for (; x < width; x++)
+        {
+            ConvertPixel(sourceRow + x * sourceChannelCount, sourceChannelCount, isPremultiplying, destinationRow + x * 4);
+        }
+    }
+}
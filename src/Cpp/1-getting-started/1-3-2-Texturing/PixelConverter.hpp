@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+// Converts an image with 8 bits per channel, stored bottom up with its color channels in B, G, R(, A)
+// order the way FreeImage keeps them on little endian machines, into top down R, G, B, A rows ready
+// for upload. Flipping, expanding three channels to four with opaque alpha, swizzling and optionally
+// premultiplying alpha all happen in one pass. One and two channel images are only flipped.
+void ConvertPixels(
+    const uint8_t* sourcePixels,
+    uint32_t sourcePitch,
+    uint32_t sourceChannelCount,
+    uint32_t width,
+    uint32_t height,
+    bool isPremultiplyingAlpha,
+    uint8_t* destinationPixels,
+    uint32_t destinationPitch);
+
+// Three channel images come out with four
+[[nodiscard]] uint32_t GetConvertedChannelCount(uint32_t sourceChannelCount);
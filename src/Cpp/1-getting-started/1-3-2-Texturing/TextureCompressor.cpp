@@ -0,0 +1,117 @@
+#include "TextureCompressor.hpp"
+
+#include <JobSystem.hpp>
+
+#include <DirectXTex.h>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+// 64 pixel rows per job, small enough to keep every core busy on the first level
+constexpr uint32_t BlockRowsPerJob = 16;
+
+struct CompressionJob
+{
+    uint32_t ImageIndex = 0;
+    uint32_t FirstBlockRow = 0;
+    uint32_t BlockRowCount = 0;
+};
+
+uint32_t GetCompressionFlags(
+    const DXGI_FORMAT format,
+    const TextureCompressionQuality quality)
+{
+    // Parallelism comes from the bands, DirectXTex is not asked to start threads of its own
+    switch (quality)
+    {
+    case TextureCompressionQuality::Fast:
+        return DirectX::TEX_COMPRESS_BC7_QUICK;
+    case TextureCompressionQuality::Balanced:
+        return DirectX::TEX_COMPRESS_DEFAULT;
+    case TextureCompressionQuality::High:
+        return format == DXGI_FORMAT::DXGI_FORMAT_BC7_UNORM
+                   ? DirectX::TEX_COMPRESS_BC7_USE_3SUBSETS
+                   : DirectX::TEX_COMPRESS_DITHER;
+    }
+
+    return DirectX::TEX_COMPRESS_DEFAULT;
+}
+} // namespace
+
+DXGI_FORMAT SelectCompressedFormat(
+    const uint32_t channelCount,
+    const bool hasAlpha,
+    const TextureCompressionQuality quality)
+{
+    if (channelCount == 1)
+    {
+        return DXGI_FORMAT::DXGI_FORMAT_BC4_UNORM;
+    }
+
+    if (channelCount == 2)
+    {
+        return DXGI_FORMAT::DXGI_FORMAT_BC5_UNORM;
+    }
+
+    if (quality == TextureCompressionQuality::High || (hasAlpha && quality == TextureCompressionQuality::Balanced))
+    {
+        return DXGI_FORMAT::DXGI_FORMAT_BC7_UNORM;
+    }
+
+    return hasAlpha ? DXGI_FORMAT::DXGI_FORMAT_BC3_UNORM : DXGI_FORMAT::DXGI_FORMAT_BC1_UNORM;
+}
+
+bool CompressTexture(
+    const DirectX::ScratchImage& source,
+    const DXGI_FORMAT format,
+    const TextureCompressionQuality quality,
+    DirectX::ScratchImage& compressed)
+{
+    DirectX::TexMetadata metaData = source.GetMetadata();
+    metaData.format = format;
+    if (FAILED(compressed.Initialize(metaData)))
+    {
+        return false;
+    }
+
+    std::vector<CompressionJob> jobs;
+    for (size_t i = 0; i < source.GetImageCount(); i++)
+    {
+        const uint32_t blockRowCount = static_cast<uint32_t>((source.GetImages()[i].height + 3) / 4);
+        for (uint32_t firstBlockRow = 0; firstBlockRow < blockRowCount; firstBlockRow += BlockRowsPerJob)
+        {
+            const uint32_t remainingCount = blockRowCount - firstBlockRow;
+            jobs.push_back(CompressionJob{ static_cast<uint32_t>(i), firstBlockRow, remainingCount < BlockRowsPerJob ? remainingCount : BlockRowsPerJob });
+        }
+    }
+
+    const uint32_t compressionFlags = GetCompressionFlags(format, quality);
+    return JobSystem::Get().RunJobs(static_cast<uint32_t>(jobs.size()), [&](const uint32_t jobIndex)
+    {
+        const CompressionJob& job = jobs[jobIndex];
+        const DirectX::Image& sourceImage = source.GetImages()[job.ImageIndex];
+        const DirectX::Image& compressedImage = compressed.GetImages()[job.ImageIndex];
+
+        // A band is an image of its own, made of whole block rows, so it compresses exactly like its part of the level
+        const size_t firstRow = static_cast<size_t>(job.FirstBlockRow) * 4;
+        const size_t rowCount = static_cast<size_t>(job.BlockRowCount) * 4;
+        DirectX::Image band = sourceImage;
+        band.height = sourceImage.height - firstRow < rowCount ? sourceImage.height - firstRow : rowCount;
+        band.pixels = sourceImage.pixels + firstRow * sourceImage.rowPitch;
+        band.slicePitch = band.rowPitch * band.height;
+
+        DirectX::ScratchImage compressedBand;
+        if (FAILED(DirectX::Compress(band, format, compressionFlags, DirectX::TEX_THRESHOLD_DEFAULT, compressedBand)))
+        {
+            return false;
+        }
+
+        std::memcpy(
+            compressedImage.pixels + static_cast<size_t>(job.FirstBlockRow) * compressedImage.rowPitch,
+            compressedBand.GetPixels(),
+            compressedBand.GetPixelsSize());
+        return true;
+    });
+}
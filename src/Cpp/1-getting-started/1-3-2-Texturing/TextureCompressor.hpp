@@ -0,0 +1,33 @@
+#pragma once
+
+#include <d3d11.h>
+
+#include <cstdint>
+
+namespace DirectX
+{
+class ScratchImage;
+}
+
+// Fast picks BC1/BC3 and quick BC7 modes, Balanced prefers BC7 for anything with alpha,
+// High uses BC7 for every color image and lets it search its three subset modes as well
+enum class TextureCompressionQuality
+{
+    Fast,
+    Balanced,
+    High
+};
+
+// BC4 for one channel, BC5 for two, BC1 or BC7 for opaque and BC3 or BC7 for transparent color images
+DXGI_FORMAT SelectCompressedFormat(
+    uint32_t channelCount,
+    bool hasAlpha,
+    TextureCompressionQuality quality);
+
+// Block compresses every image of source into format. Images are split into bands of block rows
+// which are encoded on all cores at once, so a single large mip level does not end up on one thread.
+bool CompressTexture(
+    const DirectX::ScratchImage& source,
+    DXGI_FORMAT format,
+    TextureCompressionQuality quality,
+    DirectX::ScratchImage& compressed);
@@ -1,5 +1,10 @@
 #include "TexturingApplication.hpp"
+#include "FloatPixelConverter.hpp"
+#include "MipGenerator.hpp"
+#include "PixelConverter.hpp"
 #include "ShaderCollection.hpp"
+#include "TextureCompressor.hpp"
+#include <Hash.hpp>
 
 #include <GLFW/glfw3.h>
 #define GLFW_EXPOSE_NATIVE_WIN32
@@ -12,6 +17,9 @@
 #include <DirectXTex.h>
 #include <FreeImage.h>
 
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 
 #pragma comment(lib, "d3d11.lib")
@@ -139,6 +147,24 @@ bool TexturingApplication::Initialize()
     return true;
 }
 
+//DirectX::CreateShaderResourceView creates the texture and derives the view from it, the pixels are uploaded once
+WRL::ComPtr<ID3D11ShaderResourceView> CreateTextureViewFromImages(ID3D11Device* device, const DirectX::ScratchImage& scratchImage)
+{
+    WRL::ComPtr<ID3D11ShaderResourceView> srv = nullptr;
+    if (FAILED(DirectX::CreateShaderResourceView(
+            device,
+            scratchImage.GetImages(),
+            scratchImage.GetImageCount(),
+            scratchImage.GetMetadata(),
+            &srv)))
+    {
+        std::cerr << "DXTEX: Failed to create shader resource view out of texture\n";
+        return nullptr;
+    }
+
+    return srv;
+}
+
 WRL::ComPtr<ID3D11ShaderResourceView> CreateTextureViewFromDDS(ID3D11Device* device, const std::wstring& pathToDDS)
 {
     DirectX::TexMetadata metaData = {};
@@ -149,40 +175,150 @@ WRL::ComPtr<ID3D11ShaderResourceView> CreateTextureViewFromDDS(ID3D11Device* dev
         return nullptr;
     }
 
-    WRL::ComPtr<ID3D11Resource> texture = nullptr;
-    if (FAILED(DirectX::CreateTexture(
-            device,
+    return CreateTextureViewFromImages(device, scratchImage);
+}
+
+
+//Compressed textures are cached as DDS files named after a hash of the source file and the settings they were made with,
+//bump the version whenever the pixel conversion, the mip chain or the encoder changes
+constexpr uint32_t TextureCacheVersion = 2;
+const std::filesystem::path TextureCacheDirectory = "TextureCache";
+
+std::filesystem::path GetCachedTexturePath(const std::vector<BYTE>& fileData, TextureCompressionQuality quality, bool isPremultiplyingAlpha)
+{
+    uint64_t key = HashBytes(fileData.data(), fileData.size());
+    key = HashBytes(&quality, sizeof(quality), key);
+    key = HashBytes(&isPremultiplyingAlpha, sizeof(isPremultiplyingAlpha), key);
+    key = HashBytes(&TextureCacheVersion, sizeof(TextureCacheVersion), key);
+
+    char cacheFileName[32] = {};
+    snprintf(cacheFileName, sizeof(cacheFileName), "%016llx.dds", static_cast<unsigned long long>(key));
+    return TextureCacheDirectory / cacheFileName;
+}
+
+//Written to a temporary file first so a crash never leaves half a texture behind for the next run to load
+bool WriteCachedTexture(const std::filesystem::path& cachedTexturePath, const DirectX::ScratchImage& scratchImage)
+{
+    std::error_code errorCode;
+    std::filesystem::create_directories(cachedTexturePath.parent_path(), errorCode);
+
+    std::filesystem::path temporaryPath = cachedTexturePath;
+    temporaryPath += ".tmp";
+    if (FAILED(DirectX::SaveToDDSFile(
             scratchImage.GetImages(),
             scratchImage.GetImageCount(),
-            metaData,
-            &texture)))
+            scratchImage.GetMetadata(),
+            DirectX::DDS_FLAGS_NONE,
+            temporaryPath.wstring().c_str())))
+    {
+        return false;
+    }
+
+    std::filesystem::rename(temporaryPath, cachedTexturePath, errorCode);
+    if (errorCode)
+    {
+        std::filesystem::remove(temporaryPath, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+//FreeImage loads HDR and EXR images with 32 bit floats and 16 bit PNG and TIFF images with 16 bit integers per channel,
+//these keep their precision in half float, packed float and 16 bit normalized textures. Takes ownership of image
+WRL::ComPtr<ID3D11ShaderResourceView> CreateHighPrecisionTextureView(ID3D11Device* device, FIBITMAP* image, const std::wstring& pathToTexture)
+{
+    uint32_t channelCount = 0;
+    bool isFloat = false;
+    DXGI_FORMAT textureFormat = DXGI_FORMAT::DXGI_FORMAT_UNKNOWN;
+    switch (FreeImage_GetImageType(image))
     {
-        std::cerr << "DXTEX: Failed to create texture out of image\n";
-        scratchImage.Release();
+    case FIT_UINT16:
+        channelCount = 1;
+        textureFormat = DXGI_FORMAT::DXGI_FORMAT_R16_UNORM;
+        break;
+    case FIT_RGB16:
+        //There are no three channel 16 bit formats either, alpha is filled in as opaque
+        channelCount = 3;
+        textureFormat = DXGI_FORMAT::DXGI_FORMAT_R16G16B16A16_UNORM;
+        break;
+    case FIT_RGBA16:
+        channelCount = 4;
+        textureFormat = DXGI_FORMAT::DXGI_FORMAT_R16G16B16A16_UNORM;
+        break;
+    case FIT_FLOAT:
+        channelCount = 1;
+        isFloat = true;
+        textureFormat = DXGI_FORMAT::DXGI_FORMAT_R16_FLOAT;
+        break;
+    case FIT_RGBF:
+        //Without alpha the packed float format takes half the memory of half floats, environment maps are mostly these
+        channelCount = 3;
+        isFloat = true;
+        textureFormat = DXGI_FORMAT::DXGI_FORMAT_R11G11B10_FLOAT;
+        break;
+    case FIT_RGBAF:
+        channelCount = 4;
+        isFloat = true;
+        textureFormat = DXGI_FORMAT::DXGI_FORMAT_R16G16B16A16_FLOAT;
+        break;
+    default:
+        std::cerr << "CreateTextureView: Texture has an unsupported pixel type ( " << FreeImage_GetImageType(image) << " ), file: '" << pathToTexture.c_str() << "'\n";
+        FreeImage_Unload(image);
         return nullptr;
     }
 
-    ID3D11ShaderResourceView* srv = nullptr;
+    const uint32_t textureWidth = FreeImage_GetWidth(image);
+    const uint32_t textureHeight = FreeImage_GetHeight(image);
+    std::vector<float> pixels(static_cast<size_t>(textureWidth) * textureHeight * 4);
+    DecodeHighPrecisionPixels(
+        FreeImage_GetBits(image),
+        FreeImage_GetPitch(image),
+        channelCount,
+        isFloat,
+        textureWidth,
+        textureHeight,
+        pixels.data());
+    FreeImage_Unload(image);
 
-    if (FAILED(DirectX::CreateShaderResourceView(
-            device,
-            scratchImage.GetImages(),
-            scratchImage.GetImageCount(),
-            metaData,
-            &srv)))
+    //16 bit color images are sRGB encoded like their 8 bit counterparts, float images are linear already
+    std::vector<float> mipData;
+    std::vector<MipLevel> mipLevels;
+    GenerateMipChain(
+        pixels.data(),
+        textureWidth,
+        textureHeight,
+        !isFloat && channelCount >= 3,
+        isFloat,
+        MipFilter::Kaiser,
+        mipData,
+        mipLevels);
+
+    //The levels are packed straight into the scratch image, which is uploaded as is
+    DirectX::ScratchImage scratchImage;
+    if (FAILED(scratchImage.Initialize2D(textureFormat, textureWidth, textureHeight, 1, mipLevels.size() + 1)))
     {
-        std::cerr << "DXTEX: Failed to create shader resource view out of texture\n";
-        scratchImage.Release();
+        std::cerr << "CreateTextureView: Failed to allocate texture: " << pathToTexture.c_str() << "\n";
         return nullptr;
     }
 
-    return srv;
-}
+    PackFloatPixels(pixels.data(), pixels.size() / 4, textureFormat, scratchImage.GetImage(0, 0, 0)->pixels);
+    for (size_t i = 0; i < mipLevels.size(); i++)
+    {
+        PackFloatPixels(
+            mipData.data() + mipLevels[i].Offset,
+            static_cast<size_t>(mipLevels[i].Width) * mipLevels[i].Height,
+            textureFormat,
+            scratchImage.GetImage(i + 1, 0, 0)->pixels);
+    }
 
+    return CreateTextureViewFromImages(device, scratchImage);
+}
 
-WRL::ComPtr<ID3D11ShaderResourceView> CreateTextureView(ID3D11Device* device, const std::wstring& pathToTexture)
+WRL::ComPtr<ID3D11ShaderResourceView> CreateTextureView(ID3D11Device* device, const std::wstring& pathToTexture, TextureCompressionQuality quality, bool isPremultiplyingAlpha)
 {
     FIBITMAP* image = nullptr; 
+    std::filesystem::path cachedTexturePath;
     //Win32 methods of opening files is called "CreateFile" counterintuitively, we make sure to tell it to only to read pre-existing files
     HANDLE file = CreateFileW(pathToTexture.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, 0);
 
@@ -200,6 +336,18 @@ WRL::ComPtr<ID3D11ShaderResourceView> CreateTextureView(ID3D11Device* device, co
         //Close our file handle as we don't need it anymore
         CloseHandle(file);
 
+        //Once a texture has been compressed, later runs load the cached DDS and skip decoding and encoding entirely
+        cachedTexturePath = GetCachedTexturePath(fileDataRaw, quality, isPremultiplyingAlpha);
+        std::error_code errorCode;
+        if (std::filesystem::exists(cachedTexturePath, errorCode))
+        {
+            WRL::ComPtr<ID3D11ShaderResourceView> cachedSrv = CreateTextureViewFromDDS(device, cachedTexturePath.wstring());
+            if (cachedSrv != nullptr)
+            {
+                return cachedSrv;
+            }
+        }
+
         FIMEMORY* memHandle = FreeImage_OpenMemory(fileDataRaw.data(), static_cast<DWORD>(fileDataRaw.size()));
         FREE_IMAGE_FORMAT imageFormat = FreeImage_GetFileTypeFromMemory(memHandle);
         if (imageFormat == FIF_UNKNOWN)
@@ -215,15 +363,23 @@ WRL::ComPtr<ID3D11ShaderResourceView> CreateTextureView(ID3D11Device* device, co
 
     } //ending the local scope cleans up fileDataRaw
 
-    //Flip the image vertically so this matches up with what DirectXTex loads
-    FreeImage_FlipVertical(image);
+    if (image == nullptr)
+    {
+        std::cerr << "CreateTextureView: Failed to decode texture from file: '" << pathToTexture.c_str() << "'\n";
+        return nullptr;
+    }
+
+    //Anything with more than 8 bits per channel takes its own path, it is neither swizzled nor block compressed
+    if (FreeImage_GetImageType(image) != FIT_BITMAP)
+    {
+        return CreateHighPrecisionTextureView(device, image, pathToTexture);
+    }
 
     uint32_t textureWidth = FreeImage_GetWidth(image);
     uint32_t textureHeight = FreeImage_GetHeight(image);
     uint32_t textureBPP = FreeImage_GetBPP(image);
 
     D3D11_TEXTURE2D_DESC textureDesc = {};
-    D3D11_SUBRESOURCE_DATA initialData = {};
     WRL::ComPtr<ID3D11Texture2D> texture = nullptr;
 
     DXGI_FORMAT textureFormat;
@@ -236,15 +392,7 @@ WRL::ComPtr<ID3D11ShaderResourceView> CreateTextureView(ID3D11Device* device, co
         textureFormat = DXGI_FORMAT::DXGI_FORMAT_R8G8_UNORM;
         break;
     case 24:
-        //D3D11 does not support 24 bit formats for textures, we'll need to convert
-        {
-            textureBPP = 32;
-            FIBITMAP* newImage = FreeImage_ConvertTo32Bits(image);
-            FreeImage_Unload(image);
-            image = newImage;
-            textureFormat = DXGI_FORMAT::DXGI_FORMAT_R8G8B8A8_UNORM;
-        }
-        break;
+        //D3D11 does not support 24 bit formats for textures, ConvertPixels expands these to 32 bits below
     case 32:
         textureFormat = DXGI_FORMAT::DXGI_FORMAT_R8G8B8A8_UNORM;
         break;
@@ -252,29 +400,113 @@ WRL::ComPtr<ID3D11ShaderResourceView> CreateTextureView(ID3D11Device* device, co
         {
             //we could try to handle some weird bitcount, but these will probably be HDR or some antique format, just exit instead..
             std::cerr << "CreateTextureView: Texture has nontrivial bits per pixel ( " << textureBPP << " ), file: '" << pathToTexture.c_str() << "'\n";
+            FreeImage_Unload(image);
             return nullptr;
         }
         break;
     }
+    //FreeImage keeps its rows bottom up in BGR(A) order, we flip them to match what DirectXTex loads, expand RGB to RGBA
+    //and swizzle into a tightly packed buffer in a single pass, after which we no longer need the FreeImage bitmap
+    const uint32_t channelCount = GetConvertedChannelCount(textureBPP / 8);
+    const uint32_t texturePitch = textureWidth * channelCount;
+    std::vector<uint8_t> pixels(static_cast<size_t>(texturePitch) * textureHeight);
+    ConvertPixels(
+        FreeImage_GetBits(image),
+        FreeImage_GetPitch(image),
+        textureBPP / 8,
+        textureWidth,
+        textureHeight,
+        isPremultiplyingAlpha,
+        pixels.data(),
+        texturePitch);
+    FreeImage_Unload(image);
+
+    //Minified textures alias badly without mips, so we build the whole chain down to 1x1 on the CPU.
+    //Color images are stored in sRGB, they are filtered in linear space so the smaller levels keep their brightness
+    std::vector<uint8_t> mipData;
+    std::vector<MipLevel> mipLevels;
+    GenerateMipChain(
+        pixels.data(),
+        textureWidth,
+        textureHeight,
+        texturePitch,
+        channelCount,
+        textureBPP >= 24,
+        MipFilter::Kaiser,
+        mipData,
+        mipLevels);
+
     textureDesc.Format = textureFormat;
     textureDesc.ArraySize = 1;
-    textureDesc.MipLevels = 1;
+    textureDesc.MipLevels = static_cast<uint32_t>(mipLevels.size()) + 1;
     textureDesc.Height = textureHeight;
     textureDesc.Width = textureWidth;
     textureDesc.SampleDesc.Count = 1;
     textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
     textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 
-    //populate initial data
-    initialData.pSysMem = FreeImage_GetBits(image);
-    initialData.SysMemPitch = (textureBPP / 8) * textureWidth;
+    //D3D11 only takes block compressed textures whose first level is made of whole blocks
+    if (textureWidth % 4 == 0 && textureHeight % 4 == 0)
+    {
+        //Images that only got their alpha from ConvertPixels are opaque and pass this quickly
+        bool hasAlpha = false;
+        for (uint32_t y = 0; y < textureHeight && channelCount == 4 && !hasAlpha; y++)
+        {
+            const uint8_t* row = pixels.data() + y * texturePitch;
+            for (uint32_t x = 0; x < textureWidth && !hasAlpha; x++)
+            {
+                hasAlpha = row[x * 4 + 3] != 255;
+            }
+        }
+
+        DirectX::ScratchImage uncompressedImage;
+        if (SUCCEEDED(uncompressedImage.Initialize2D(textureFormat, textureWidth, textureHeight, 1, textureDesc.MipLevels)))
+        {
+            const DirectX::Image& firstLevel = *uncompressedImage.GetImage(0, 0, 0);
+            for (uint32_t y = 0; y < textureHeight; y++)
+            {
+                memcpy(firstLevel.pixels + y * firstLevel.rowPitch, pixels.data() + y * texturePitch, texturePitch);
+            }
+
+            for (size_t i = 0; i < mipLevels.size(); i++)
+            {
+                const DirectX::Image& level = *uncompressedImage.GetImage(i + 1, 0, 0);
+                for (uint32_t y = 0; y < mipLevels[i].Height; y++)
+                {
+                    memcpy(level.pixels + y * level.rowPitch, mipData.data() + mipLevels[i].Offset + y * mipLevels[i].RowPitch, mipLevels[i].RowPitch);
+                }
+            }
+
+            DirectX::ScratchImage compressedImage;
+            const DXGI_FORMAT compressedFormat = SelectCompressedFormat(channelCount, hasAlpha, quality);
+            if (CompressTexture(uncompressedImage, compressedFormat, quality, compressedImage))
+            {
+                if (!WriteCachedTexture(cachedTexturePath, compressedImage))
+                {
+                    std::cerr << "CreateTextureView: Failed to write " << cachedTexturePath.u8string() << "\n";
+                }
+
+                return CreateTextureViewFromImages(device, compressedImage);
+            }
+        }
+
+        std::cerr << "CreateTextureView: Failed to compress texture, uploading it uncompressed: " << pathToTexture.c_str() << "\n";
+    }
 
-    if (FAILED(device->CreateTexture2D(&textureDesc, &initialData, texture.GetAddressOf())))
+    //populate initial data, the first level is the image itself
+    std::vector<D3D11_SUBRESOURCE_DATA> initialData(textureDesc.MipLevels);
+    initialData[0].pSysMem = pixels.data();
+    initialData[0].SysMemPitch = texturePitch;
+    for (size_t i = 0; i < mipLevels.size(); i++)
+    {
+        initialData[i + 1].pSysMem = mipData.data() + mipLevels[i].Offset;
+        initialData[i + 1].SysMemPitch = mipLevels[i].RowPitch;
+    }
+
+    if (FAILED(device->CreateTexture2D(&textureDesc, initialData.data(), texture.GetAddressOf())))
     {
-        FreeImage_Unload(image);
         return nullptr;
     }
-    FreeImage_Unload(image);
 
     ID3D11ShaderResourceView* srv = nullptr;
     D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
@@ -321,7 +553,7 @@ bool TexturingApplication::Load()
         return false;
     }
 
-    _fallbackTextureSrv = CreateTextureView(_device.Get(), L"Assets/Textures/default.png");
+    _fallbackTextureSrv = CreateTextureView(_device.Get(), L"Assets/Textures/default.png", TextureCompressionQuality::Balanced, false);
     assert(_fallbackTextureSrv != nullptr); //as a fallback resource, this "needs" to exist
 
     _textureSrv = CreateTextureViewFromDDS(_device.Get(), L"Assets/Textures/T_Froge.dds");
@@ -332,7 +564,7 @@ bool TexturingApplication::Load()
     }
 
     D3D11_SAMPLER_DESC linearSamplerStateDescriptor = {};
-    linearSamplerStateDescriptor.Filter = D3D11_FILTER::D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT;
+    linearSamplerStateDescriptor.Filter = D3D11_FILTER::D3D11_FILTER_MIN_MAG_MIP_LINEAR;
     linearSamplerStateDescriptor.AddressU = D3D11_TEXTURE_ADDRESS_MODE::D3D11_TEXTURE_ADDRESS_WRAP;
     linearSamplerStateDescriptor.AddressV = D3D11_TEXTURE_ADDRESS_MODE::D3D11_TEXTURE_ADDRESS_WRAP;
     linearSamplerStateDescriptor.AddressW = D3D11_TEXTURE_ADDRESS_MODE::D3D11_TEXTURE_ADDRESS_WRAP;
@@ -66,6 +66,9 @@ std::unordered_map<VertexType, std::vector<D3D11_INPUT_ELEMENT_DESC>> ShaderColl
     }
     // clang-format on
 };
+
+ShaderCache ShaderCollection::_shaderCache{ "ShaderCache" };
+
 ShaderCollection ShaderCollection::CreateShaderCollection(const ShaderCollectionDescriptor& settings, ID3D11Device* device)
 {
     ShaderCollection collection;
@@ -154,31 +157,7 @@ bool ShaderCollection::CreateInputLayout(ID3D11Device* device, const VertexType
 bool ShaderCollection::CompileShader(const std::wstring& filePath, const std::string& entryPoint, const std::string& profile, WRL::ComPtr<ID3DBlob>& shaderBlob)
 {
     constexpr uint32_t compileFlags = D3DCOMPILE_ENABLE_STRICTNESS;
-
-    WRL::ComPtr<ID3DBlob> tempShaderBlob = nullptr;
-    WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
-    if (FAILED(D3DCompileFromFile(
-        filePath.data(),
-        nullptr,
-        D3D_COMPILE_STANDARD_FILE_INCLUDE,
-        entryPoint.data(),
-        profile.data(),
-        compileFlags,
-        0,
-        &tempShaderBlob,
-        &errorBlob)))
-    {
-        std::cerr << "D3D11: Failed to read shader from file\n";
-        if (errorBlob != nullptr)
-        {
-            std::cerr << "D3D11: With message: " << static_cast<const char*>(errorBlob->GetBufferPointer()) << "\n";
-        }
-
-        return false;
-    }
-
-    shaderBlob = tempShaderBlob;
-    return true;
+    return _shaderCache.CompileShader(filePath, entryPoint, profile, compileFlags, shaderBlob);
 }
 
 void ShaderCollection::ApplyToContext(ID3D11DeviceContext* context)
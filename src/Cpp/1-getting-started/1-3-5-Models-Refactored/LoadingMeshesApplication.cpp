@@ -158,6 +158,7 @@ bool LoadingMeshesApplication::Load()
         std::cout << "PipelineFactory: Failed to create pipeline\n";
         return false;
     }
+    _pipelineFactory->GetShaderCache().PrintStatistics();
 
     _pipeline->SetViewport(
         0.0f,
@@ -99,43 +99,24 @@ bool PipelineFactory::CreatePipeline(
     return true;
 }
 
+const ShaderCache& PipelineFactory::GetShaderCache() const
+{
+    return _shaderCache;
+}
+
 bool PipelineFactory::CompileShader(
     const std::wstring& filePath,
     const std::string& entryPoint,
     const std::string& profile,
-    WRL::ComPtr<ID3DBlob>& shaderBlob) const
+    WRL::ComPtr<ID3DBlob>& shaderBlob)
 {
     constexpr uint32_t compileFlags = D3DCOMPILE_ENABLE_STRICTNESS;
-
-    WRL::ComPtr<ID3DBlob> tempShaderBlob = nullptr;
-    WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
-    if (FAILED(D3DCompileFromFile(
-            filePath.data(),
-            nullptr,
-            D3D_COMPILE_STANDARD_FILE_INCLUDE,
-            entryPoint.data(),
-            profile.data(),
-            compileFlags,
-            0,
-            &tempShaderBlob,
-            &errorBlob)))
-    {
-        std::cout << "D3D11: Failed to read shader from file\n";
-        if (errorBlob != nullptr)
-        {
-            std::cout << "D3D11: With message: " << static_cast<const char*>(errorBlob->GetBufferPointer()) << "\n";
-        }
-
-        return false;
-    }
-
-    shaderBlob = std::move(tempShaderBlob);
-    return true;
+    return _shaderCache.CompileShader(filePath, entryPoint, profile, compileFlags, shaderBlob);
 }
 
 WRL::ComPtr<ID3D11VertexShader> PipelineFactory::CreateVertexShader(
     const std::wstring& filePath,
-    WRL::ComPtr<ID3DBlob>& vertexShaderBlob) const
+    WRL::ComPtr<ID3DBlob>& vertexShaderBlob)
 {
     if (!CompileShader(filePath, "Main", "vs_5_0", vertexShaderBlob))
     {
@@ -156,7 +137,7 @@ WRL::ComPtr<ID3D11VertexShader> PipelineFactory::CreateVertexShader(
     return vertexShader;
 }
 
-WRL::ComPtr<ID3D11PixelShader> PipelineFactory::CreatePixelShader(const std::wstring& filePath) const
+WRL::ComPtr<ID3D11PixelShader> PipelineFactory::CreatePixelShader(const std::wstring& filePath)
 {
     WRL::ComPtr<ID3DBlob> pixelShaderBlob = nullptr;
     if (!CompileShader(filePath, "Main", "ps_5_0", pixelShaderBlob))
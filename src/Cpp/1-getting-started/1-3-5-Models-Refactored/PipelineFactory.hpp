@@ -4,6 +4,8 @@
 #include "Pipeline.hpp"
 #include "VertexType.hpp"
 
+#include <ShaderCache.hpp>
+
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -24,13 +26,15 @@ public:
         const PipelineDescriptor& settings,
         std::unique_ptr<Pipeline>& pipeline);
 
+    [[nodiscard]] const ShaderCache& GetShaderCache() const;
+
 private:
     static size_t GetLayoutByteSize(VertexType vertexType);
 
     [[nodiscard]] WRL::ComPtr<ID3D11VertexShader> CreateVertexShader(
         const std::wstring& filePath,
-        WRL::ComPtr<ID3DBlob>& vertexShaderBlob) const;
-    [[nodiscard]] WRL::ComPtr<ID3D11PixelShader> CreatePixelShader(const std::wstring& filePath) const;
+        WRL::ComPtr<ID3DBlob>& vertexShaderBlob);
+    [[nodiscard]] WRL::ComPtr<ID3D11PixelShader> CreatePixelShader(const std::wstring& filePath);
 
     bool CreateInputLayout(
         VertexType layoutInfo,
@@ -41,8 +45,9 @@ private:
         const std::wstring& filePath,
         const std::string& entryPoint,
         const std::string& profile,
-        WRL::ComPtr<ID3DBlob>& shaderBlob) const;
+        WRL::ComPtr<ID3DBlob>& shaderBlob);
 
     WRL::ComPtr<ID3D11Device> _device = nullptr;
     std::unordered_map<VertexType, std::vector<D3D11_INPUT_ELEMENT_DESC>> _layoutMap;
+    ShaderCache _shaderCache{ "ShaderCache" };
 };
@@ -2,6 +2,7 @@
 
 #include "VertexType.hpp"
 #include "Definitions.hpp"
+#include <ShaderCache.hpp>
 #include <d3d11_2.h>
 #include <cstdint>
 #include <string>
@@ -54,4 +55,5 @@ private:
     D3D11_PRIMITIVE_TOPOLOGY _primitiveTopology = {};
     uint32_t _vertexSize = 0;
     static std::unordered_map<VertexType, std::vector<D3D11_INPUT_ELEMENT_DESC>> _layoutMap;
+    static ShaderCache _shaderCache;
 };
@@ -41,11 +41,30 @@ bool TextureFactory::CreateShaderResourceViewFromFile(
         return false;
     }
 
-    if (FAILED(DirectX::CreateShaderResourceView(
-            _device.Get(),
-            scratchImage.GetImages(),
-            scratchImage.GetImageCount(),
-            metaData,
+    // The view is made of the texture created above, DirectX::CreateShaderResourceView would create
+    // and upload a second copy of it
+    D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDescriptor = {};
+    shaderResourceViewDescriptor.Format = metaData.format;
+    if (metaData.IsCubemap())
+    {
+        shaderResourceViewDescriptor.ViewDimension = D3D11_SRV_DIMENSION::D3D11_SRV_DIMENSION_TEXTURECUBE;
+        shaderResourceViewDescriptor.TextureCube.MipLevels = static_cast<uint32_t>(metaData.mipLevels);
+    }
+    else if (metaData.arraySize > 1)
+    {
+        shaderResourceViewDescriptor.ViewDimension = D3D11_SRV_DIMENSION::D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+        shaderResourceViewDescriptor.Texture2DArray.MipLevels = static_cast<uint32_t>(metaData.mipLevels);
+        shaderResourceViewDescriptor.Texture2DArray.ArraySize = static_cast<uint32_t>(metaData.arraySize);
+    }
+    else
+    {
+        shaderResourceViewDescriptor.ViewDimension = D3D11_SRV_DIMENSION::D3D11_SRV_DIMENSION_TEXTURE2D;
+        shaderResourceViewDescriptor.Texture2D.MipLevels = static_cast<uint32_t>(metaData.mipLevels);
+    }
+
+    if (FAILED(_device->CreateShaderResourceView(
+            texture.Get(),
+            &shaderResourceViewDescriptor,
             &shaderResourceView)))
     {
         std::cerr << "DXTEX: Failed to create shader resource view out of texture\n";
@@ -21,6 +21,11 @@ bool ApplicationWithInput::Initialize()
         return false;
     }
 
+    if (IsHeadless())
+    {
+        return true;
+    }
+
     glfwSetKeyCallback(GetWindow(), HandleKeyboard);
     glfwSetMouseButtonCallback(GetWindow(), HandleMouseButton);
     glfwSetCursorPosCallback(GetWindow(), HandleMouseMovement);
@@ -44,9 +49,12 @@ void ApplicationWithInput::OnKey(
 
 void ApplicationWithInput::Cleanup()
 {
-    glfwSetCursorPosCallback(GetWindow(), nullptr);
-    glfwSetMouseButtonCallback(GetWindow(), nullptr);
-    glfwSetKeyCallback(GetWindow(), nullptr);
+    if (!IsHeadless())
+    {
+        glfwSetCursorPosCallback(GetWindow(), nullptr);
+        glfwSetMouseButtonCallback(GetWindow(), nullptr);
+        glfwSetKeyCallback(GetWindow(), nullptr);
+    }
 
     Application::Cleanup();
 }
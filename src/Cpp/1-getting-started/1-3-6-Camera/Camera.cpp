@@ -1,5 +1,7 @@
 #include "Camera.hpp"
 
+#include <cmath>
+
 Camera::Camera(
     const float nearPlane,
     const float farPlane)
@@ -23,6 +25,11 @@ CameraConstants& Camera::GetCameraConstants()
     return _cameraConstants;
 }
 
+const DirectX::XMFLOAT3& Camera::GetPosition() const
+{
+    return _position;
+}
+
 void Camera::Update()
 {
     UpdateVectors();
@@ -153,6 +160,14 @@ void PerspectiveCamera::Resize(
     UpdateProjectionMatrix();
 }
 
+float PerspectiveCamera::GetProjectedSize(
+    const float size,
+    const float distance) const
+{
+    // The viewport's height spans 2 * tan(fov / 2) * distance at that distance
+    return size * _height / (2.0f * std::tan(_fieldOfViewInRadians * 0.5f) * distance);
+}
+
 void PerspectiveCamera::UpdateProjectionMatrix()
 {
     DirectX::XMMATRIX projectionMatrix = DirectX::XMMatrixPerspectiveFovRH(
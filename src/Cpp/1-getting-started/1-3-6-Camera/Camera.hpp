@@ -32,6 +32,7 @@ public:
     [[nodiscard]] DirectX::XMFLOAT4X4 GetViewMatrix();
     [[nodiscard]] DirectX::XMFLOAT4X4 GetProjectionMatrix();
     [[nodiscard]] CameraConstants& GetCameraConstants();
+    [[nodiscard]] const DirectX::XMFLOAT3& GetPosition() const;
 
 protected:
     Camera(
@@ -73,6 +74,11 @@ public:
         int32_t width,
         int32_t height) override;
 
+    // How many pixels a length in world space covers when seen from the given distance
+    [[nodiscard]] float GetProjectedSize(
+        float size,
+        float distance) const;
+
 protected:
     void UpdateProjectionMatrix() override;
 
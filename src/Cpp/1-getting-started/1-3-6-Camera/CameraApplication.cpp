@@ -1,35 +1,28 @@
 #include "CameraApplication.hpp"
 #include "Camera.hpp"
 #include "DeviceContext.hpp"
+#include "GeometryPool.hpp"
+#include "LodSelector.hpp"
+#include "MeshletCuller.hpp"
 #include "ModelFactory.hpp"
+#include "NullRenderBackend.hpp"
 #include "Pipeline.hpp"
 #include "PipelineFactory.hpp"
 #include "TextureFactory.hpp"
+#include "TextureStreamer.hpp"
 
 #include <GLFW/glfw3.h>
+#if defined(_WIN32)
+#include "D3D11RenderBackend.hpp"
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
+#endif
 
-#include <d3dcompiler.h>
-
-#include <imgui/backend/imgui_impl_dx11.h>
 #include <imgui/backend/imgui_impl_glfw.h>
 #include <imgui/imgui.h>
 
 #include <iostream>
 
-#pragma comment(lib, "d3d11.lib")
-#pragma comment(lib, "dxgi.lib")
-#pragma comment(lib, "d3dcompiler.lib")
-#pragma comment(lib, "winmm.lib")
-#pragma comment(lib, "dxguid.lib")
-
-template <UINT TDebugNameLength>
-inline void SetDebugName(_In_ ID3D11DeviceChild* deviceResource, _In_z_ const char (&debugName)[TDebugNameLength])
-{
-    deviceResource->SetPrivateData(WKPDID_D3DDebugObjectName, TDebugNameLength - 1, debugName);
-}
-
 CameraApplication::CameraApplication(const std::string& title)
     : ApplicationWithInput(title)
 {
@@ -37,45 +30,64 @@ CameraApplication::CameraApplication(const std::string& title)
 
 CameraApplication::~CameraApplication()
 {
-    _deviceContext->Flush();
-    _depthDisabledDepthStencilState.Reset();
-    _depthEnabledLessDepthStencilState.Reset();
-    _depthEnabledLessEqualDepthStencilState.Reset();
-    _depthEnabledAlwaysDepthStencilState.Reset();
-    _depthEnabledNeverDepthStencilState.Reset();
-    _depthEnabledEqualDepthStencilState.Reset();
-    _depthEnabledNotEqualDepthStencilState.Reset();
-    _depthEnabledGreaterDepthStencilState.Reset();
-    _depthEnabledGreaterEqualDepthStencilState.Reset();
-
-    _wireFrameCullBackRasterizerState.Reset();
-    _wireFrameCullFrontRasterizerState.Reset();
-    _wireFrameCullNoneRasterizerState.Reset();
-
-    _solidFrameCullBackRasterizerState.Reset();
-    _solidFrameCullFrontRasterizerState.Reset();
-    _solidFrameCullNoneRasterizerState.Reset();
-
-    _depthStencilView.Reset();
-    _cameraConstantBuffer.Reset();
-    _textureSrv.Reset();
+    // Nothing was created when initializing failed
+    if (_deviceContext != nullptr)
+    {
+        _deviceContext->Flush();
+    }
+
+    if (_nullRenderBackend != nullptr && _deviceContext != nullptr)
+    {
+        const DeviceContextStatistics& frameStatistics = _deviceContext->GetFrameStatistics();
+        std::cout << "DeviceContext: " << frameStatistics.IssuedStateCalls << " state calls issued, "
+                  << frameStatistics.SkippedStateCalls << " skipped in the last frame\n";
+        _nullRenderBackend->PrintStatistics();
+    }
+
+    _depthDisabledDepthStencilState.reset();
+    _depthEnabledLessDepthStencilState.reset();
+    _depthEnabledLessEqualDepthStencilState.reset();
+    _depthEnabledAlwaysDepthStencilState.reset();
+    _depthEnabledNeverDepthStencilState.reset();
+    _depthEnabledEqualDepthStencilState.reset();
+    _depthEnabledNotEqualDepthStencilState.reset();
+    _depthEnabledGreaterDepthStencilState.reset();
+    _depthEnabledGreaterEqualDepthStencilState.reset();
+
+    _wireFrameCullBackRasterizerState.reset();
+    _wireFrameCullFrontRasterizerState.reset();
+    _wireFrameCullNoneRasterizerState.reset();
+
+    _solidFrameCullBackRasterizerState.reset();
+    _solidFrameCullFrontRasterizerState.reset();
+    _solidFrameCullNoneRasterizerState.reset();
+
+    _linearSamplerState.reset();
+    _cameraConstantBuffer.reset();
+    _objectConstantBuffer.reset();
+    _textureSrv.reset();
+    _textureStreamer.reset();
     _pipeline.reset();
     _pipelineFactory.reset();
-    _modelVertices.Reset();
-    _modelIndices.Reset();
+    _meshletCuller.reset();
+    if (_geometryPool != nullptr)
+    {
+        _geometryPool->Free(_model.Geometry);
+    }
+    _model = {};
     _modelFactory.reset();
-    DestroySwapchainResources();
-    _swapChain.Reset();
-    _dxgiFactory.Reset();
+    _geometryPool.reset();
+    _textureFactory.reset();
+    // The D3D11 backend shuts its ImGui renderer down and reports leaked objects once the last of them is gone
     _deviceContext.reset();
-#if !defined(NDEBUG)
-    _debug->ReportLiveDeviceObjects(D3D11_RLDO_FLAGS::D3D11_RLDO_DETAIL);
-    _debug.Reset();
-#endif
-    _device.Reset();
+    _nullRenderBackend.reset();
+    _renderBackend.reset();
 
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext(_imGuiContext);
+    if (_imGuiContext != nullptr)
+    {
+        ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext(_imGuiContext);
+    }
 
     ApplicationWithInput::Cleanup();
 }
@@ -88,82 +100,39 @@ bool CameraApplication::Initialize()
         return false;
     }
 
-    // This section initializes DirectX's devices and SwapChain
-    if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&_dxgiFactory))))
+    if (IsHeadless())
     {
-        std::cout << "DXGI: Failed to create factory\n";
-        return false;
-    }
-
-    constexpr D3D_FEATURE_LEVEL deviceFeatureLevel = D3D_FEATURE_LEVEL::D3D_FEATURE_LEVEL_11_0;
-    uint32_t deviceFlags = 0;
-#if !defined(NDEBUG)
-    deviceFlags |= D3D11_CREATE_DEVICE_FLAG::D3D11_CREATE_DEVICE_DEBUG;
-#endif
-
-    WRL::ComPtr<ID3D11DeviceContext> deviceContext = nullptr;
-    if (FAILED(D3D11CreateDevice(
-            nullptr,
-            D3D_DRIVER_TYPE::D3D_DRIVER_TYPE_HARDWARE,
-            nullptr,
-            deviceFlags,
-            &deviceFeatureLevel,
-            1,
-            D3D11_SDK_VERSION,
-            &_device,
-            nullptr,
-            &deviceContext)))
-    {
-        std::cout << "D3D11: Failed to create Device and Device Context\n";
-        return false;
+        // Without a window there is nothing to present to, everything is recorded by the null backend instead
+        _nullRenderBackend = std::make_shared<NullRenderBackend>();
+        _renderBackend = _nullRenderBackend;
     }
-
-    if (FAILED(_device.As(&_debug)))
+    else
     {
-        std::cout << "D3D11: Failed to get the debug layer from the device\n";
-        return false;
-    }
-
-    InitializeImGui();
-
-    constexpr char deviceName[] = "DEV_Main";
-    _device->SetPrivateData(WKPDID_D3DDebugObjectName, sizeof(deviceName), deviceName);
-    SetDebugName(deviceContext.Get(), "CTX_Main");
-
-    _deviceContext = std::make_unique<DeviceContext>(_device, std::move(deviceContext));
-
-    DXGI_SWAP_CHAIN_DESC1 swapChainDescriptor = {};
-    swapChainDescriptor.Width = GetWindowWidth();
-    swapChainDescriptor.Height = GetWindowHeight();
-    swapChainDescriptor.Format = DXGI_FORMAT::DXGI_FORMAT_B8G8R8A8_UNORM;
-    swapChainDescriptor.SampleDesc.Count = 1;
-    swapChainDescriptor.SampleDesc.Quality = 0;
-    swapChainDescriptor.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    swapChainDescriptor.BufferCount = 2;
-    swapChainDescriptor.SwapEffect = DXGI_SWAP_EFFECT::DXGI_SWAP_EFFECT_FLIP_DISCARD;
-    swapChainDescriptor.Scaling = DXGI_SCALING::DXGI_SCALING_STRETCH;
-    swapChainDescriptor.Flags = {};
-
-    DXGI_SWAP_CHAIN_FULLSCREEN_DESC swapChainFullscreenDescriptor = {};
-    swapChainFullscreenDescriptor.Windowed = true;
+#if defined(_WIN32)
+        InitializeImGui();
+        const std::shared_ptr<D3D11RenderBackend> d3d11RenderBackend = std::make_shared<D3D11RenderBackend>();
+        if (!d3d11RenderBackend->Initialize(
+                glfwGetWin32Window(GetWindow()),
+                GetWindowWidth(),
+                GetWindowHeight()))
+        {
+            return false;
+        }
 
-    if (FAILED(_dxgiFactory->CreateSwapChainForHwnd(
-            _device.Get(),
-            glfwGetWin32Window(GetWindow()),
-            &swapChainDescriptor,
-            &swapChainFullscreenDescriptor,
-            nullptr,
-            &_swapChain)))
-    {
-        std::cout << "DXGI: Failed to create SwapChain\n";
+        _renderBackend = d3d11RenderBackend;
+#else
+        std::cout << "CameraApplication: Only headless runs are supported without D3D11\n";
         return false;
+#endif
     }
 
-    CreateSwapchainResources();
-
-    _pipelineFactory = std::make_unique<PipelineFactory>(_device);
-    _textureFactory = std::make_unique<TextureFactory>(_device);
-    _modelFactory = std::make_unique<ModelFactory>(_device);
+    _deviceContext = std::make_unique<DeviceContext>(_renderBackend);
+    _pipelineFactory = std::make_unique<PipelineFactory>(_renderBackend);
+    _textureFactory = std::make_unique<TextureFactory>(_renderBackend);
+    _textureStreamer = std::make_unique<TextureStreamer>(_renderBackend, 256ull << 20, 64, 2);
+    _geometryPool = std::make_shared<GeometryPool>(_renderBackend, 1 << 18, 1 << 20);
+    _modelFactory = std::make_unique<ModelFactory>(_geometryPool);
+    _meshletCuller = std::make_unique<MeshletCuller>(_renderBackend);
     _camera = std::make_unique<PerspectiveCamera>(60.0f, GetWindowWidth(), GetWindowHeight(), 0.1f, 2048.0f);
 
     return true;
@@ -171,15 +140,36 @@ bool CameraApplication::Initialize()
 
 bool CameraApplication::Load()
 {
+    // The model decides the vertex format, so it is loaded before the pipeline reading it
+    if (!_modelFactory->LoadModel(
+            "Assets/Models/SM_Deccer_Cubes_Merged_Texture_Atlas.fbx",
+            ModelProcessingFlags::ModelProcessingWeldVertices |
+                ModelProcessingFlags::ModelProcessingOptimizeMeshes |
+                ModelProcessingFlags::ModelProcessingQuantizeVertices |
+                ModelProcessingFlags::ModelProcessingBuildMeshlets |
+                ModelProcessingFlags::ModelProcessingGenerateLods |
+                ModelProcessingFlags::ModelProcessingBuildTextureAtlas,
+            _model))
+    {
+        return false;
+    }
+
+    if (!_meshletCuller->Initialize(_model))
+    {
+        return false;
+    }
+
     PipelineDescriptor pipelineDescriptor = {};
     pipelineDescriptor.VertexFilePath = L"Assets/Shaders/Main.vs.hlsl";
     pipelineDescriptor.PixelFilePath = L"Assets/Shaders/Main.ps.hlsl";
-    pipelineDescriptor.VertexType = VertexType::PositionColorUv;
+    pipelineDescriptor.VertexType = _model.VertexType;
     if (!_pipelineFactory->CreatePipeline(pipelineDescriptor, _pipeline))
     {
         std::cout << "PipelineFactory: Failed to create pipeline\n";
         return false;
     }
+    _renderBackend->PrintShaderStatistics();
+    _geometryPool->PrintStatistics();
 
     _pipeline->SetViewport(
         0.0f,
@@ -187,60 +177,61 @@ bool CameraApplication::Load()
         static_cast<float>(GetWindowWidth()),
         static_cast<float>(GetWindowHeight()));
 
-    if (!_textureFactory->CreateShaderResourceViewFromFile(L"Assets/Textures/T_Atlas.dds", _textureSrv))
+    // Only the mip tail is uploaded here, the larger levels stream in once the model is on screen.
+    // Files which have to be converted can not be streamed, those are loaded whole instead.
+    // Models whose textures could not be packed keep their uvs, which point into the hand made atlas
+    const std::wstring atlasFilePath = _model.TextureAtlasFilePath.empty()
+                                           ? std::wstring(L"Assets/Textures/T_Atlas.dds")
+                                           : _model.TextureAtlasFilePath.wstring();
+    if (!_textureStreamer->CreateTexture(atlasFilePath, _atlasTexture))
     {
-        return false;
+        if (!_textureFactory->CreateShaderResourceViewFromFile(atlasFilePath, _textureSrv))
+        {
+            return false;
+        }
+        _textureFactory->PrintStatistics();
     }
+    _textureStreamer->PrintStatistics();
 
-    _pipeline->BindTexture(0, _textureSrv.Get());
+    _pipeline->BindTexture(0, _textureSrv);
 
-    D3D11_SAMPLER_DESC linearSamplerStateDescriptor = {};
-    linearSamplerStateDescriptor.Filter = D3D11_FILTER::D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT;
-    linearSamplerStateDescriptor.AddressU = D3D11_TEXTURE_ADDRESS_MODE::D3D11_TEXTURE_ADDRESS_WRAP;
-    linearSamplerStateDescriptor.AddressV = D3D11_TEXTURE_ADDRESS_MODE::D3D11_TEXTURE_ADDRESS_WRAP;
-    linearSamplerStateDescriptor.AddressW = D3D11_TEXTURE_ADDRESS_MODE::D3D11_TEXTURE_ADDRESS_WRAP;
-    if (FAILED(_device->CreateSamplerState(&linearSamplerStateDescriptor, &_linearSamplerState)))
+    RenderSamplerDescription linearSamplerStateDescription = {};
+    linearSamplerStateDescription.Filter = RenderFilter::MinMagLinearMipPoint;
+    linearSamplerStateDescription.AddressU = RenderTextureAddressMode::Wrap;
+    linearSamplerStateDescription.AddressV = RenderTextureAddressMode::Wrap;
+    linearSamplerStateDescription.AddressW = RenderTextureAddressMode::Wrap;
+    if (!_renderBackend->CreateSamplerState(linearSamplerStateDescription, _linearSamplerState))
     {
-        std::cout << "D3D11: Failed to create linear sampler state\n";
+        std::cout << "CameraApplication: Failed to create linear sampler state\n";
         return false;
     }
 
-    _pipeline->BindSampler(0, _linearSamplerState.Get());
-
-    if (!_modelFactory->LoadModel(
-            "Assets/Models/SM_Deccer_Cubes_Merged_Texture_Atlas.fbx",
-            _modelVertices,
-            &_modelVertexCount,
-            _modelIndices,
-            &_modelIndexCount))
-    {
-        return false;
-    }
+    _pipeline->BindSampler(0, _linearSamplerState);
 
-    const D3D11_BUFFER_DESC cameraConstantBufferDescriptor = CD3D11_BUFFER_DESC(
-        sizeof(CameraConstants),
-        D3D11_BIND_FLAG::D3D11_BIND_CONSTANT_BUFFER);
+    RenderBufferDescription cameraConstantBufferDescription = {};
+    cameraConstantBufferDescription.Size = sizeof(CameraConstants);
+    cameraConstantBufferDescription.BindFlags = RenderBindFlags::RenderBindConstantBuffer;
 
-    if (FAILED(_device->CreateBuffer(&cameraConstantBufferDescriptor, nullptr, &_cameraConstantBuffer)))
+    if (!_renderBackend->CreateBuffer(cameraConstantBufferDescription, nullptr, _cameraConstantBuffer))
     {
-        std::cout << "D3D11: Failed to create CameraConstants buffer\n";
+        std::cout << "CameraApplication: Failed to create CameraConstants buffer\n";
         return false;
     }
-    SetDebugName(_cameraConstantBuffer.Get(), "CB_Camera");
+    _cameraConstantBuffer->SetDebugName("CB_Camera");
 
-    const D3D11_BUFFER_DESC objectConstantBufferDescriptor = CD3D11_BUFFER_DESC(
-        sizeof(DirectX::XMMATRIX),
-        D3D11_BIND_FLAG::D3D11_BIND_CONSTANT_BUFFER);
+    RenderBufferDescription objectConstantBufferDescription = {};
+    objectConstantBufferDescription.Size = sizeof(DirectX::XMMATRIX);
+    objectConstantBufferDescription.BindFlags = RenderBindFlags::RenderBindConstantBuffer;
 
-    if (FAILED(_device->CreateBuffer(&objectConstantBufferDescriptor, nullptr, &_objectConstantBuffer)))
+    if (!_renderBackend->CreateBuffer(objectConstantBufferDescription, nullptr, _objectConstantBuffer))
     {
-        std::cout << "D3D11: Failed to create ObjectConstants buffer\n";
+        std::cout << "CameraApplication: Failed to create ObjectConstants buffer\n";
         return false;
     }
-    SetDebugName(_objectConstantBuffer.Get(), "CB_Object");
+    _objectConstantBuffer->SetDebugName("CB_Object");
 
-    _pipeline->BindVertexStageConstantBuffer(0, _cameraConstantBuffer.Get());
-    _pipeline->BindVertexStageConstantBuffer(1, _objectConstantBuffer.Get());
+    _pipeline->BindVertexStageConstantBuffer(0, _cameraConstantBuffer);
+    _pipeline->BindVertexStageConstantBuffer(1, _objectConstantBuffer);
 
     if (!CreateDepthStencilStates())
     {
@@ -252,6 +243,9 @@ bool CameraApplication::Load()
         return false;
     }
 
+    _pipeline->SetDepthStencilState(_depthEnabledLessDepthStencilState);
+    _pipeline->SetRasterizerState(_solidFrameCullBackRasterizerState);
+
     _camera->SetPosition(DirectX::XMFLOAT3{ 0.0f, 50.0f, 400.0f });
     _camera->SetDirection(DirectX::XMFLOAT3{ 0.0f, 0.0f, 1.0f });
     _camera->SetUp(DirectX::XMFLOAT3{ 0.0f, 1.0f, 0.0f });
@@ -259,66 +253,6 @@ bool CameraApplication::Load()
     return true;
 }
 
-bool CameraApplication::CreateSwapchainResources()
-{
-    WRL::ComPtr<ID3D11Texture2D> backBuffer = nullptr;
-    if (FAILED(_swapChain->GetBuffer(
-            0,
-            IID_PPV_ARGS(&backBuffer))))
-    {
-        std::cout << "D3D11: Failed to get back buffer from swapchain\n";
-        return false;
-    }
-
-    if (FAILED(_device->CreateRenderTargetView(
-            backBuffer.Get(),
-            nullptr,
-            &_renderTarget)))
-    {
-        std::cout << "D3D11: Failed to create rendertarget view from back buffer\n";
-        return false;
-    }
-
-    WRL::ComPtr<ID3D11Texture2D> depthBuffer = nullptr;
-
-    D3D11_TEXTURE2D_DESC depthStencilBufferDescriptor = {};
-    depthStencilBufferDescriptor.ArraySize = 1;
-    depthStencilBufferDescriptor.BindFlags = D3D11_BIND_FLAG::D3D11_BIND_DEPTH_STENCIL;
-    depthStencilBufferDescriptor.CPUAccessFlags = 0;
-    depthStencilBufferDescriptor.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-    depthStencilBufferDescriptor.Width = GetWindowWidth();
-    depthStencilBufferDescriptor.Height = GetWindowHeight();
-    depthStencilBufferDescriptor.MipLevels = 1;
-    depthStencilBufferDescriptor.SampleDesc.Count = 1;
-    depthStencilBufferDescriptor.SampleDesc.Quality = 0;
-    depthStencilBufferDescriptor.Usage = D3D11_USAGE::D3D11_USAGE_DEFAULT;
-    if (FAILED(_device->CreateTexture2D(
-            &depthStencilBufferDescriptor,
-            nullptr,
-            &depthBuffer)))
-    {
-        std::cout << "D3D11: Failed to create depth buffer\n";
-        return false;
-    }
-
-    if (FAILED(_device->CreateDepthStencilView(
-            depthBuffer.Get(),
-            nullptr,
-            &_depthStencilView)))
-    {
-        std::cout << "D3D11: Failed to create shaderresource view from back buffer\n";
-        return false;
-    }
-
-    return true;
-}
-
-void CameraApplication::DestroySwapchainResources()
-{
-    _depthStencilView.Reset();
-    _renderTarget.Reset();
-}
-
 void CameraApplication::OnResize(
     const int32_t width,
     const int32_t height)
@@ -326,21 +260,11 @@ void CameraApplication::OnResize(
     Application::OnResize(width, height);
     _deviceContext->Flush();
 
-    DestroySwapchainResources();
-
-    if (FAILED(_swapChain->ResizeBuffers(
-            0,
-            width,
-            height,
-            DXGI_FORMAT::DXGI_FORMAT_B8G8R8A8_UNORM,
-            0)))
+    if (!_renderBackend->ResizeBackBuffer(width, height))
     {
-        std::cout << "D3D11: Failed to recreate swapchain buffers\n";
         return;
     }
 
-    CreateSwapchainResources();
-
     _camera->Resize(width, height);
 
     ImGuiIO& io = ImGui::GetIO();
@@ -401,41 +325,151 @@ void CameraApplication::Update()
 
     DirectX::XMMATRIX rotationMatrix = DirectX::XMMatrixRotationY(DirectX::XMConvertToRadians(angle));
     DirectX::XMStoreFloat4x4(&_worldMatrix, rotationMatrix);
-    _deviceContext->UpdateSubresource(_objectConstantBuffer.Get(), &_worldMatrix);
 }
 
 void CameraApplication::Render()
 {
+    _deviceContext->BeginFrame();
     _camera->Update();
     CameraConstants& cameraConstants = _camera->GetCameraConstants();
-    _deviceContext->UpdateSubresource(_cameraConstantBuffer.Get(), &cameraConstants);
+    _deviceContext->UpdateSubresource(_cameraConstantBuffer.get(), &cameraConstants);
 
     float clearColor[] = { 0.1f, 0.1f, 0.1f, 1.0f };
 
     _deviceContext->Clear(
-        _renderTarget.Get(),
+        _renderBackend->GetBackBufferRenderTarget(),
         clearColor,
-        _depthStencilView.Get(),
+        _renderBackend->GetBackBufferDepthStencil(),
         1.0f);
+    // The atlas' view changes whenever a level streams in or is evicted
+    if (_atlasTexture != InvalidStreamedTextureHandle)
+    {
+        _textureStreamer->RequestResidency(_atlasTexture, GetProjectedModelSize(_model, _worldMatrix, *_camera));
+        _textureStreamer->Update();
+        _pipeline->BindTexture(0, _textureStreamer->GetShaderResourceView(_atlasTexture));
+    }
     _deviceContext->SetPipeline(_pipeline.get());
-    _deviceContext->SetVertexBuffer(_modelVertices.Get(), 0);
-    _deviceContext->SetIndexBuffer(_modelIndices.Get(), 0);
 
-    _deviceContext->DrawIndexed();
+    // Every model shares the pool's buffers, its allocation says where its own vertices and indices start
+    const GeometryAllocation& geometry = _geometryPool->GetAllocation(_model.Geometry);
+    const std::shared_ptr<RenderBuffer> indexBuffer = _geometryPool->GetIndexBuffer(_model.IndexFormat);
+    _deviceContext->SetVertexBuffer(_geometryPool->GetVertexBuffer(_model.VertexType), 0);
+
+    // Dequantizing the positions is folded into the world matrix of each submesh
+    const DirectX::XMMATRIX worldMatrix = DirectX::XMLoadFloat4x4(&_worldMatrix);
+    const auto setSubmeshWorldMatrix = [&](const Submesh& submesh)
+    {
+        const DirectX::XMMATRIX dequantizeMatrix = DirectX::XMMatrixMultiply(
+            DirectX::XMMatrixScaling(submesh.PositionScale.x, submesh.PositionScale.y, submesh.PositionScale.z),
+            DirectX::XMMatrixTranslation(submesh.PositionOffset.x, submesh.PositionOffset.y, submesh.PositionOffset.z));
+        DirectX::XMFLOAT4X4 submeshWorldMatrix;
+        DirectX::XMStoreFloat4x4(&submeshWorldMatrix, DirectX::XMMatrixMultiply(dequantizeMatrix, worldMatrix));
+        _deviceContext->UpdateSubresource(_objectConstantBuffer.get(), &submeshWorldMatrix);
+    };
+
+    if (_isLodSelectionEnabled)
+    {
+        _selectedLod = static_cast<int32_t>(SelectModelLod(_model, _worldMatrix, *_camera, _maxScreenSpaceError));
+    }
+
+    // Meshlets only exist for the full detail level, coarser levels are drawn as a whole
+    if (_selectedLod > 0 && _selectedLod < static_cast<int32_t>(_model.Lods.size()))
+    {
+        const ModelLod& lod = _model.Lods[_selectedLod];
+        _deviceContext->SetIndexBuffer(indexBuffer, _model.IndexFormat, 0);
+        for (uint32_t i = 0; i < _model.Submeshes.size(); i++)
+        {
+            const Submesh& submesh = _model.Submeshes[i];
+            const IndexRange& indexRange = _model.LodIndexRanges[lod.IndexRangeOffset + i];
+            if (indexRange.IndexCount == 0)
+            {
+                continue;
+            }
+
+            setSubmeshWorldMatrix(submesh);
+            _deviceContext->DrawIndexed(
+                indexRange.IndexCount,
+                geometry.FirstIndex + indexRange.IndexOffset,
+                static_cast<int32_t>(geometry.BaseVertex) + submesh.BaseVertex);
+        }
+    }
+    else if (_isMeshletCullingEnabled && _meshletCuller->GetIndexBuffer() != nullptr)
+    {
+        // Meshlet cones only hold for triangles facing the camera, so they are tested when backfaces are culled
+        _meshletCuller->Cull(_model, _worldMatrix, *_camera, _selectedRasterizerState == 11);
+        _deviceContext->SetIndexBuffer(_meshletCuller->GetIndexBuffer(), _model.IndexFormat, 0);
+        for (const CulledSubmesh& culledSubmesh : _meshletCuller->GetCulledSubmeshes())
+        {
+            const Submesh& submesh = _model.Submeshes[culledSubmesh.SubmeshIndex];
+            setSubmeshWorldMatrix(submesh);
+            _deviceContext->DrawIndexed(
+                culledSubmesh.IndexCount,
+                culledSubmesh.IndexOffset,
+                static_cast<int32_t>(geometry.BaseVertex) + submesh.BaseVertex);
+        }
+    }
+    else
+    {
+        _deviceContext->SetIndexBuffer(indexBuffer, _model.IndexFormat, 0);
+        for (const Submesh& submesh : _model.Submeshes)
+        {
+            setSubmeshWorldMatrix(submesh);
+            _deviceContext->DrawIndexed(
+                submesh.IndexCount,
+                geometry.FirstIndex + submesh.IndexOffset,
+                static_cast<int32_t>(geometry.BaseVertex) + submesh.BaseVertex);
+        }
+    }
+
+    if (IsHeadless())
+    {
+        return;
+    }
 
     RenderUi();
-    _swapChain->Present(1, 0);
+    _renderBackend->Present();
+}
+
+uint64_t CameraApplication::GetValidationErrorCount() const
+{
+    return _nullRenderBackend == nullptr ? 0 : _nullRenderBackend->GetStatistics().ValidationErrors;
 }
 
 void CameraApplication::RenderUi()
 {
-    ImGui_ImplDX11_NewFrame();
+    _renderBackend->NewUiFrame();
     ImGui::NewFrame();
 
     if (ImGui::Begin("Hello Froge"))
     {
         ImGui::Checkbox("Toggle Rotation", &_toggledRotation);
 
+        const DeviceContextStatistics& frameStatistics = _deviceContext->GetFrameStatistics();
+        ImGui::Text("State calls issued: %u", frameStatistics.IssuedStateCalls);
+        ImGui::Text("State calls skipped: %u", frameStatistics.SkippedStateCalls);
+
+        const int32_t lodCount = _model.Lods.empty() ? 1 : static_cast<int32_t>(_model.Lods.size());
+        ImGui::Checkbox("Automatic LOD", &_isLodSelectionEnabled);
+        if (_isLodSelectionEnabled)
+        {
+            ImGui::SliderFloat("Max Pixel Error", &_maxScreenSpaceError, 0.25f, 16.0f);
+            ImGui::Text("LOD: %d of %d", _selectedLod, lodCount);
+        }
+        else
+        {
+            ImGui::SliderInt("LOD", &_selectedLod, 0, lodCount - 1);
+        }
+
+        ImGui::Checkbox("Meshlet Culling", &_isMeshletCullingEnabled);
+        if (_isMeshletCullingEnabled)
+        {
+            const MeshletCullingStatistics& cullingStatistics = _meshletCuller->GetStatistics();
+            ImGui::Text("Meshlets: %u", cullingStatistics.Meshlets);
+            ImGui::Text("Frustum culled: %u", cullingStatistics.FrustumCulledMeshlets);
+            ImGui::Text("Backface culled: %u", cullingStatistics.BackfaceCulledMeshlets);
+            ImGui::Text("Triangles submitted: %u", cullingStatistics.SubmittedTriangles);
+        }
+
         ImGui::TextUnformatted("Depth State");
         ImGui::RadioButton("Disabled", &_selectedDepthFunction, 0);
         ImGui::RadioButton("Less", &_selectedDepthFunction, 1);
@@ -450,31 +484,31 @@ void CameraApplication::RenderUi()
         switch (_selectedDepthFunction)
         {
         case 0:
-            _pipeline->SetDepthStencilState(_depthDisabledDepthStencilState.Get());
+            _pipeline->SetDepthStencilState(_depthDisabledDepthStencilState);
             break;
         case 1:
-            _pipeline->SetDepthStencilState(_depthEnabledLessDepthStencilState.Get());
+            _pipeline->SetDepthStencilState(_depthEnabledLessDepthStencilState);
             break;
         case 2:
-            _pipeline->SetDepthStencilState(_depthEnabledLessEqualDepthStencilState.Get());
+            _pipeline->SetDepthStencilState(_depthEnabledLessEqualDepthStencilState);
             break;
         case 3:
-            _pipeline->SetDepthStencilState(_depthEnabledGreaterDepthStencilState.Get());
+            _pipeline->SetDepthStencilState(_depthEnabledGreaterDepthStencilState);
             break;
         case 4:
-            _pipeline->SetDepthStencilState(_depthEnabledGreaterEqualDepthStencilState.Get());
+            _pipeline->SetDepthStencilState(_depthEnabledGreaterEqualDepthStencilState);
             break;
         case 5:
-            _pipeline->SetDepthStencilState(_depthEnabledEqualDepthStencilState.Get());
+            _pipeline->SetDepthStencilState(_depthEnabledEqualDepthStencilState);
             break;
         case 6:
-            _pipeline->SetDepthStencilState(_depthEnabledNotEqualDepthStencilState.Get());
+            _pipeline->SetDepthStencilState(_depthEnabledNotEqualDepthStencilState);
             break;
         case 7:
-            _pipeline->SetDepthStencilState(_depthEnabledAlwaysDepthStencilState.Get());
+            _pipeline->SetDepthStencilState(_depthEnabledAlwaysDepthStencilState);
             break;
         case 8:
-            _pipeline->SetDepthStencilState(_depthEnabledNeverDepthStencilState.Get());
+            _pipeline->SetDepthStencilState(_depthEnabledNeverDepthStencilState);
             break;
         }
 
@@ -490,13 +524,13 @@ void CameraApplication::RenderUi()
             switch (_selectedRasterizerState)
             {
             case 10:
-                _pipeline->SetRasterizerState(_wireFrameCullFrontRasterizerState.Get());
+                _pipeline->SetRasterizerState(_wireFrameCullFrontRasterizerState);
                 break;
             case 11:
-                _pipeline->SetRasterizerState(_wireFrameCullBackRasterizerState.Get());
+                _pipeline->SetRasterizerState(_wireFrameCullBackRasterizerState);
                 break;
             case 12:
-                _pipeline->SetRasterizerState(_wireFrameCullNoneRasterizerState.Get());
+                _pipeline->SetRasterizerState(_wireFrameCullNoneRasterizerState);
                 break;
             }
         }
@@ -505,13 +539,13 @@ void CameraApplication::RenderUi()
             switch (_selectedRasterizerState)
             {
             case 10:
-                _pipeline->SetRasterizerState(_solidFrameCullFrontRasterizerState.Get());
+                _pipeline->SetRasterizerState(_solidFrameCullFrontRasterizerState);
                 break;
             case 11:
-                _pipeline->SetRasterizerState(_solidFrameCullBackRasterizerState.Get());
+                _pipeline->SetRasterizerState(_solidFrameCullBackRasterizerState);
                 break;
             case 12:
-                _pipeline->SetRasterizerState(_solidFrameCullNoneRasterizerState.Get());
+                _pipeline->SetRasterizerState(_solidFrameCullNoneRasterizerState);
                 break;
             }
         }
@@ -520,7 +554,7 @@ void CameraApplication::RenderUi()
     }
 
     ImGui::Render();
-    ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    _renderBackend->RenderUiDrawData();
 }
 
 void CameraApplication::InitializeImGui()
@@ -536,71 +570,70 @@ void CameraApplication::InitializeImGui()
 
 bool CameraApplication::CreateDepthStencilStates()
 {
-    D3D11_DEPTH_STENCIL_DESC depthStencilDescriptor = {};
-    depthStencilDescriptor.DepthEnable = false;
-    depthStencilDescriptor.DepthWriteMask = D3D11_DEPTH_WRITE_MASK::D3D11_DEPTH_WRITE_MASK_ALL;
-    depthStencilDescriptor.DepthFunc = D3D11_COMPARISON_FUNC::D3D11_COMPARISON_LESS;
-    depthStencilDescriptor.StencilEnable = false;
+    RenderDepthStencilDescription depthStencilDescription = {};
+    depthStencilDescription.IsDepthEnabled = false;
+    depthStencilDescription.IsDepthWriteEnabled = true;
+    depthStencilDescription.DepthFunction = RenderComparisonFunction::Less;
 
-    if (FAILED(_device->CreateDepthStencilState(&depthStencilDescriptor, &_depthDisabledDepthStencilState)))
+    if (!_renderBackend->CreateDepthStencilState(depthStencilDescription, _depthDisabledDepthStencilState))
     {
-        std::cout << "D3D11: Failed to create disabled depth stencil state\n";
+        std::cout << "CameraApplication: Failed to create disabled depth stencil state\n";
         return false;
     }
 
-    depthStencilDescriptor.DepthEnable = true;
-    if (FAILED(_device->CreateDepthStencilState(&depthStencilDescriptor, &_depthEnabledLessDepthStencilState)))
+    depthStencilDescription.IsDepthEnabled = true;
+    if (!_renderBackend->CreateDepthStencilState(depthStencilDescription, _depthEnabledLessDepthStencilState))
     {
-        std::cout << "D3D11: Failed to create enabled depth stencil state\n";
+        std::cout << "CameraApplication: Failed to create enabled depth stencil state\n";
         return false;
     }
 
-    depthStencilDescriptor.DepthFunc = D3D11_COMPARISON_FUNC::D3D11_COMPARISON_LESS_EQUAL;
-    if (FAILED(_device->CreateDepthStencilState(&depthStencilDescriptor, &_depthEnabledLessEqualDepthStencilState)))
+    depthStencilDescription.DepthFunction = RenderComparisonFunction::LessEqual;
+    if (!_renderBackend->CreateDepthStencilState(depthStencilDescription, _depthEnabledLessEqualDepthStencilState))
     {
-        std::cout << "D3D11: Failed to create enabled depth stencil state\n";
+        std::cout << "CameraApplication: Failed to create enabled depth stencil state\n";
         return false;
     }
 
-    depthStencilDescriptor.DepthFunc = D3D11_COMPARISON_FUNC::D3D11_COMPARISON_ALWAYS;
-    if (FAILED(_device->CreateDepthStencilState(&depthStencilDescriptor, &_depthEnabledAlwaysDepthStencilState)))
+    depthStencilDescription.DepthFunction = RenderComparisonFunction::Always;
+    if (!_renderBackend->CreateDepthStencilState(depthStencilDescription, _depthEnabledAlwaysDepthStencilState))
     {
-        std::cout << "D3D11: Failed to create enabled depth stencil state\n";
+        std::cout << "CameraApplication: Failed to create enabled depth stencil state\n";
         return false;
     }
 
-    depthStencilDescriptor.DepthFunc = D3D11_COMPARISON_FUNC::D3D11_COMPARISON_NEVER;
-    if (FAILED(_device->CreateDepthStencilState(&depthStencilDescriptor, &_depthEnabledNeverDepthStencilState)))
+    depthStencilDescription.DepthFunction = RenderComparisonFunction::Never;
+    if (!_renderBackend->CreateDepthStencilState(depthStencilDescription, _depthEnabledNeverDepthStencilState))
     {
-        std::cout << "D3D11: Failed to create enabled depth stencil state\n";
+        std::cout << "CameraApplication: Failed to create enabled depth stencil state\n";
         return false;
     }
 
-    depthStencilDescriptor.DepthFunc = D3D11_COMPARISON_FUNC::D3D11_COMPARISON_GREATER;
-    if (FAILED(_device->CreateDepthStencilState(&depthStencilDescriptor, &_depthEnabledGreaterDepthStencilState)))
+    depthStencilDescription.DepthFunction = RenderComparisonFunction::Greater;
+    if (!_renderBackend->CreateDepthStencilState(depthStencilDescription, _depthEnabledGreaterDepthStencilState))
     {
-        std::cout << "D3D11: Failed to create enabled depth stencil state\n";
+        std::cout << "CameraApplication: Failed to create enabled depth stencil state\n";
         return false;
     }
 
-    depthStencilDescriptor.DepthFunc = D3D11_COMPARISON_FUNC::D3D11_COMPARISON_GREATER_EQUAL;
-    if (FAILED(_device->CreateDepthStencilState(&depthStencilDescriptor, &_depthEnabledGreaterEqualDepthStencilState)))
+    depthStencilDescription.DepthFunction = RenderComparisonFunction::GreaterEqual;
+    if (!_renderBackend->CreateDepthStencilState(depthStencilDescription, _depthEnabledGreaterEqualDepthStencilState))
     {
-        std::cout << "D3D11: Failed to create enabled depth stencil state\n";
+        std::cout << "CameraApplication: Failed to create enabled depth stencil state\n";
         return false;
     }
 
-    depthStencilDescriptor.DepthFunc = D3D11_COMPARISON_FUNC::D3D11_COMPARISON_EQUAL;
-    if (FAILED(_device->CreateDepthStencilState(&depthStencilDescriptor, &_depthEnabledEqualDepthStencilState)))
+    depthStencilDescription.DepthFunction = RenderComparisonFunction::Equal;
+    if (!_renderBackend->CreateDepthStencilState(depthStencilDescription, _depthEnabledEqualDepthStencilState))
     {
-        std::cout << "D3D11: Failed to create enabled depth stencil state\n";
+        std::cout << "CameraApplication: Failed to create enabled depth stencil state\n";
         return false;
     }
 
-    depthStencilDescriptor.DepthFunc = D3D11_COMPARISON_FUNC::D3D11_COMPARISON_NOT_EQUAL;
-    if (FAILED(_device->CreateDepthStencilState(&depthStencilDescriptor, &_depthEnabledNotEqualDepthStencilState)))
+    depthStencilDescription.DepthFunction = RenderComparisonFunction::NotEqual;
+    if (!_renderBackend->CreateDepthStencilState(depthStencilDescription, _depthEnabledNotEqualDepthStencilState))
     {
-        std::cout << "D3D11: Failed to create enabled depth stencil state\n";
+        std::cout << "CameraApplication: Failed to create enabled depth stencil state\n";
         return false;
     }
 
@@ -609,59 +642,53 @@ bool CameraApplication::CreateDepthStencilStates()
 
 bool CameraApplication::CreateRasterizerStates()
 {
-    D3D11_RASTERIZER_DESC rasterizerStateDescriptor = {};
-    rasterizerStateDescriptor.AntialiasedLineEnable = false;
-    rasterizerStateDescriptor.DepthBias = 0;
-    rasterizerStateDescriptor.DepthBiasClamp = 0.0f;
-    rasterizerStateDescriptor.DepthClipEnable = true;
-    rasterizerStateDescriptor.FrontCounterClockwise = true;
-    rasterizerStateDescriptor.MultisampleEnable = false;
-    rasterizerStateDescriptor.ScissorEnable = false;
-    rasterizerStateDescriptor.SlopeScaledDepthBias = 0.0f;
-
-    rasterizerStateDescriptor.FillMode = D3D11_FILL_MODE::D3D11_FILL_SOLID;
-
-    rasterizerStateDescriptor.CullMode = D3D11_CULL_MODE::D3D11_CULL_BACK;
-    if (FAILED(_device->CreateRasterizerState(&rasterizerStateDescriptor, &_solidFrameCullBackRasterizerState)))
-    {
-        std::cout << "D3D11: Failed to create rasterizer state\n";
+    RenderRasterizerDescription rasterizerStateDescription = {};
+    rasterizerStateDescription.IsDepthClipEnabled = true;
+    rasterizerStateDescription.IsFrontCounterClockwise = true;
+
+    rasterizerStateDescription.FillMode = RenderFillMode::Solid;
+
+    rasterizerStateDescription.CullMode = RenderCullMode::Back;
+    if (!_renderBackend->CreateRasterizerState(rasterizerStateDescription, _solidFrameCullBackRasterizerState))
+    {
+        std::cout << "CameraApplication: Failed to create rasterizer state\n";
         return false;
     }
 
-    rasterizerStateDescriptor.CullMode = D3D11_CULL_MODE::D3D11_CULL_FRONT;
-    if (FAILED(_device->CreateRasterizerState(&rasterizerStateDescriptor, &_solidFrameCullFrontRasterizerState)))
+    rasterizerStateDescription.CullMode = RenderCullMode::Front;
+    if (!_renderBackend->CreateRasterizerState(rasterizerStateDescription, _solidFrameCullFrontRasterizerState))
     {
-        std::cout << "D3D11: Failed to create rasterizer state\n";
+        std::cout << "CameraApplication: Failed to create rasterizer state\n";
         return false;
     }
 
-    rasterizerStateDescriptor.CullMode = D3D11_CULL_MODE::D3D11_CULL_NONE;
-    if (FAILED(_device->CreateRasterizerState(&rasterizerStateDescriptor, &_solidFrameCullNoneRasterizerState)))
+    rasterizerStateDescription.CullMode = RenderCullMode::None;
+    if (!_renderBackend->CreateRasterizerState(rasterizerStateDescription, _solidFrameCullNoneRasterizerState))
     {
-        std::cout << "D3D11: Failed to create rasterizer state\n";
+        std::cout << "CameraApplication: Failed to create rasterizer state\n";
         return false;
     }
 
-    rasterizerStateDescriptor.FillMode = D3D11_FILL_MODE::D3D11_FILL_WIREFRAME;
+    rasterizerStateDescription.FillMode = RenderFillMode::Wireframe;
 
-    rasterizerStateDescriptor.CullMode = D3D11_CULL_MODE::D3D11_CULL_BACK;
-    if (FAILED(_device->CreateRasterizerState(&rasterizerStateDescriptor, &_wireFrameCullBackRasterizerState)))
+    rasterizerStateDescription.CullMode = RenderCullMode::Back;
+    if (!_renderBackend->CreateRasterizerState(rasterizerStateDescription, _wireFrameCullBackRasterizerState))
     {
-        std::cout << "D3D11: Failed to create rasterizer state\n";
+        std::cout << "CameraApplication: Failed to create rasterizer state\n";
         return false;
     }
 
-    rasterizerStateDescriptor.CullMode = D3D11_CULL_MODE::D3D11_CULL_FRONT;
-    if (FAILED(_device->CreateRasterizerState(&rasterizerStateDescriptor, &_wireFrameCullFrontRasterizerState)))
+    rasterizerStateDescription.CullMode = RenderCullMode::Front;
+    if (!_renderBackend->CreateRasterizerState(rasterizerStateDescription, _wireFrameCullFrontRasterizerState))
     {
-        std::cout << "D3D11: Failed to create rasterizer state\n";
+        std::cout << "CameraApplication: Failed to create rasterizer state\n";
         return false;
     }
 
-    rasterizerStateDescriptor.CullMode = D3D11_CULL_MODE::D3D11_CULL_NONE;
-    if (FAILED(_device->CreateRasterizerState(&rasterizerStateDescriptor, &_wireFrameCullNoneRasterizerState)))
+    rasterizerStateDescription.CullMode = RenderCullMode::None;
+    if (!_renderBackend->CreateRasterizerState(rasterizerStateDescription, _wireFrameCullNoneRasterizerState))
     {
-        std::cout << "D3D11: Failed to create rasterizer state\n";
+        std::cout << "CameraApplication: Failed to create rasterizer state\n";
         return false;
     }
 
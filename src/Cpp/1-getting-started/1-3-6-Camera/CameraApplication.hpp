@@ -1,19 +1,24 @@
 #pragma once
 
 #include "ApplicationWithInput.hpp"
-#include "Definitions.hpp"
+#include "Model.hpp"
+#include "RenderTypes.hpp"
+#include "TextureStreamer.hpp"
 
 #include <DirectXMath.h>
-#include <d3d11_2.h>
 
 #include <memory>
 
-class Camera;
+class PerspectiveCamera;
 class Pipeline;
 class PipelineFactory;
 class DeviceContext;
 class TextureFactory;
 class ModelFactory;
+class GeometryPool;
+class MeshletCuller;
+class RenderBackend;
+class NullRenderBackend;
 
 struct ImGuiContext;
 
@@ -31,65 +36,64 @@ protected:
         int32_t height) override;
     void Update() override;
     void Render() override;
+    [[nodiscard]] uint64_t GetValidationErrorCount() const override;
 
 private:
-    bool CreateSwapchainResources();
-    void DestroySwapchainResources();
-
     bool CreateDepthStencilStates();
     bool CreateRasterizerStates();
 
     void InitializeImGui();
     void RenderUi();
 
-    std::unique_ptr<Camera> _camera = nullptr;
+    // The unique_ptrs to forward declared types go without "= nullptr", GCC wants their destructors complete for it
+    std::unique_ptr<PerspectiveCamera> _camera;
 
-    std::unique_ptr<Pipeline> _pipeline = nullptr;
-    std::unique_ptr<DeviceContext> _deviceContext = nullptr;
-    std::unique_ptr<PipelineFactory> _pipelineFactory = nullptr;
-    std::unique_ptr<TextureFactory> _textureFactory = nullptr;
-    std::unique_ptr<ModelFactory> _modelFactory = nullptr;
+    std::shared_ptr<RenderBackend> _renderBackend = nullptr;
+    std::shared_ptr<NullRenderBackend> _nullRenderBackend = nullptr;
+    std::unique_ptr<Pipeline> _pipeline;
+    std::unique_ptr<DeviceContext> _deviceContext;
+    std::unique_ptr<PipelineFactory> _pipelineFactory;
+    std::unique_ptr<TextureFactory> _textureFactory;
+    std::unique_ptr<TextureStreamer> _textureStreamer = nullptr;
+    std::shared_ptr<GeometryPool> _geometryPool = nullptr;
+    std::unique_ptr<ModelFactory> _modelFactory;
+    std::unique_ptr<MeshletCuller> _meshletCuller;
 
     ImGuiContext* _imGuiContext = nullptr;
 
-    WRL::ComPtr<ID3D11Device> _device = nullptr;
-    WRL::ComPtr<IDXGIFactory2> _dxgiFactory = nullptr;
-    WRL::ComPtr<IDXGISwapChain1> _swapChain = nullptr;
-    WRL::ComPtr<ID3D11RenderTargetView> _renderTarget = nullptr;
-    WRL::ComPtr<ID3D11DepthStencilView> _depthStencilView = nullptr;
-    WRL::ComPtr<ID3D11Buffer> _modelVertices = nullptr;
-    WRL::ComPtr<ID3D11Buffer> _modelIndices = nullptr;
-    WRL::ComPtr<ID3D11Debug> _debug = nullptr;
-
-    WRL::ComPtr<ID3D11DepthStencilState> _depthDisabledDepthStencilState = nullptr;
-    WRL::ComPtr<ID3D11DepthStencilState> _depthEnabledLessDepthStencilState = nullptr;
-    WRL::ComPtr<ID3D11DepthStencilState> _depthEnabledLessEqualDepthStencilState = nullptr;
-    WRL::ComPtr<ID3D11DepthStencilState> _depthEnabledAlwaysDepthStencilState = nullptr;
-    WRL::ComPtr<ID3D11DepthStencilState> _depthEnabledNeverDepthStencilState = nullptr;
-    WRL::ComPtr<ID3D11DepthStencilState> _depthEnabledEqualDepthStencilState = nullptr;
-    WRL::ComPtr<ID3D11DepthStencilState> _depthEnabledNotEqualDepthStencilState = nullptr;
-    WRL::ComPtr<ID3D11DepthStencilState> _depthEnabledGreaterDepthStencilState = nullptr;
-    WRL::ComPtr<ID3D11DepthStencilState> _depthEnabledGreaterEqualDepthStencilState = nullptr;
-
-    WRL::ComPtr<ID3D11RasterizerState> _wireFrameCullBackRasterizerState = nullptr;
-    WRL::ComPtr<ID3D11RasterizerState> _wireFrameCullFrontRasterizerState = nullptr;
-    WRL::ComPtr<ID3D11RasterizerState> _wireFrameCullNoneRasterizerState = nullptr;
-
-    WRL::ComPtr<ID3D11RasterizerState> _solidFrameCullBackRasterizerState = nullptr;
-    WRL::ComPtr<ID3D11RasterizerState> _solidFrameCullFrontRasterizerState = nullptr;
-    WRL::ComPtr<ID3D11RasterizerState> _solidFrameCullNoneRasterizerState = nullptr;
-
-    WRL::ComPtr<ID3D11SamplerState> _linearSamplerState = nullptr;
-    WRL::ComPtr<ID3D11ShaderResourceView> _textureSrv = nullptr;
-    WRL::ComPtr<ID3D11Buffer> _cameraConstantBuffer = nullptr;
-    WRL::ComPtr<ID3D11Buffer> _objectConstantBuffer = nullptr;
+    std::shared_ptr<RenderDepthStencilState> _depthDisabledDepthStencilState = nullptr;
+    std::shared_ptr<RenderDepthStencilState> _depthEnabledLessDepthStencilState = nullptr;
+    std::shared_ptr<RenderDepthStencilState> _depthEnabledLessEqualDepthStencilState = nullptr;
+    std::shared_ptr<RenderDepthStencilState> _depthEnabledAlwaysDepthStencilState = nullptr;
+    std::shared_ptr<RenderDepthStencilState> _depthEnabledNeverDepthStencilState = nullptr;
+    std::shared_ptr<RenderDepthStencilState> _depthEnabledEqualDepthStencilState = nullptr;
+    std::shared_ptr<RenderDepthStencilState> _depthEnabledNotEqualDepthStencilState = nullptr;
+    std::shared_ptr<RenderDepthStencilState> _depthEnabledGreaterDepthStencilState = nullptr;
+    std::shared_ptr<RenderDepthStencilState> _depthEnabledGreaterEqualDepthStencilState = nullptr;
+
+    std::shared_ptr<RenderRasterizerState> _wireFrameCullBackRasterizerState = nullptr;
+    std::shared_ptr<RenderRasterizerState> _wireFrameCullFrontRasterizerState = nullptr;
+    std::shared_ptr<RenderRasterizerState> _wireFrameCullNoneRasterizerState = nullptr;
+
+    std::shared_ptr<RenderRasterizerState> _solidFrameCullBackRasterizerState = nullptr;
+    std::shared_ptr<RenderRasterizerState> _solidFrameCullFrontRasterizerState = nullptr;
+    std::shared_ptr<RenderRasterizerState> _solidFrameCullNoneRasterizerState = nullptr;
+
+    std::shared_ptr<RenderSamplerState> _linearSamplerState = nullptr;
+    std::shared_ptr<RenderShaderResourceView> _textureSrv = nullptr;
+    StreamedTextureHandle _atlasTexture = InvalidStreamedTextureHandle;
+    std::shared_ptr<RenderBuffer> _cameraConstantBuffer = nullptr;
+    std::shared_ptr<RenderBuffer> _objectConstantBuffer = nullptr;
 
     DirectX::XMFLOAT4X4 _worldMatrix = DirectX::XMFLOAT4X4();
 
-    uint32_t _modelVertexCount = 0;
-    uint32_t _modelIndexCount = 0;
+    Model _model = {};
     bool _toggledRotation = false;
     int32_t _selectedDepthFunction = 1;
     int32_t _selectedRasterizerState = 11;
     bool _isWireframe = false;
+    bool _isMeshletCullingEnabled = true;
+    bool _isLodSelectionEnabled = true;
+    int32_t _selectedLod = 0;
+    float _maxScreenSpaceError = 1.0f;
 };
@@ -0,0 +1,1020 @@
+#include "D3D11RenderBackend.hpp"
+
+#include <d3dcompiler.h>
+
+#include <imgui/backend/imgui_impl_dx11.h>
+#include <imgui/imgui.h>
+
+#include <array>
+#include <iostream>
+#include <utility>
+
+#pragma comment(lib, "d3d11.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+#pragma comment(lib, "winmm.lib")
+#pragma comment(lib, "dxguid.lib")
+
+namespace
+{
+static_assert(static_cast<DXGI_FORMAT>(RenderFormat::R32G32B32Float) == DXGI_FORMAT::DXGI_FORMAT_R32G32B32_FLOAT, "RenderFormat must match DXGI_FORMAT");
+static_assert(static_cast<DXGI_FORMAT>(RenderFormat::R8G8B8A8Unorm) == DXGI_FORMAT::DXGI_FORMAT_R8G8B8A8_UNORM, "RenderFormat must match DXGI_FORMAT");
+static_assert(static_cast<DXGI_FORMAT>(RenderFormat::R32Uint) == DXGI_FORMAT::DXGI_FORMAT_R32_UINT, "RenderFormat must match DXGI_FORMAT");
+static_assert(static_cast<DXGI_FORMAT>(RenderFormat::D24UnormS8Uint) == DXGI_FORMAT::DXGI_FORMAT_D24_UNORM_S8_UINT, "RenderFormat must match DXGI_FORMAT");
+static_assert(static_cast<DXGI_FORMAT>(RenderFormat::R16Uint) == DXGI_FORMAT::DXGI_FORMAT_R16_UINT, "RenderFormat must match DXGI_FORMAT");
+static_assert(static_cast<DXGI_FORMAT>(RenderFormat::Bc1Typeless) == DXGI_FORMAT::DXGI_FORMAT_BC1_TYPELESS, "RenderFormat must match DXGI_FORMAT");
+static_assert(static_cast<DXGI_FORMAT>(RenderFormat::Bc5Snorm) == DXGI_FORMAT::DXGI_FORMAT_BC5_SNORM, "RenderFormat must match DXGI_FORMAT");
+static_assert(static_cast<DXGI_FORMAT>(RenderFormat::B8G8R8A8Unorm) == DXGI_FORMAT::DXGI_FORMAT_B8G8R8A8_UNORM, "RenderFormat must match DXGI_FORMAT");
+static_assert(static_cast<DXGI_FORMAT>(RenderFormat::Bc6hTypeless) == DXGI_FORMAT::DXGI_FORMAT_BC6H_TYPELESS, "RenderFormat must match DXGI_FORMAT");
+static_assert(static_cast<DXGI_FORMAT>(RenderFormat::Bc7UnormSrgb) == DXGI_FORMAT::DXGI_FORMAT_BC7_UNORM_SRGB, "RenderFormat must match DXGI_FORMAT");
+static_assert(RenderVertexBufferSlotCount == D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT, "Slot counts must match D3D11");
+static_assert(RenderConstantBufferSlotCount == D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT, "Slot counts must match D3D11");
+static_assert(RenderShaderResourceSlotCount == D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT, "Slot counts must match D3D11");
+static_assert(RenderSamplerSlotCount == D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, "Slot counts must match D3D11");
+static_assert(RenderMaxMipLevels == D3D11_REQ_MIP_LEVELS, "Mip level limit must match D3D11");
+static_assert(RenderMaxTextureDimension == D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION, "Texture size limit must match D3D11");
+static_assert(RenderMaxTextureArraySize == D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION, "Texture array size limit must match D3D11");
+
+// A render object together with the D3D11 object it stands for. Every object handed out by
+// D3D11RenderBackend is one of these, which is what makes the casts in ToNative safe
+template <typename TRenderObject, typename TNative>
+class D3D11Object final : public TRenderObject
+{
+public:
+    template <typename... TArguments>
+    explicit D3D11Object(
+        WRL::ComPtr<TNative> native,
+        const TArguments&... arguments)
+        : TRenderObject(arguments...),
+          _native(std::move(native))
+    {
+    }
+
+    void SetDebugName(const std::string& debugName) override
+    {
+        TRenderObject::SetDebugName(debugName);
+        _native->SetPrivateData(WKPDID_D3DDebugObjectName, static_cast<UINT>(debugName.size()), debugName.data());
+    }
+
+    [[nodiscard]] TNative* GetNative() const
+    {
+        return _native.Get();
+    }
+
+private:
+    WRL::ComPtr<TNative> _native = nullptr;
+};
+
+using D3D11Buffer = D3D11Object<RenderBuffer, ID3D11Buffer>;
+using D3D11Texture2D = D3D11Object<RenderTexture2D, ID3D11Texture2D>;
+using D3D11ShaderResourceView = D3D11Object<RenderShaderResourceView, ID3D11ShaderResourceView>;
+using D3D11SamplerState = D3D11Object<RenderSamplerState, ID3D11SamplerState>;
+using D3D11DepthStencilState = D3D11Object<RenderDepthStencilState, ID3D11DepthStencilState>;
+using D3D11RasterizerState = D3D11Object<RenderRasterizerState, ID3D11RasterizerState>;
+using D3D11VertexShader = D3D11Object<RenderVertexShader, ID3D11VertexShader>;
+using D3D11PixelShader = D3D11Object<RenderPixelShader, ID3D11PixelShader>;
+using D3D11InputLayout = D3D11Object<RenderInputLayout, ID3D11InputLayout>;
+using D3D11RenderTargetView = D3D11Object<RenderTargetView, ID3D11RenderTargetView>;
+using D3D11DepthStencilView = D3D11Object<RenderDepthStencilView, ID3D11DepthStencilView>;
+
+template <typename TD3D11Object, typename TRenderObject>
+auto ToNative(TRenderObject* renderObject) -> decltype(static_cast<TD3D11Object*>(renderObject)->GetNative())
+{
+    return renderObject != nullptr
+             ? static_cast<TD3D11Object*>(renderObject)->GetNative()
+             : nullptr;
+}
+
+ID3D11Resource* ToNativeResource(RenderResource* resource)
+{
+    if (resource == nullptr)
+    {
+        return nullptr;
+    }
+
+    switch (resource->GetDimension())
+    {
+    case RenderResourceDimension::Buffer:
+        return ToNative<D3D11Buffer>(static_cast<RenderBuffer*>(resource));
+    case RenderResourceDimension::Texture2D:
+        return ToNative<D3D11Texture2D>(static_cast<RenderTexture2D*>(resource));
+    }
+
+    return nullptr;
+}
+
+// count never exceeds SlotCount, DeviceContext only binds within the slot tables
+template <typename TD3D11Object, typename TRenderObject, typename TNative, size_t SlotCount>
+void ToNativeArray(
+    TRenderObject* const* renderObjects,
+    const uint32_t count,
+    std::array<TNative*, SlotCount>& natives)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        natives[i] = ToNative<TD3D11Object>(renderObjects[i]);
+    }
+}
+
+DXGI_FORMAT ToNative(const RenderFormat format)
+{
+    return static_cast<DXGI_FORMAT>(format);
+}
+
+D3D11_USAGE ToNative(const RenderUsage usage)
+{
+    switch (usage)
+    {
+    case RenderUsage::Immutable:
+        return D3D11_USAGE::D3D11_USAGE_IMMUTABLE;
+    case RenderUsage::Dynamic:
+        return D3D11_USAGE::D3D11_USAGE_DYNAMIC;
+    default:
+        return D3D11_USAGE::D3D11_USAGE_DEFAULT;
+    }
+}
+
+uint32_t GetCpuAccessFlags(const RenderUsage usage)
+{
+    return usage == RenderUsage::Dynamic
+             ? D3D11_CPU_ACCESS_FLAG::D3D11_CPU_ACCESS_WRITE
+             : 0;
+}
+
+uint32_t ToNativeBindFlags(const uint32_t bindFlags)
+{
+    uint32_t nativeBindFlags = 0;
+    if ((bindFlags & RenderBindFlags::RenderBindVertexBuffer) != 0)
+    {
+        nativeBindFlags |= D3D11_BIND_FLAG::D3D11_BIND_VERTEX_BUFFER;
+    }
+
+    if ((bindFlags & RenderBindFlags::RenderBindIndexBuffer) != 0)
+    {
+        nativeBindFlags |= D3D11_BIND_FLAG::D3D11_BIND_INDEX_BUFFER;
+    }
+
+    if ((bindFlags & RenderBindFlags::RenderBindConstantBuffer) != 0)
+    {
+        nativeBindFlags |= D3D11_BIND_FLAG::D3D11_BIND_CONSTANT_BUFFER;
+    }
+
+    if ((bindFlags & RenderBindFlags::RenderBindShaderResource) != 0)
+    {
+        nativeBindFlags |= D3D11_BIND_FLAG::D3D11_BIND_SHADER_RESOURCE;
+    }
+
+    if ((bindFlags & RenderBindFlags::RenderBindRenderTarget) != 0)
+    {
+        nativeBindFlags |= D3D11_BIND_FLAG::D3D11_BIND_RENDER_TARGET;
+    }
+
+    if ((bindFlags & RenderBindFlags::RenderBindDepthStencil) != 0)
+    {
+        nativeBindFlags |= D3D11_BIND_FLAG::D3D11_BIND_DEPTH_STENCIL;
+    }
+
+    return nativeBindFlags;
+}
+
+uint32_t ToNativeClearFlags(const uint32_t clearFlags)
+{
+    uint32_t nativeClearFlags = 0;
+    if ((clearFlags & RenderClearFlags::RenderClearDepth) != 0)
+    {
+        nativeClearFlags |= D3D11_CLEAR_FLAG::D3D11_CLEAR_DEPTH;
+    }
+
+    if ((clearFlags & RenderClearFlags::RenderClearStencil) != 0)
+    {
+        nativeClearFlags |= D3D11_CLEAR_FLAG::D3D11_CLEAR_STENCIL;
+    }
+
+    return nativeClearFlags;
+}
+
+D3D11_FILTER ToNative(const RenderFilter filter)
+{
+    switch (filter)
+    {
+    case RenderFilter::MinMagMipPoint:
+        return D3D11_FILTER::D3D11_FILTER_MIN_MAG_MIP_POINT;
+    case RenderFilter::MinMagLinearMipPoint:
+        return D3D11_FILTER::D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT;
+    case RenderFilter::Anisotropic:
+        return D3D11_FILTER::D3D11_FILTER_ANISOTROPIC;
+    default:
+        return D3D11_FILTER::D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    }
+}
+
+D3D11_TEXTURE_ADDRESS_MODE ToNative(const RenderTextureAddressMode addressMode)
+{
+    switch (addressMode)
+    {
+    case RenderTextureAddressMode::Wrap:
+        return D3D11_TEXTURE_ADDRESS_MODE::D3D11_TEXTURE_ADDRESS_WRAP;
+    case RenderTextureAddressMode::Mirror:
+        return D3D11_TEXTURE_ADDRESS_MODE::D3D11_TEXTURE_ADDRESS_MIRROR;
+    default:
+        return D3D11_TEXTURE_ADDRESS_MODE::D3D11_TEXTURE_ADDRESS_CLAMP;
+    }
+}
+
+D3D11_COMPARISON_FUNC ToNative(const RenderComparisonFunction comparisonFunction)
+{
+    switch (comparisonFunction)
+    {
+    case RenderComparisonFunction::Never:
+        return D3D11_COMPARISON_FUNC::D3D11_COMPARISON_NEVER;
+    case RenderComparisonFunction::Less:
+        return D3D11_COMPARISON_FUNC::D3D11_COMPARISON_LESS;
+    case RenderComparisonFunction::Equal:
+        return D3D11_COMPARISON_FUNC::D3D11_COMPARISON_EQUAL;
+    case RenderComparisonFunction::LessEqual:
+        return D3D11_COMPARISON_FUNC::D3D11_COMPARISON_LESS_EQUAL;
+    case RenderComparisonFunction::Greater:
+        return D3D11_COMPARISON_FUNC::D3D11_COMPARISON_GREATER;
+    case RenderComparisonFunction::NotEqual:
+        return D3D11_COMPARISON_FUNC::D3D11_COMPARISON_NOT_EQUAL;
+    case RenderComparisonFunction::GreaterEqual:
+        return D3D11_COMPARISON_FUNC::D3D11_COMPARISON_GREATER_EQUAL;
+    default:
+        return D3D11_COMPARISON_FUNC::D3D11_COMPARISON_ALWAYS;
+    }
+}
+
+D3D11_FILL_MODE ToNative(const RenderFillMode fillMode)
+{
+    return fillMode == RenderFillMode::Wireframe
+             ? D3D11_FILL_MODE::D3D11_FILL_WIREFRAME
+             : D3D11_FILL_MODE::D3D11_FILL_SOLID;
+}
+
+D3D11_CULL_MODE ToNative(const RenderCullMode cullMode)
+{
+    switch (cullMode)
+    {
+    case RenderCullMode::None:
+        return D3D11_CULL_MODE::D3D11_CULL_NONE;
+    case RenderCullMode::Front:
+        return D3D11_CULL_MODE::D3D11_CULL_FRONT;
+    default:
+        return D3D11_CULL_MODE::D3D11_CULL_BACK;
+    }
+}
+
+D3D11_PRIMITIVE_TOPOLOGY ToNative(const RenderPrimitiveTopology primitiveTopology)
+{
+    switch (primitiveTopology)
+    {
+    case RenderPrimitiveTopology::PointList:
+        return D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_POINTLIST;
+    case RenderPrimitiveTopology::LineList:
+        return D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_LINELIST;
+    case RenderPrimitiveTopology::LineStrip:
+        return D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP;
+    case RenderPrimitiveTopology::TriangleList:
+        return D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+    case RenderPrimitiveTopology::TriangleStrip:
+        return D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+    default:
+        return D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+    }
+}
+
+D3D11_MAP ToNative(const RenderMapType mapType)
+{
+    return mapType == RenderMapType::WriteNoOverwrite
+             ? D3D11_MAP::D3D11_MAP_WRITE_NO_OVERWRITE
+             : D3D11_MAP::D3D11_MAP_WRITE_DISCARD;
+}
+
+D3D11_BOX ToNative(const RenderBox& box)
+{
+    D3D11_BOX nativeBox = {};
+    nativeBox.left = box.Left;
+    nativeBox.top = box.Top;
+    nativeBox.front = box.Front;
+    nativeBox.right = box.Right;
+    nativeBox.bottom = box.Bottom;
+    nativeBox.back = box.Back;
+    return nativeBox;
+}
+
+uint32_t GetMipLevels(const RenderTextureDescription& textureDescription)
+{
+    if (textureDescription.MipLevels > 0)
+    {
+        return textureDescription.MipLevels;
+    }
+
+    return GetFullMipLevelCount(textureDescription.Width, textureDescription.Height);
+}
+} // namespace
+
+D3D11RenderBackend::~D3D11RenderBackend()
+{
+    if (_isImGuiInitialized)
+    {
+        ImGui_ImplDX11_Shutdown();
+    }
+
+    DestroySwapchainResources();
+    _swapChain.Reset();
+    _dxgiFactory.Reset();
+    _deviceContext.Reset();
+#if !defined(NDEBUG)
+    if (_debug != nullptr)
+    {
+        _debug->ReportLiveDeviceObjects(D3D11_RLDO_FLAGS::D3D11_RLDO_DETAIL);
+        _debug.Reset();
+    }
+#endif
+    _device.Reset();
+}
+
+bool D3D11RenderBackend::Initialize(
+    const HWND window,
+    const uint32_t width,
+    const uint32_t height)
+{
+    // This section initializes DirectX's devices and SwapChain
+    if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&_dxgiFactory))))
+    {
+        std::cout << "DXGI: Failed to create factory\n";
+        return false;
+    }
+
+    constexpr D3D_FEATURE_LEVEL deviceFeatureLevel = D3D_FEATURE_LEVEL::D3D_FEATURE_LEVEL_11_0;
+    uint32_t deviceFlags = 0;
+#if !defined(NDEBUG)
+    deviceFlags |= D3D11_CREATE_DEVICE_FLAG::D3D11_CREATE_DEVICE_DEBUG;
+#endif
+
+    if (FAILED(D3D11CreateDevice(
+            nullptr,
+            D3D_DRIVER_TYPE::D3D_DRIVER_TYPE_HARDWARE,
+            nullptr,
+            deviceFlags,
+            &deviceFeatureLevel,
+            1,
+            D3D11_SDK_VERSION,
+            &_device,
+            nullptr,
+            &_deviceContext)))
+    {
+        std::cout << "D3D11: Failed to create Device and Device Context\n";
+        return false;
+    }
+
+    if (FAILED(_device.As(&_debug)))
+    {
+        std::cout << "D3D11: Failed to get the debug layer from the device\n";
+        return false;
+    }
+
+    constexpr char deviceName[] = "DEV_Main";
+    _device->SetPrivateData(WKPDID_D3DDebugObjectName, sizeof(deviceName), deviceName);
+    constexpr char deviceContextName[] = "CTX_Main";
+    _deviceContext->SetPrivateData(WKPDID_D3DDebugObjectName, sizeof(deviceContextName) - 1, deviceContextName);
+
+    ImGui_ImplDX11_Init(_device.Get(), _deviceContext.Get());
+    _isImGuiInitialized = true;
+
+    DXGI_SWAP_CHAIN_DESC1 swapChainDescriptor = {};
+    swapChainDescriptor.Width = width;
+    swapChainDescriptor.Height = height;
+    swapChainDescriptor.Format = DXGI_FORMAT::DXGI_FORMAT_B8G8R8A8_UNORM;
+    swapChainDescriptor.SampleDesc.Count = 1;
+    swapChainDescriptor.SampleDesc.Quality = 0;
+    swapChainDescriptor.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    swapChainDescriptor.BufferCount = 2;
+    swapChainDescriptor.SwapEffect = DXGI_SWAP_EFFECT::DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    swapChainDescriptor.Scaling = DXGI_SCALING::DXGI_SCALING_STRETCH;
+    swapChainDescriptor.Flags = {};
+
+    DXGI_SWAP_CHAIN_FULLSCREEN_DESC swapChainFullscreenDescriptor = {};
+    swapChainFullscreenDescriptor.Windowed = true;
+
+    if (FAILED(_dxgiFactory->CreateSwapChainForHwnd(
+            _device.Get(),
+            window,
+            &swapChainDescriptor,
+            &swapChainFullscreenDescriptor,
+            nullptr,
+            &_swapChain)))
+    {
+        std::cout << "DXGI: Failed to create SwapChain\n";
+        return false;
+    }
+
+    return CreateSwapchainResources(width, height);
+}
+
+bool D3D11RenderBackend::CreateBuffer(
+    const RenderBufferDescription& description,
+    const void* initialData,
+    std::shared_ptr<RenderBuffer>& buffer)
+{
+    D3D11_BUFFER_DESC bufferDescriptor = {};
+    bufferDescriptor.ByteWidth = description.Size;
+    bufferDescriptor.Usage = ToNative(description.Usage);
+    bufferDescriptor.BindFlags = ToNativeBindFlags(description.BindFlags);
+    bufferDescriptor.CPUAccessFlags = GetCpuAccessFlags(description.Usage);
+
+    D3D11_SUBRESOURCE_DATA subresourceData = {};
+    subresourceData.pSysMem = initialData;
+
+    WRL::ComPtr<ID3D11Buffer> nativeBuffer = nullptr;
+    if (FAILED(_device->CreateBuffer(
+            &bufferDescriptor,
+            initialData != nullptr ? &subresourceData : nullptr,
+            &nativeBuffer)))
+    {
+        return false;
+    }
+
+    buffer = std::make_shared<D3D11Buffer>(std::move(nativeBuffer), description);
+    return true;
+}
+
+bool D3D11RenderBackend::CreateTexture2D(
+    const RenderTextureDescription& description,
+    const RenderSubresourceData* initialData,
+    std::shared_ptr<RenderTexture2D>& texture)
+{
+    D3D11_TEXTURE2D_DESC textureDescriptor = {};
+    textureDescriptor.Width = description.Width;
+    textureDescriptor.Height = description.Height;
+    textureDescriptor.MipLevels = description.MipLevels;
+    textureDescriptor.ArraySize = description.ArraySize;
+    textureDescriptor.Format = ToNative(description.Format);
+    textureDescriptor.SampleDesc.Count = 1;
+    textureDescriptor.SampleDesc.Quality = 0;
+    textureDescriptor.Usage = ToNative(description.Usage);
+    textureDescriptor.BindFlags = ToNativeBindFlags(description.BindFlags);
+    textureDescriptor.CPUAccessFlags = GetCpuAccessFlags(description.Usage);
+    textureDescriptor.MiscFlags = description.IsCubemap
+                                    ? D3D11_RESOURCE_MISC_FLAG::D3D11_RESOURCE_MISC_TEXTURECUBE
+                                    : 0;
+
+    std::vector<D3D11_SUBRESOURCE_DATA> subresourceData;
+    if (initialData != nullptr)
+    {
+        subresourceData.resize(static_cast<size_t>(GetMipLevels(description)) * description.ArraySize);
+        for (size_t i = 0; i < subresourceData.size(); i++)
+        {
+            subresourceData[i].pSysMem = initialData[i].Data;
+            subresourceData[i].SysMemPitch = initialData[i].RowPitch;
+            subresourceData[i].SysMemSlicePitch = initialData[i].SlicePitch;
+        }
+    }
+
+    WRL::ComPtr<ID3D11Texture2D> nativeTexture = nullptr;
+    if (FAILED(_device->CreateTexture2D(
+            &textureDescriptor,
+            initialData != nullptr ? subresourceData.data() : nullptr,
+            &nativeTexture)))
+    {
+        return false;
+    }
+
+    texture = std::make_shared<D3D11Texture2D>(std::move(nativeTexture), description);
+    return true;
+}
+
+bool D3D11RenderBackend::CreateShaderResourceView(
+    RenderTexture2D* texture,
+    const RenderShaderResourceViewDescription& description,
+    std::shared_ptr<RenderShaderResourceView>& shaderResourceView)
+{
+    D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDescriptor = {};
+    shaderResourceViewDescriptor.Format = ToNative(description.Format);
+    switch (description.Dimension)
+    {
+    case RenderShaderResourceViewDimension::TextureCube:
+        shaderResourceViewDescriptor.ViewDimension = D3D11_SRV_DIMENSION::D3D11_SRV_DIMENSION_TEXTURECUBE;
+        shaderResourceViewDescriptor.TextureCube.MostDetailedMip = description.MostDetailedMip;
+        shaderResourceViewDescriptor.TextureCube.MipLevels = description.MipLevels;
+        break;
+    case RenderShaderResourceViewDimension::Texture2DArray:
+        shaderResourceViewDescriptor.ViewDimension = D3D11_SRV_DIMENSION::D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+        shaderResourceViewDescriptor.Texture2DArray.MostDetailedMip = description.MostDetailedMip;
+        shaderResourceViewDescriptor.Texture2DArray.MipLevels = description.MipLevels;
+        shaderResourceViewDescriptor.Texture2DArray.FirstArraySlice = description.FirstArraySlice;
+        shaderResourceViewDescriptor.Texture2DArray.ArraySize = description.ArraySize;
+        break;
+    case RenderShaderResourceViewDimension::Texture2D:
+        shaderResourceViewDescriptor.ViewDimension = D3D11_SRV_DIMENSION::D3D11_SRV_DIMENSION_TEXTURE2D;
+        shaderResourceViewDescriptor.Texture2D.MostDetailedMip = description.MostDetailedMip;
+        shaderResourceViewDescriptor.Texture2D.MipLevels = description.MipLevels;
+        break;
+    }
+
+    WRL::ComPtr<ID3D11ShaderResourceView> nativeShaderResourceView = nullptr;
+    if (FAILED(_device->CreateShaderResourceView(
+            ToNative<D3D11Texture2D>(texture),
+            &shaderResourceViewDescriptor,
+            &nativeShaderResourceView)))
+    {
+        return false;
+    }
+
+    shaderResourceView = std::make_shared<D3D11ShaderResourceView>(std::move(nativeShaderResourceView), description);
+    return true;
+}
+
+bool D3D11RenderBackend::CreateSamplerState(
+    const RenderSamplerDescription& description,
+    std::shared_ptr<RenderSamplerState>& samplerState)
+{
+    D3D11_SAMPLER_DESC samplerStateDescriptor = {};
+    samplerStateDescriptor.Filter = ToNative(description.Filter);
+    samplerStateDescriptor.AddressU = ToNative(description.AddressU);
+    samplerStateDescriptor.AddressV = ToNative(description.AddressV);
+    samplerStateDescriptor.AddressW = ToNative(description.AddressW);
+    samplerStateDescriptor.MaxAnisotropy = description.MaxAnisotropy;
+    samplerStateDescriptor.ComparisonFunc = D3D11_COMPARISON_FUNC::D3D11_COMPARISON_NEVER;
+    samplerStateDescriptor.MinLOD = description.MinLod;
+    samplerStateDescriptor.MaxLOD = description.MaxLod;
+
+    WRL::ComPtr<ID3D11SamplerState> nativeSamplerState = nullptr;
+    if (FAILED(_device->CreateSamplerState(&samplerStateDescriptor, &nativeSamplerState)))
+    {
+        return false;
+    }
+
+    samplerState = std::make_shared<D3D11SamplerState>(std::move(nativeSamplerState), description);
+    return true;
+}
+
+bool D3D11RenderBackend::CreateDepthStencilState(
+    const RenderDepthStencilDescription& description,
+    std::shared_ptr<RenderDepthStencilState>& depthStencilState)
+{
+    D3D11_DEPTH_STENCIL_DESC depthStencilDescriptor = {};
+    depthStencilDescriptor.DepthEnable = description.IsDepthEnabled;
+    depthStencilDescriptor.DepthWriteMask = description.IsDepthWriteEnabled
+                                              ? D3D11_DEPTH_WRITE_MASK::D3D11_DEPTH_WRITE_MASK_ALL
+                                              : D3D11_DEPTH_WRITE_MASK::D3D11_DEPTH_WRITE_MASK_ZERO;
+    depthStencilDescriptor.DepthFunc = ToNative(description.DepthFunction);
+    depthStencilDescriptor.StencilEnable = false;
+
+    WRL::ComPtr<ID3D11DepthStencilState> nativeDepthStencilState = nullptr;
+    if (FAILED(_device->CreateDepthStencilState(&depthStencilDescriptor, &nativeDepthStencilState)))
+    {
+        return false;
+    }
+
+    depthStencilState = std::make_shared<D3D11DepthStencilState>(std::move(nativeDepthStencilState), description);
+    return true;
+}
+
+bool D3D11RenderBackend::CreateRasterizerState(
+    const RenderRasterizerDescription& description,
+    std::shared_ptr<RenderRasterizerState>& rasterizerState)
+{
+    D3D11_RASTERIZER_DESC rasterizerStateDescriptor = {};
+    rasterizerStateDescriptor.FillMode = ToNative(description.FillMode);
+    rasterizerStateDescriptor.CullMode = ToNative(description.CullMode);
+    rasterizerStateDescriptor.FrontCounterClockwise = description.IsFrontCounterClockwise;
+    rasterizerStateDescriptor.DepthClipEnable = description.IsDepthClipEnabled;
+
+    WRL::ComPtr<ID3D11RasterizerState> nativeRasterizerState = nullptr;
+    if (FAILED(_device->CreateRasterizerState(&rasterizerStateDescriptor, &nativeRasterizerState)))
+    {
+        return false;
+    }
+
+    rasterizerState = std::make_shared<D3D11RasterizerState>(std::move(nativeRasterizerState), description);
+    return true;
+}
+
+bool D3D11RenderBackend::CreateVertexShader(
+    const void* byteCode,
+    const size_t byteCodeSize,
+    std::shared_ptr<RenderVertexShader>& vertexShader)
+{
+    WRL::ComPtr<ID3D11VertexShader> nativeVertexShader = nullptr;
+    if (FAILED(_device->CreateVertexShader(byteCode, byteCodeSize, nullptr, &nativeVertexShader)))
+    {
+        return false;
+    }
+
+    vertexShader = std::make_shared<D3D11VertexShader>(std::move(nativeVertexShader));
+    return true;
+}
+
+bool D3D11RenderBackend::CreatePixelShader(
+    const void* byteCode,
+    const size_t byteCodeSize,
+    std::shared_ptr<RenderPixelShader>& pixelShader)
+{
+    WRL::ComPtr<ID3D11PixelShader> nativePixelShader = nullptr;
+    if (FAILED(_device->CreatePixelShader(byteCode, byteCodeSize, nullptr, &nativePixelShader)))
+    {
+        return false;
+    }
+
+    pixelShader = std::make_shared<D3D11PixelShader>(std::move(nativePixelShader));
+    return true;
+}
+
+bool D3D11RenderBackend::CreateInputLayout(
+    const RenderInputElement* elements,
+    const uint32_t elementCount,
+    const void* byteCode,
+    const size_t byteCodeSize,
+    std::shared_ptr<RenderInputLayout>& inputLayout)
+{
+    std::vector<D3D11_INPUT_ELEMENT_DESC> inputElementDescriptors(elementCount);
+    for (uint32_t i = 0; i < elementCount; i++)
+    {
+        inputElementDescriptors[i].SemanticName = elements[i].SemanticName;
+        inputElementDescriptors[i].SemanticIndex = elements[i].SemanticIndex;
+        inputElementDescriptors[i].Format = ToNative(elements[i].Format);
+        inputElementDescriptors[i].InputSlot = elements[i].InputSlot;
+        inputElementDescriptors[i].AlignedByteOffset = elements[i].AlignedByteOffset;
+        inputElementDescriptors[i].InputSlotClass = D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA;
+        inputElementDescriptors[i].InstanceDataStepRate = 0;
+    }
+
+    WRL::ComPtr<ID3D11InputLayout> nativeInputLayout = nullptr;
+    if (FAILED(_device->CreateInputLayout(
+            inputElementDescriptors.data(),
+            elementCount,
+            byteCode,
+            byteCodeSize,
+            &nativeInputLayout)))
+    {
+        return false;
+    }
+
+    inputLayout = std::make_shared<D3D11InputLayout>(std::move(nativeInputLayout));
+    return true;
+}
+
+bool D3D11RenderBackend::CompileShader(
+    const std::wstring& filePath,
+    const std::string& entryPoint,
+    const std::string& profile,
+    std::vector<uint8_t>& byteCode)
+{
+    constexpr uint32_t compileFlags = D3DCOMPILE_ENABLE_STRICTNESS;
+    WRL::ComPtr<ID3DBlob> shaderBlob = nullptr;
+    if (!_shaderCache.CompileShader(filePath, entryPoint, profile, compileFlags, shaderBlob))
+    {
+        return false;
+    }
+
+    const uint8_t* shaderBytes = static_cast<const uint8_t*>(shaderBlob->GetBufferPointer());
+    byteCode.assign(shaderBytes, shaderBytes + shaderBlob->GetBufferSize());
+    return true;
+}
+
+void D3D11RenderBackend::PrintShaderStatistics() const
+{
+    _shaderCache.PrintStatistics();
+}
+
+void D3D11RenderBackend::ClearRenderTargetView(
+    RenderTargetView* renderTarget,
+    const float clearColor[4])
+{
+    _deviceContext->ClearRenderTargetView(ToNative<D3D11RenderTargetView>(renderTarget), clearColor);
+}
+
+void D3D11RenderBackend::ClearDepthStencilView(
+    RenderDepthStencilView* depthStencilView,
+    const uint32_t clearFlags,
+    const float clearDepth,
+    const uint8_t clearStencil)
+{
+    _deviceContext->ClearDepthStencilView(
+        ToNative<D3D11DepthStencilView>(depthStencilView),
+        ToNativeClearFlags(clearFlags),
+        clearDepth,
+        clearStencil);
+}
+
+void D3D11RenderBackend::OMSetRenderTargets(
+    const uint32_t renderTargetCount,
+    RenderTargetView* const* renderTargets,
+    RenderDepthStencilView* depthStencilView)
+{
+    std::array<ID3D11RenderTargetView*, D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT> nativeRenderTargets = {};
+    ToNativeArray<D3D11RenderTargetView>(renderTargets, renderTargetCount, nativeRenderTargets);
+    _deviceContext->OMSetRenderTargets(
+        renderTargetCount,
+        nativeRenderTargets.data(),
+        ToNative<D3D11DepthStencilView>(depthStencilView));
+}
+
+void D3D11RenderBackend::IASetInputLayout(RenderInputLayout* inputLayout)
+{
+    _deviceContext->IASetInputLayout(ToNative<D3D11InputLayout>(inputLayout));
+}
+
+void D3D11RenderBackend::IASetPrimitiveTopology(const RenderPrimitiveTopology primitiveTopology)
+{
+    _deviceContext->IASetPrimitiveTopology(ToNative(primitiveTopology));
+}
+
+void D3D11RenderBackend::IASetVertexBuffers(
+    const uint32_t startSlot,
+    const uint32_t bufferCount,
+    RenderBuffer* const* vertexBuffers,
+    const uint32_t* strides,
+    const uint32_t* offsets)
+{
+    std::array<ID3D11Buffer*, D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT> nativeVertexBuffers = {};
+    ToNativeArray<D3D11Buffer>(vertexBuffers, bufferCount, nativeVertexBuffers);
+    _deviceContext->IASetVertexBuffers(startSlot, bufferCount, nativeVertexBuffers.data(), strides, offsets);
+}
+
+void D3D11RenderBackend::IASetIndexBuffer(
+    RenderBuffer* indexBuffer,
+    const RenderFormat format,
+    const uint32_t offset)
+{
+    _deviceContext->IASetIndexBuffer(ToNative<D3D11Buffer>(indexBuffer), ToNative(format), offset);
+}
+
+void D3D11RenderBackend::VSSetShader(RenderVertexShader* vertexShader)
+{
+    _deviceContext->VSSetShader(ToNative<D3D11VertexShader>(vertexShader), nullptr, 0);
+}
+
+void D3D11RenderBackend::PSSetShader(RenderPixelShader* pixelShader)
+{
+    _deviceContext->PSSetShader(ToNative<D3D11PixelShader>(pixelShader), nullptr, 0);
+}
+
+void D3D11RenderBackend::VSSetConstantBuffers(
+    const uint32_t startSlot,
+    const uint32_t bufferCount,
+    RenderBuffer* const* constantBuffers)
+{
+    std::array<ID3D11Buffer*, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT> nativeConstantBuffers = {};
+    ToNativeArray<D3D11Buffer>(constantBuffers, bufferCount, nativeConstantBuffers);
+    _deviceContext->VSSetConstantBuffers(startSlot, bufferCount, nativeConstantBuffers.data());
+}
+
+void D3D11RenderBackend::PSSetConstantBuffers(
+    const uint32_t startSlot,
+    const uint32_t bufferCount,
+    RenderBuffer* const* constantBuffers)
+{
+    std::array<ID3D11Buffer*, D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT> nativeConstantBuffers = {};
+    ToNativeArray<D3D11Buffer>(constantBuffers, bufferCount, nativeConstantBuffers);
+    _deviceContext->PSSetConstantBuffers(startSlot, bufferCount, nativeConstantBuffers.data());
+}
+
+void D3D11RenderBackend::PSSetShaderResources(
+    const uint32_t startSlot,
+    const uint32_t viewCount,
+    RenderShaderResourceView* const* shaderResourceViews)
+{
+    std::array<ID3D11ShaderResourceView*, D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT> nativeShaderResourceViews = {};
+    ToNativeArray<D3D11ShaderResourceView>(shaderResourceViews, viewCount, nativeShaderResourceViews);
+    _deviceContext->PSSetShaderResources(startSlot, viewCount, nativeShaderResourceViews.data());
+}
+
+void D3D11RenderBackend::PSSetSamplers(
+    const uint32_t startSlot,
+    const uint32_t samplerCount,
+    RenderSamplerState* const* samplers)
+{
+    std::array<ID3D11SamplerState*, D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT> nativeSamplers = {};
+    ToNativeArray<D3D11SamplerState>(samplers, samplerCount, nativeSamplers);
+    _deviceContext->PSSetSamplers(startSlot, samplerCount, nativeSamplers.data());
+}
+
+void D3D11RenderBackend::OMSetDepthStencilState(
+    RenderDepthStencilState* depthStencilState,
+    const uint32_t stencilReference)
+{
+    _deviceContext->OMSetDepthStencilState(ToNative<D3D11DepthStencilState>(depthStencilState), stencilReference);
+}
+
+void D3D11RenderBackend::RSSetViewports(
+    const uint32_t viewportCount,
+    const RenderViewport* viewports)
+{
+    std::array<D3D11_VIEWPORT, D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE> nativeViewports = {};
+    for (uint32_t i = 0; i < viewportCount; i++)
+    {
+        nativeViewports[i].TopLeftX = viewports[i].Left;
+        nativeViewports[i].TopLeftY = viewports[i].Top;
+        nativeViewports[i].Width = viewports[i].Width;
+        nativeViewports[i].Height = viewports[i].Height;
+        nativeViewports[i].MinDepth = viewports[i].MinDepth;
+        nativeViewports[i].MaxDepth = viewports[i].MaxDepth;
+    }
+
+    _deviceContext->RSSetViewports(viewportCount, nativeViewports.data());
+}
+
+void D3D11RenderBackend::RSSetState(RenderRasterizerState* rasterizerState)
+{
+    _deviceContext->RSSetState(ToNative<D3D11RasterizerState>(rasterizerState));
+}
+
+void D3D11RenderBackend::UpdateSubresource(
+    RenderResource* resource,
+    const uint32_t subresource,
+    const RenderBox* box,
+    const void* data,
+    const uint32_t rowPitch,
+    const uint32_t depthPitch)
+{
+    const D3D11_BOX nativeBox = box != nullptr ? ToNative(*box) : D3D11_BOX{};
+    _deviceContext->UpdateSubresource(
+        ToNativeResource(resource),
+        subresource,
+        box != nullptr ? &nativeBox : nullptr,
+        data,
+        rowPitch,
+        depthPitch);
+}
+
+void D3D11RenderBackend::CopySubresourceRegion(
+    RenderResource* destinationResource,
+    const uint32_t destinationSubresource,
+    const uint32_t destinationX,
+    const uint32_t destinationY,
+    const uint32_t destinationZ,
+    RenderResource* sourceResource,
+    const uint32_t sourceSubresource,
+    const RenderBox* sourceBox)
+{
+    const D3D11_BOX nativeSourceBox = sourceBox != nullptr ? ToNative(*sourceBox) : D3D11_BOX{};
+    _deviceContext->CopySubresourceRegion(
+        ToNativeResource(destinationResource),
+        destinationSubresource,
+        destinationX,
+        destinationY,
+        destinationZ,
+        ToNativeResource(sourceResource),
+        sourceSubresource,
+        sourceBox != nullptr ? &nativeSourceBox : nullptr);
+}
+
+bool D3D11RenderBackend::Map(
+    RenderResource* resource,
+    const uint32_t subresource,
+    const RenderMapType mapType,
+    RenderMappedSubresource* mappedSubresource)
+{
+    D3D11_MAPPED_SUBRESOURCE nativeMappedSubresource = {};
+    if (FAILED(_deviceContext->Map(ToNativeResource(resource), subresource, ToNative(mapType), 0, &nativeMappedSubresource)))
+    {
+        return false;
+    }
+
+    mappedSubresource->Data = nativeMappedSubresource.pData;
+    mappedSubresource->RowPitch = nativeMappedSubresource.RowPitch;
+    mappedSubresource->DepthPitch = nativeMappedSubresource.DepthPitch;
+    return true;
+}
+
+void D3D11RenderBackend::Unmap(
+    RenderResource* resource,
+    const uint32_t subresource)
+{
+    _deviceContext->Unmap(ToNativeResource(resource), subresource);
+}
+
+void D3D11RenderBackend::Draw(
+    const uint32_t vertexCount,
+    const uint32_t startVertex)
+{
+    _deviceContext->Draw(vertexCount, startVertex);
+}
+
+void D3D11RenderBackend::DrawIndexed(
+    const uint32_t indexCount,
+    const uint32_t startIndex,
+    const int32_t baseVertex)
+{
+    _deviceContext->DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void D3D11RenderBackend::Flush()
+{
+    _deviceContext->Flush();
+}
+
+RenderTargetView* D3D11RenderBackend::GetBackBufferRenderTarget() const
+{
+    return _backBufferRenderTarget.get();
+}
+
+RenderDepthStencilView* D3D11RenderBackend::GetBackBufferDepthStencil() const
+{
+    return _backBufferDepthStencil.get();
+}
+
+bool D3D11RenderBackend::ResizeBackBuffer(
+    const uint32_t width,
+    const uint32_t height)
+{
+    // The swap chain's buffers can only be resized once nothing refers to them anymore, bound views included
+    _deviceContext->OMSetRenderTargets(0, nullptr, nullptr);
+    DestroySwapchainResources();
+
+    if (FAILED(_swapChain->ResizeBuffers(
+            0,
+            width,
+            height,
+            DXGI_FORMAT::DXGI_FORMAT_B8G8R8A8_UNORM,
+            0)))
+    {
+        std::cout << "D3D11: Failed to recreate swapchain buffers\n";
+        return false;
+    }
+
+    return CreateSwapchainResources(width, height);
+}
+
+void D3D11RenderBackend::Present()
+{
+    _swapChain->Present(1, 0);
+}
+
+void D3D11RenderBackend::NewUiFrame()
+{
+    ImGui_ImplDX11_NewFrame();
+}
+
+void D3D11RenderBackend::RenderUiDrawData()
+{
+    ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+}
+
+bool D3D11RenderBackend::CreateSwapchainResources(
+    const uint32_t width,
+    const uint32_t height)
+{
+    WRL::ComPtr<ID3D11Texture2D> backBuffer = nullptr;
+    if (FAILED(_swapChain->GetBuffer(
+            0,
+            IID_PPV_ARGS(&backBuffer))))
+    {
+        std::cout << "D3D11: Failed to get back buffer from swapchain\n";
+        return false;
+    }
+
+    WRL::ComPtr<ID3D11RenderTargetView> renderTarget = nullptr;
+    if (FAILED(_device->CreateRenderTargetView(
+            backBuffer.Get(),
+            nullptr,
+            &renderTarget)))
+    {
+        std::cout << "D3D11: Failed to create rendertarget view from back buffer\n";
+        return false;
+    }
+
+    WRL::ComPtr<ID3D11Texture2D> depthBuffer = nullptr;
+
+    D3D11_TEXTURE2D_DESC depthStencilBufferDescriptor = {};
+    depthStencilBufferDescriptor.ArraySize = 1;
+    depthStencilBufferDescriptor.BindFlags = D3D11_BIND_FLAG::D3D11_BIND_DEPTH_STENCIL;
+    depthStencilBufferDescriptor.CPUAccessFlags = 0;
+    depthStencilBufferDescriptor.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    depthStencilBufferDescriptor.Width = width;
+    depthStencilBufferDescriptor.Height = height;
+    depthStencilBufferDescriptor.MipLevels = 1;
+    depthStencilBufferDescriptor.SampleDesc.Count = 1;
+    depthStencilBufferDescriptor.SampleDesc.Quality = 0;
+    depthStencilBufferDescriptor.Usage = D3D11_USAGE::D3D11_USAGE_DEFAULT;
+    if (FAILED(_device->CreateTexture2D(
+            &depthStencilBufferDescriptor,
+            nullptr,
+            &depthBuffer)))
+    {
+        std::cout << "D3D11: Failed to create depth buffer\n";
+        return false;
+    }
+
+    WRL::ComPtr<ID3D11DepthStencilView> depthStencilView = nullptr;
+    if (FAILED(_device->CreateDepthStencilView(
+            depthBuffer.Get(),
+            nullptr,
+            &depthStencilView)))
+    {
+        std::cout << "D3D11: Failed to create shaderresource view from back buffer\n";
+        return false;
+    }
+
+    _backBufferRenderTarget = std::make_shared<D3D11RenderTargetView>(std::move(renderTarget));
+    _backBufferDepthStencil = std::make_shared<D3D11DepthStencilView>(std::move(depthStencilView));
+    return true;
+}
+
+void D3D11RenderBackend::DestroySwapchainResources()
+{
+    _backBufferDepthStencil.reset();
+    _backBufferRenderTarget.reset();
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Definitions.hpp"
+#include "RenderBackend.hpp"
+
+#include <ShaderCache.hpp>
+
+#include <d3d11_2.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Owns the device, the swap chain of the window and the ImGui renderer. Every object it creates
+// wraps its native D3D11 object, the calls translate the neutral types and forward to the
+// immediate context. Shaders go through the shader cache.
+class D3D11RenderBackend final : public RenderBackend
+{
+public:
+    ~D3D11RenderBackend() override;
+
+    // ImGui's context has to exist already, its D3D11 renderer is initialized here
+    bool Initialize(
+        HWND window,
+        uint32_t width,
+        uint32_t height);
+
+    bool CreateBuffer(
+        const RenderBufferDescription& description,
+        const void* initialData,
+        std::shared_ptr<RenderBuffer>& buffer) override;
+    bool CreateTexture2D(
+        const RenderTextureDescription& description,
+        const RenderSubresourceData* initialData,
+        std::shared_ptr<RenderTexture2D>& texture) override;
+    bool CreateShaderResourceView(
+        RenderTexture2D* texture,
+        const RenderShaderResourceViewDescription& description,
+        std::shared_ptr<RenderShaderResourceView>& shaderResourceView) override;
+    bool CreateSamplerState(
+        const RenderSamplerDescription& description,
+        std::shared_ptr<RenderSamplerState>& samplerState) override;
+    bool CreateDepthStencilState(
+        const RenderDepthStencilDescription& description,
+        std::shared_ptr<RenderDepthStencilState>& depthStencilState) override;
+    bool CreateRasterizerState(
+        const RenderRasterizerDescription& description,
+        std::shared_ptr<RenderRasterizerState>& rasterizerState) override;
+    bool CreateVertexShader(
+        const void* byteCode,
+        size_t byteCodeSize,
+        std::shared_ptr<RenderVertexShader>& vertexShader) override;
+    bool CreatePixelShader(
+        const void* byteCode,
+        size_t byteCodeSize,
+        std::shared_ptr<RenderPixelShader>& pixelShader) override;
+    bool CreateInputLayout(
+        const RenderInputElement* elements,
+        uint32_t elementCount,
+        const void* byteCode,
+        size_t byteCodeSize,
+        std::shared_ptr<RenderInputLayout>& inputLayout) override;
+
+    bool CompileShader(
+        const std::wstring& filePath,
+        const std::string& entryPoint,
+        const std::string& profile,
+        std::vector<uint8_t>& byteCode) override;
+    void PrintShaderStatistics() const override;
+
+    void ClearRenderTargetView(
+        RenderTargetView* renderTarget,
+        const float clearColor[4]) override;
+    void ClearDepthStencilView(
+        RenderDepthStencilView* depthStencilView,
+        uint32_t clearFlags,
+        float clearDepth,
+        uint8_t clearStencil) override;
+    void OMSetRenderTargets(
+        uint32_t renderTargetCount,
+        RenderTargetView* const* renderTargets,
+        RenderDepthStencilView* depthStencilView) override;
+    void IASetInputLayout(RenderInputLayout* inputLayout) override;
+    void IASetPrimitiveTopology(RenderPrimitiveTopology primitiveTopology) override;
+    void IASetVertexBuffers(
+        uint32_t startSlot,
+        uint32_t bufferCount,
+        RenderBuffer* const* vertexBuffers,
+        const uint32_t* strides,
+        const uint32_t* offsets) override;
+    void IASetIndexBuffer(
+        RenderBuffer* indexBuffer,
+        RenderFormat format,
+        uint32_t offset) override;
+    void VSSetShader(RenderVertexShader* vertexShader) override;
+    void PSSetShader(RenderPixelShader* pixelShader) override;
+    void VSSetConstantBuffers(
+        uint32_t startSlot,
+        uint32_t bufferCount,
+        RenderBuffer* const* constantBuffers) override;
+    void PSSetConstantBuffers(
+        uint32_t startSlot,
+        uint32_t bufferCount,
+        RenderBuffer* const* constantBuffers) override;
+    void PSSetShaderResources(
+        uint32_t startSlot,
+        uint32_t viewCount,
+        RenderShaderResourceView* const* shaderResourceViews) override;
+    void PSSetSamplers(
+        uint32_t startSlot,
+        uint32_t samplerCount,
+        RenderSamplerState* const* samplers) override;
+    void OMSetDepthStencilState(
+        RenderDepthStencilState* depthStencilState,
+        uint32_t stencilReference) override;
+    void RSSetViewports(
+        uint32_t viewportCount,
+        const RenderViewport* viewports) override;
+    void RSSetState(RenderRasterizerState* rasterizerState) override;
+    void UpdateSubresource(
+        RenderResource* resource,
+        uint32_t subresource,
+        const RenderBox* box,
+        const void* data,
+        uint32_t rowPitch,
+        uint32_t depthPitch) override;
+    void CopySubresourceRegion(
+        RenderResource* destinationResource,
+        uint32_t destinationSubresource,
+        uint32_t destinationX,
+        uint32_t destinationY,
+        uint32_t destinationZ,
+        RenderResource* sourceResource,
+        uint32_t sourceSubresource,
+        const RenderBox* sourceBox) override;
+    bool Map(
+        RenderResource* resource,
+        uint32_t subresource,
+        RenderMapType mapType,
+        RenderMappedSubresource* mappedSubresource) override;
+    void Unmap(
+        RenderResource* resource,
+        uint32_t subresource) override;
+    void Draw(
+        uint32_t vertexCount,
+        uint32_t startVertex) override;
+    void DrawIndexed(
+        uint32_t indexCount,
+        uint32_t startIndex,
+        int32_t baseVertex) override;
+    void Flush() override;
+
+    [[nodiscard]] RenderTargetView* GetBackBufferRenderTarget() const override;
+    [[nodiscard]] RenderDepthStencilView* GetBackBufferDepthStencil() const override;
+    bool ResizeBackBuffer(
+        uint32_t width,
+        uint32_t height) override;
+    void Present() override;
+
+    void NewUiFrame() override;
+    void RenderUiDrawData() override;
+
+private:
+    bool CreateSwapchainResources(
+        uint32_t width,
+        uint32_t height);
+    void DestroySwapchainResources();
+
+    WRL::ComPtr<ID3D11Device> _device = nullptr;
+    WRL::ComPtr<ID3D11DeviceContext> _deviceContext = nullptr;
+    WRL::ComPtr<IDXGIFactory2> _dxgiFactory = nullptr;
+    WRL::ComPtr<IDXGISwapChain1> _swapChain = nullptr;
+    WRL::ComPtr<ID3D11Debug> _debug = nullptr;
+    std::shared_ptr<RenderTargetView> _backBufferRenderTarget = nullptr;
+    std::shared_ptr<RenderDepthStencilView> _backBufferDepthStencil = nullptr;
+    ShaderCache _shaderCache{ "ShaderCache" };
+    bool _isImGuiInitialized = false;
+};
@@ -0,0 +1,290 @@
+#include "DdsReader.hpp"
+
+#include <DirectXTex.h>
+
+#include <cstring>
+
+namespace
+{
+constexpr uint32_t MakeFourCC(
+    const char a,
+    const char b,
+    const char c,
+    const char d)
+{
+    return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+
+constexpr uint32_t DdsMagic = MakeFourCC('D', 'D', 'S', ' ');
+constexpr uint32_t DdsFlagMipMapCount = 0x20000;
+constexpr uint32_t DdsFlagDepth = 0x800000;
+constexpr uint32_t DdsPixelFormatFourCC = 0x4;
+constexpr uint32_t DdsPixelFormatRgb = 0x40;
+constexpr uint32_t DdsCaps2Cubemap = 0x200;
+constexpr uint32_t DdsCaps2CubemapAllFaces = 0xFC00;
+constexpr uint32_t DdsCaps2Volume = 0x200000;
+constexpr uint32_t DdsDx10ResourceDimensionTexture2D = 3;
+constexpr uint32_t DdsDx10MiscTextureCube = 0x4;
+
+struct DdsPixelFormat
+{
+    uint32_t Size;
+    uint32_t Flags;
+    uint32_t FourCC;
+    uint32_t RgbBitCount;
+    uint32_t RBitMask;
+    uint32_t GBitMask;
+    uint32_t BBitMask;
+    uint32_t ABitMask;
+};
+
+struct DdsHeader
+{
+    uint32_t Size;
+    uint32_t Flags;
+    uint32_t Height;
+    uint32_t Width;
+    uint32_t PitchOrLinearSize;
+    uint32_t Depth;
+    uint32_t MipMapCount;
+    uint32_t Reserved1[11];
+    DdsPixelFormat PixelFormat;
+    uint32_t Caps;
+    uint32_t Caps2;
+    uint32_t Caps3;
+    uint32_t Caps4;
+    uint32_t Reserved2;
+};
+
+struct DdsHeaderDx10
+{
+    uint32_t Format;
+    uint32_t ResourceDimension;
+    uint32_t MiscFlag;
+    uint32_t ArraySize;
+    uint32_t MiscFlags2;
+};
+
+static_assert(sizeof(DdsPixelFormat) == 32, "DDS pixel format must match the file layout");
+static_assert(sizeof(DdsHeader) == 124, "DDS header must match the file layout");
+static_assert(sizeof(DdsHeaderDx10) == 20, "DDS DX10 header must match the file layout");
+
+bool HasMasks(
+    const DdsPixelFormat& pixelFormat,
+    const uint32_t rBitMask,
+    const uint32_t gBitMask,
+    const uint32_t bBitMask,
+    const uint32_t aBitMask)
+{
+    return pixelFormat.RBitMask == rBitMask &&
+           pixelFormat.GBitMask == gBitMask &&
+           pixelFormat.BBitMask == bBitMask &&
+           pixelFormat.ABitMask == aBitMask;
+}
+
+// Only the legacy formats whose pixels are laid out exactly like a DXGI format, everything else needs converting
+DXGI_FORMAT GetLegacyFormat(const DdsPixelFormat& pixelFormat)
+{
+    if ((pixelFormat.Flags & DdsPixelFormatFourCC) != 0)
+    {
+        switch (pixelFormat.FourCC)
+        {
+        case MakeFourCC('D', 'X', 'T', '1'):
+            return DXGI_FORMAT::DXGI_FORMAT_BC1_UNORM;
+        case MakeFourCC('D', 'X', 'T', '2'):
+        case MakeFourCC('D', 'X', 'T', '3'):
+            return DXGI_FORMAT::DXGI_FORMAT_BC2_UNORM;
+        case MakeFourCC('D', 'X', 'T', '4'):
+        case MakeFourCC('D', 'X', 'T', '5'):
+            return DXGI_FORMAT::DXGI_FORMAT_BC3_UNORM;
+        case MakeFourCC('A', 'T', 'I', '1'):
+        case MakeFourCC('B', 'C', '4', 'U'):
+            return DXGI_FORMAT::DXGI_FORMAT_BC4_UNORM;
+        case MakeFourCC('B', 'C', '4', 'S'):
+            return DXGI_FORMAT::DXGI_FORMAT_BC4_SNORM;
+        case MakeFourCC('A', 'T', 'I', '2'):
+        case MakeFourCC('B', 'C', '5', 'U'):
+            return DXGI_FORMAT::DXGI_FORMAT_BC5_UNORM;
+        case MakeFourCC('B', 'C', '5', 'S'):
+            return DXGI_FORMAT::DXGI_FORMAT_BC5_SNORM;
+        // D3DFORMAT values stored as FourCC
+        case 36:
+            return DXGI_FORMAT::DXGI_FORMAT_R16G16B16A16_UNORM;
+        case 110:
+            return DXGI_FORMAT::DXGI_FORMAT_R16G16B16A16_SNORM;
+        case 111:
+            return DXGI_FORMAT::DXGI_FORMAT_R16_FLOAT;
+        case 112:
+            return DXGI_FORMAT::DXGI_FORMAT_R16G16_FLOAT;
+        case 113:
+            return DXGI_FORMAT::DXGI_FORMAT_R16G16B16A16_FLOAT;
+        case 114:
+            return DXGI_FORMAT::DXGI_FORMAT_R32_FLOAT;
+        case 115:
+            return DXGI_FORMAT::DXGI_FORMAT_R32G32_FLOAT;
+        case 116:
+            return DXGI_FORMAT::DXGI_FORMAT_R32G32B32A32_FLOAT;
+        default:
+            return DXGI_FORMAT::DXGI_FORMAT_UNKNOWN;
+        }
+    }
+
+    if ((pixelFormat.Flags & DdsPixelFormatRgb) != 0 && pixelFormat.RgbBitCount == 32)
+    {
+        if (HasMasks(pixelFormat, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000))
+        {
+            return DXGI_FORMAT::DXGI_FORMAT_R8G8B8A8_UNORM;
+        }
+
+        if (HasMasks(pixelFormat, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000))
+        {
+            return DXGI_FORMAT::DXGI_FORMAT_B8G8R8A8_UNORM;
+        }
+
+        if (HasMasks(pixelFormat, 0x00FF0000, 0x0000FF00, 0x000000FF, 0x00000000))
+        {
+            return DXGI_FORMAT::DXGI_FORMAT_B8G8R8X8_UNORM;
+        }
+
+        if (HasMasks(pixelFormat, 0x0000FFFF, 0xFFFF0000, 0x00000000, 0x00000000))
+        {
+            return DXGI_FORMAT::DXGI_FORMAT_R16G16_UNORM;
+        }
+    }
+
+    return DXGI_FORMAT::DXGI_FORMAT_UNKNOWN;
+}
+} // namespace
+
+bool ReadDdsTexture(
+    const uint8_t* data,
+    const size_t size,
+    DdsTexture& texture)
+{
+    uint32_t magic = 0;
+    DdsHeader header = {};
+    if (data == nullptr || size < sizeof(magic) + sizeof(DdsHeader))
+    {
+        return false;
+    }
+
+    // Copied out, the mapping gives no alignment guarantees past the start of the file
+    std::memcpy(&magic, data, sizeof(magic));
+    std::memcpy(&header, data + sizeof(magic), sizeof(DdsHeader));
+    if (magic != DdsMagic || header.Size != sizeof(DdsHeader) || header.PixelFormat.Size != sizeof(DdsPixelFormat))
+    {
+        return false;
+    }
+
+    size_t offset = sizeof(magic) + sizeof(DdsHeader);
+    texture = {};
+    texture.Width = header.Width;
+    texture.Height = header.Height;
+    texture.MipLevels = (header.Flags & DdsFlagMipMapCount) != 0 && header.MipMapCount > 0 ? header.MipMapCount : 1;
+    texture.ArraySize = 1;
+    DXGI_FORMAT format = DXGI_FORMAT::DXGI_FORMAT_UNKNOWN;
+    if ((header.PixelFormat.Flags & DdsPixelFormatFourCC) != 0 && header.PixelFormat.FourCC == MakeFourCC('D', 'X', '1', '0'))
+    {
+        DdsHeaderDx10 headerDx10 = {};
+        if (size < offset + sizeof(DdsHeaderDx10))
+        {
+            return false;
+        }
+
+        std::memcpy(&headerDx10, data + offset, sizeof(DdsHeaderDx10));
+        offset += sizeof(DdsHeaderDx10);
+        if (headerDx10.ResourceDimension != DdsDx10ResourceDimensionTexture2D || headerDx10.ArraySize == 0)
+        {
+            return false;
+        }
+
+        // Checked before the cube faces are multiplied in, so a damaged count cannot wrap around
+        format = static_cast<DXGI_FORMAT>(headerDx10.Format);
+        texture.IsCubemap = (headerDx10.MiscFlag & DdsDx10MiscTextureCube) != 0;
+        const uint32_t faceCount = texture.IsCubemap ? 6 : 1;
+        if (headerDx10.ArraySize > RenderMaxTextureArraySize / faceCount)
+        {
+            return false;
+        }
+
+        texture.ArraySize = headerDx10.ArraySize * faceCount;
+    }
+    else
+    {
+        if ((header.Flags & DdsFlagDepth) != 0 || (header.Caps2 & DdsCaps2Volume) != 0)
+        {
+            return false;
+        }
+
+        format = GetLegacyFormat(header.PixelFormat);
+        if ((header.Caps2 & DdsCaps2Cubemap) != 0)
+        {
+            if ((header.Caps2 & DdsCaps2CubemapAllFaces) != DdsCaps2CubemapAllFaces)
+            {
+                return false;
+            }
+
+            texture.IsCubemap = true;
+            texture.ArraySize = 6;
+        }
+    }
+
+    if (texture.Width == 0 ||
+        texture.Height == 0 ||
+        texture.Width > RenderMaxTextureDimension ||
+        texture.Height > RenderMaxTextureDimension ||
+        texture.MipLevels > GetFullMipLevelCount(texture.Width, texture.Height) ||
+        format == DXGI_FORMAT::DXGI_FORMAT_UNKNOWN ||
+        DirectX::BitsPerPixel(format) == 0 ||
+        DirectX::IsPlanar(format) ||
+        DirectX::IsPalettized(format))
+    {
+        return false;
+    }
+
+    texture.Format = static_cast<RenderFormat>(format);
+
+    // Every item has the same mip chain, so the size of the file is checked once up front and
+    // nothing is allocated for counts a damaged or hostile header made up
+    std::vector<RenderSubresourceData> mipChain(texture.MipLevels);
+    uint64_t mipChainBytes = 0;
+    uint32_t width = texture.Width;
+    uint32_t height = texture.Height;
+    for (RenderSubresourceData& mip : mipChain)
+    {
+        size_t rowPitch = 0;
+        size_t slicePitch = 0;
+        DirectX::ComputePitch(format, width, height, rowPitch, slicePitch);
+        if (slicePitch > UINT32_MAX)
+        {
+            return false;
+        }
+
+        mip.RowPitch = static_cast<uint32_t>(rowPitch);
+        mip.SlicePitch = static_cast<uint32_t>(slicePitch);
+        mipChainBytes += slicePitch;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+
+    const uint64_t pixelBytes = mipChainBytes * texture.ArraySize;
+    if (pixelBytes > size - offset)
+    {
+        return false;
+    }
+
+    // Items follow each other with their full mip chains, the same order D3D11 numbers subresources in
+    texture.Subresources.reserve(static_cast<size_t>(texture.ArraySize) * texture.MipLevels);
+    for (uint32_t item = 0; item < texture.ArraySize; item++)
+    {
+        for (RenderSubresourceData mip : mipChain)
+        {
+            mip.Data = data + offset;
+            offset += mip.SlicePitch;
+            texture.Subresources.push_back(mip);
+        }
+    }
+
+    texture.PixelBytes = pixelBytes;
+    return true;
+}
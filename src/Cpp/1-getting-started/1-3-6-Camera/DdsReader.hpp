@@ -0,0 +1,31 @@
+#pragma once
+
+#include "RenderTypes.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A 2D texture, texture array or cube map as laid out in a DDS file. Subresources are in the
+// order the backends expect them and point into the file's memory, nothing is copied.
+struct DdsTexture
+{
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t MipLevels = 0;
+    uint32_t ArraySize = 0;
+    RenderFormat Format = RenderFormat::Unknown;
+    bool IsCubemap = false;
+    std::vector<RenderSubresourceData> Subresources;
+    uint64_t PixelBytes = 0;
+};
+
+// Parses the DDS header and its DX10 extension in place. Fails for files which cannot be used
+// as they are: legacy formats without a DXGI equivalent, volume textures, partial cube maps or
+// files too small for their header. DirectX::LoadFromDDSMemory converts those instead. Headers
+// whose size, array size or mip count is past the limits of D3D11, or whose pixels do not fit
+// into the file, fail as well.
+bool ReadDdsTexture(
+    const uint8_t* data,
+    size_t size,
+    DdsTexture& texture);
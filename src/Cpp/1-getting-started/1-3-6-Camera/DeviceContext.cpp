@@ -1,113 +1,160 @@
 #include "DeviceContext.hpp"
 #include "Pipeline.hpp"
+#include "RenderBackend.hpp"
 
-#include <imgui/backend/imgui_impl_dx11.h>
-#include <utility>
+#include <cstring>
 
-DeviceContext::DeviceContext(
-    const WRL::ComPtr<ID3D11Device>& device,
-    WRL::ComPtr<ID3D11DeviceContext>&& deviceContext)
+DeviceContext::DeviceContext(const std::shared_ptr<RenderBackend>& renderBackend)
 {
-    _deviceContext = std::move(deviceContext);
+    _renderBackend = renderBackend;
     _activePipeline = nullptr;
     _drawVertices = 0;
     _drawIndices = 0;
-    ImGui_ImplDX11_Init(device.Get(), _deviceContext.Get());
 }
 
-DeviceContext::~DeviceContext()
+void DeviceContext::BeginFrame()
 {
-    ImGui_ImplDX11_Shutdown();
+    _lastFrameStatistics = _currentFrameStatistics;
+    _currentFrameStatistics = {};
 }
 
 void DeviceContext::Clear(
-    ID3D11RenderTargetView* renderTarget,
+    RenderTargetView* renderTarget,
     float clearColor[4],
-    ID3D11DepthStencilView* depthStencilView,
+    RenderDepthStencilView* depthStencilView,
     float clearDepth) const
 {
-    _deviceContext->ClearRenderTargetView(
+    _renderBackend->ClearRenderTargetView(
         renderTarget,
         clearColor);
     if (depthStencilView != nullptr)
     {
-        _deviceContext->ClearDepthStencilView(
+        _renderBackend->ClearDepthStencilView(
             depthStencilView,
-            D3D11_CLEAR_FLAG::D3D11_CLEAR_DEPTH,
+            RenderClearFlags::RenderClearDepth,
             clearDepth,
             0);
     }
-    _deviceContext->OMSetRenderTargets(1, &renderTarget, depthStencilView);
+    _renderBackend->OMSetRenderTargets(1, &renderTarget, depthStencilView);
 }
 
 void DeviceContext::SetPipeline(const Pipeline* pipeline)
 {
     _activePipeline = pipeline;
-    _deviceContext->IASetInputLayout(pipeline->_inputLayout.Get());
-    _deviceContext->IASetPrimitiveTopology(pipeline->_primitiveTopology);
-    _deviceContext->VSSetShader(pipeline->_vertexShader.Get(), nullptr, 0);
-    _deviceContext->PSSetShader(pipeline->_pixelShader.Get(), nullptr, 0);
+    if (ChangeState(_boundInputLayout, pipeline->_inputLayout))
+    {
+        _renderBackend->IASetInputLayout(_boundInputLayout.get());
+    }
+    if (ChangeState(_boundPrimitiveTopology, pipeline->_primitiveTopology))
+    {
+        _renderBackend->IASetPrimitiveTopology(_boundPrimitiveTopology);
+    }
+    if (ChangeState(_boundVertexShader, pipeline->_vertexShader))
+    {
+        _renderBackend->VSSetShader(_boundVertexShader.get());
+    }
+    if (ChangeState(_boundPixelShader, pipeline->_pixelShader))
+    {
+        _renderBackend->PSSetShader(_boundPixelShader.get());
+    }
 
-    for (auto [descriptor, resource] : pipeline->_resources)
+    uint32_t startSlot = 0;
+    uint32_t slotCount = 0;
+    if (ChangeSlots(_boundPixelSamplers, pipeline->_pixelSamplers, startSlot, slotCount))
     {
-        switch (descriptor.Type)
-        {
-        case ResourceType::Sampler:
-            _deviceContext->PSSetSamplers(descriptor.SlotIndex, 1, reinterpret_cast<ID3D11SamplerState**>(&resource));
-            break;
+        _renderBackend->PSSetSamplers(startSlot, slotCount, &_boundPixelSamplers.Resources[startSlot]);
+    }
+    if (ChangeSlots(_boundPixelShaderResources, pipeline->_pixelShaderResources, startSlot, slotCount))
+    {
+        _renderBackend->PSSetShaderResources(startSlot, slotCount, &_boundPixelShaderResources.Resources[startSlot]);
+    }
+    if (ChangeSlots(_boundVertexConstantBuffers, pipeline->_vertexConstantBuffers, startSlot, slotCount))
+    {
+        _renderBackend->VSSetConstantBuffers(startSlot, slotCount, &_boundVertexConstantBuffers.Resources[startSlot]);
+    }
+    if (ChangeSlots(_boundPixelConstantBuffers, pipeline->_pixelConstantBuffers, startSlot, slotCount))
+    {
+        _renderBackend->PSSetConstantBuffers(startSlot, slotCount, &_boundPixelConstantBuffers.Resources[startSlot]);
+    }
 
-        case ResourceType::Texture:
-            _deviceContext->PSSetShaderResources(descriptor.SlotIndex, 1, reinterpret_cast<ID3D11ShaderResourceView**>(&resource));
-            break;
+    if (ChangeState(_boundDepthStencilState, pipeline->_depthStencilState))
+    {
+        _renderBackend->OMSetDepthStencilState(_boundDepthStencilState.get(), 0);
+    }
 
-        case ResourceType::Buffer:
-            switch (descriptor.Stage)
-            {
-            case ResourceStage::VertexStage:
-                _deviceContext->VSSetConstantBuffers(descriptor.SlotIndex, 1, reinterpret_cast<ID3D11Buffer**>(&resource));
-                break;
-            case ResourceStage::PixelStage:
-                _deviceContext->PSSetConstantBuffers(descriptor.SlotIndex, 1, reinterpret_cast<ID3D11Buffer**>(&resource));
-                break;
-            }
-            break;
-        }
+    if (_isViewportBound && std::memcmp(&_boundViewport, &pipeline->_viewport, sizeof(RenderViewport)) == 0)
+    {
+        _currentFrameStatistics.SkippedStateCalls++;
+    }
+    else
+    {
+        _boundViewport = pipeline->_viewport;
+        _isViewportBound = true;
+        _currentFrameStatistics.IssuedStateCalls++;
+        _renderBackend->RSSetViewports(1, &_boundViewport);
     }
 
-    _deviceContext->OMSetDepthStencilState(pipeline->_depthStencilState.Get(), 0);
-    _deviceContext->RSSetViewports(1, &pipeline->_viewport);
-    _deviceContext->RSSetState(pipeline->_rasterizerState.Get());
+    if (ChangeState(_boundRasterizerState, pipeline->_rasterizerState))
+    {
+        _renderBackend->RSSetState(_boundRasterizerState.get());
+    }
 }
 
 void DeviceContext::SetVertexBuffer(
-    ID3D11Buffer* vertexBuffer,
+    const std::shared_ptr<RenderBuffer>& vertexBuffer,
     uint32_t vertexOffset)
 {
-    D3D11_BUFFER_DESC description = {};
-    vertexBuffer->GetDesc(&description);
-    _deviceContext->IASetVertexBuffers(
+    _drawVertices = vertexBuffer->GetDescription().Size / _activePipeline->_vertexSize;
+
+    if (_boundVertexBuffer == vertexBuffer &&
+        _boundVertexStride == _activePipeline->_vertexSize &&
+        _boundVertexOffset == vertexOffset)
+    {
+        _currentFrameStatistics.SkippedStateCalls++;
+        return;
+    }
+
+    _boundVertexBuffer = vertexBuffer;
+    _boundVertexStride = _activePipeline->_vertexSize;
+    _boundVertexOffset = vertexOffset;
+    _currentFrameStatistics.IssuedStateCalls++;
+    RenderBuffer* boundVertexBuffer = _boundVertexBuffer.get();
+    _renderBackend->IASetVertexBuffers(
         0,
         1,
-        &vertexBuffer,
-        &_activePipeline->_vertexSize,
-        &vertexOffset);
-    _drawVertices = description.ByteWidth / _activePipeline->_vertexSize;
+        &boundVertexBuffer,
+        &_boundVertexStride,
+        &_boundVertexOffset);
 }
 
-void DeviceContext::SetIndexBuffer(ID3D11Buffer* indexBuffer, uint32_t indexOffset)
+void DeviceContext::SetIndexBuffer(
+    const std::shared_ptr<RenderBuffer>& indexBuffer,
+    RenderFormat indexFormat,
+    uint32_t indexOffset)
 {
-    D3D11_BUFFER_DESC description = {};
-    indexBuffer->GetDesc(&description);
-    _deviceContext->IASetIndexBuffer(
-        indexBuffer,
-        DXGI_FORMAT::DXGI_FORMAT_R32_UINT,
+    _drawIndices = indexBuffer->GetDescription().Size / GetIndexSize(indexFormat);
+
+    if (_boundIndexBuffer == indexBuffer &&
+        _boundIndexFormat == indexFormat &&
+        _boundIndexOffset == indexOffset)
+    {
+        _currentFrameStatistics.SkippedStateCalls++;
+        return;
+    }
+
+    _boundIndexBuffer = indexBuffer;
+    _boundIndexFormat = indexFormat;
+    _boundIndexOffset = indexOffset;
+    _currentFrameStatistics.IssuedStateCalls++;
+    _renderBackend->IASetIndexBuffer(
+        indexBuffer.get(),
+        indexFormat,
         indexOffset);
-    _drawIndices = description.ByteWidth / sizeof(uint32_t);
 }
 
-void DeviceContext::UpdateSubresource(ID3D11Buffer* buffer, const void* data) const
+void DeviceContext::UpdateSubresource(RenderBuffer* buffer, const void* data) const
 {
-    _deviceContext->UpdateSubresource(
+    _renderBackend->UpdateSubresource(
         buffer,
         0,
         nullptr,
@@ -118,15 +165,102 @@ void DeviceContext::UpdateSubresource(ID3D11Buffer* buffer, const void* data) co
 
 void DeviceContext::Draw() const
 {
-    _deviceContext->Draw(_drawVertices, 0);
+    _renderBackend->Draw(_drawVertices, 0);
+}
+
+void DeviceContext::Draw(
+    const uint32_t vertexCount,
+    const uint32_t startVertex) const
+{
+    _renderBackend->Draw(vertexCount, startVertex);
 }
 
 void DeviceContext::DrawIndexed() const
 {
-    _deviceContext->DrawIndexed(_drawIndices, 0, 0);
+    _renderBackend->DrawIndexed(_drawIndices, 0, 0);
+}
+
+void DeviceContext::DrawIndexed(
+    const uint32_t indexCount,
+    const uint32_t startIndex,
+    const int32_t baseVertex) const
+{
+    _renderBackend->DrawIndexed(indexCount, startIndex, baseVertex);
 }
 
 void DeviceContext::Flush() const
 {
-    _deviceContext->Flush();
+    _renderBackend->Flush();
+}
+
+const DeviceContextStatistics& DeviceContext::GetFrameStatistics() const
+{
+    return _lastFrameStatistics;
+}
+
+template <typename TState>
+bool DeviceContext::ChangeState(TState& boundState, const TState& state)
+{
+    if (boundState == state)
+    {
+        _currentFrameStatistics.SkippedStateCalls++;
+        return false;
+    }
+
+    boundState = state;
+    _currentFrameStatistics.IssuedStateCalls++;
+    return true;
+}
+
+// Copies the slots the pipeline uses into the bound table and returns the range
+// spanning every slot that changed. Slots still bound from an earlier pipeline
+// which this one does not use are unbound, so the table matches the device.
+// Slots in between which did not change are bound again with their current
+// value, so one call covers the whole range.
+template <typename TResource, uint32_t SlotCount>
+bool DeviceContext::ChangeSlots(
+    ResourceSlotTable<TResource, SlotCount>& boundSlots,
+    const ResourceSlotTable<TResource, SlotCount>& slots,
+    uint32_t& startSlot,
+    uint32_t& slotCount)
+{
+    uint32_t firstChangedSlot = SlotCount;
+    uint32_t lastChangedSlot = 0;
+    uint32_t changedSlotCount = 0;
+    for (uint32_t maskWord = 0; maskWord < slots.MaskWordCount; maskWord++)
+    {
+        // Unused slots of the pipeline's table are null, which is what unbinds them
+        uint64_t usedSlots = boundSlots.UsedSlotMask[maskWord] | slots.UsedSlotMask[maskWord];
+        while (usedSlots != 0)
+        {
+            const uint32_t slotIndex = maskWord * 64 + FindFirstSetBit(usedSlots);
+            usedSlots &= usedSlots - 1;
+
+            if (boundSlots.Resources[slotIndex] == slots.Resources[slotIndex])
+            {
+                _currentFrameStatistics.SkippedStateCalls++;
+                continue;
+            }
+
+            // Slots are visited in ascending order
+            boundSlots.Set(slotIndex, slots.References[slotIndex]);
+            if (firstChangedSlot == SlotCount)
+            {
+                firstChangedSlot = slotIndex;
+            }
+            lastChangedSlot = slotIndex;
+            changedSlotCount++;
+        }
+    }
+
+    if (firstChangedSlot == SlotCount)
+    {
+        return false;
+    }
+
+    startSlot = firstChangedSlot;
+    slotCount = lastChangedSlot - firstChangedSlot + 1;
+    // Counted per slot like the skipped ones, even though the changed slots go out in one ranged call
+    _currentFrameStatistics.IssuedStateCalls += changedSlotCount;
+    return true;
 }
@@ -1,42 +1,93 @@
 #pragma once
 
-#include "Definitions.hpp"
-
-#include <d3d11_2.h>
+#include "RenderTypes.hpp"
+#include "ResourceSlotTable.hpp"
 
 #include <cstdint>
 #include <map>
+#include <memory>
 
 class Pipeline;
+class RenderBackend;
+
+// Every piece of state counts once, either as issued or as skipped. Slot tables count per slot
+struct DeviceContextStatistics
+{
+    uint32_t IssuedStateCalls = 0;
+    uint32_t SkippedStateCalls = 0;
+};
 
 class DeviceContext
 {
 public:
-    DeviceContext(
-        const WRL::ComPtr<ID3D11Device>& device,
-        WRL::ComPtr<ID3D11DeviceContext>&& deviceContext);
-    ~DeviceContext();
+    DeviceContext(const std::shared_ptr<RenderBackend>& renderBackend);
+
+    void BeginFrame();
 
     void Clear(
-        ID3D11RenderTargetView* renderTarget,
+        RenderTargetView* renderTarget,
         float clearColor[4],
-        ID3D11DepthStencilView* depthStencilView,
+        RenderDepthStencilView* depthStencilView,
         float clearDepth) const;
     void SetPipeline(const Pipeline* pipeline);
     void SetVertexBuffer(
-        ID3D11Buffer* vertexBuffer,
+        const std::shared_ptr<RenderBuffer>& vertexBuffer,
         uint32_t vertexOffset);
     void SetIndexBuffer(
-        ID3D11Buffer* indexBuffer,
+        const std::shared_ptr<RenderBuffer>& indexBuffer,
+        RenderFormat indexFormat,
         uint32_t indexOffset);
-    void UpdateSubresource(ID3D11Buffer* buffer, const void* data) const;
+    void UpdateSubresource(RenderBuffer* buffer, const void* data) const;
     void Draw() const;
+    void Draw(
+        uint32_t vertexCount,
+        uint32_t startVertex) const;
     void DrawIndexed() const;
+    void DrawIndexed(
+        uint32_t indexCount,
+        uint32_t startIndex,
+        int32_t baseVertex) const;
     void Flush() const;
 
+    [[nodiscard]] const DeviceContextStatistics& GetFrameStatistics() const;
+
 private:
+    template <typename TState>
+    bool ChangeState(TState& boundState, const TState& state);
+    template <typename TResource, uint32_t SlotCount>
+    bool ChangeSlots(
+        ResourceSlotTable<TResource, SlotCount>& boundSlots,
+        const ResourceSlotTable<TResource, SlotCount>& slots,
+        uint32_t& startSlot,
+        uint32_t& slotCount);
+
     uint32_t _drawVertices;
     uint32_t _drawIndices;
     const Pipeline* _activePipeline;
-    WRL::ComPtr<ID3D11DeviceContext> _deviceContext;
+    std::shared_ptr<RenderBackend> _renderBackend;
+
+    // Shadow copy of what is currently bound, used to skip calls which would not change anything.
+    // It holds on to what it binds, an object released while bound could otherwise be replaced
+    // by a new one at the same address, whose bind would then be skipped
+    std::shared_ptr<RenderInputLayout> _boundInputLayout = nullptr;
+    RenderPrimitiveTopology _boundPrimitiveTopology = RenderPrimitiveTopology::Undefined;
+    std::shared_ptr<RenderVertexShader> _boundVertexShader = nullptr;
+    std::shared_ptr<RenderPixelShader> _boundPixelShader = nullptr;
+    SamplerSlotTable _boundPixelSamplers = {};
+    ShaderResourceSlotTable _boundPixelShaderResources = {};
+    ConstantBufferSlotTable _boundVertexConstantBuffers = {};
+    ConstantBufferSlotTable _boundPixelConstantBuffers = {};
+    std::shared_ptr<RenderDepthStencilState> _boundDepthStencilState = nullptr;
+    RenderViewport _boundViewport = {};
+    bool _isViewportBound = false;
+    std::shared_ptr<RenderRasterizerState> _boundRasterizerState = nullptr;
+    std::shared_ptr<RenderBuffer> _boundVertexBuffer = nullptr;
+    uint32_t _boundVertexStride = 0;
+    uint32_t _boundVertexOffset = 0;
+    std::shared_ptr<RenderBuffer> _boundIndexBuffer = nullptr;
+    RenderFormat _boundIndexFormat = RenderFormat::Unknown;
+    uint32_t _boundIndexOffset = 0;
+
+    DeviceContextStatistics _currentFrameStatistics = {};
+    DeviceContextStatistics _lastFrameStatistics = {};
 };
@@ -0,0 +1,326 @@
+#include "GeometryPool.hpp"
+#include "RenderBackend.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+struct PoolRange
+{
+    uint32_t* Offset = nullptr;
+    uint32_t Count = 0;
+};
+
+RenderBox GetBufferBox(
+    const uint32_t offset,
+    const uint32_t count,
+    const uint32_t elementSize)
+{
+    RenderBox box = {};
+    box.Left = offset * elementSize;
+    box.Right = (offset + count) * elementSize;
+    box.Top = 0;
+    box.Bottom = 1;
+    box.Front = 0;
+    box.Back = 1;
+    return box;
+}
+} // namespace
+
+GeometryPool::GeometryPool(
+    const std::shared_ptr<RenderBackend>& renderBackend,
+    const uint32_t initialVertexCapacity,
+    const uint32_t initialIndexCapacity)
+{
+    _renderBackend = renderBackend;
+    _initialVertexCapacity = initialVertexCapacity;
+    _initialIndexCapacity = initialIndexCapacity;
+}
+
+bool GeometryPool::Allocate(
+    const VertexType vertexType,
+    const void* vertices,
+    const uint32_t vertexCount,
+    const RenderFormat indexFormat,
+    const void* indices,
+    const uint32_t indexCount,
+    GeometryHandle& handle)
+{
+    PoolBuffer& vertexBuffer = _vertexBuffers[vertexType];
+    vertexBuffer.ElementSize = static_cast<uint32_t>(GetVertexSize(vertexType));
+    vertexBuffer.IsVertexBuffer = true;
+    vertexBuffer.VertexType = vertexType;
+
+    PoolBuffer& indexBuffer = _indexBuffers[indexFormat];
+    indexBuffer.ElementSize = GetIndexSize(indexFormat);
+    indexBuffer.IsVertexBuffer = false;
+    indexBuffer.IndexFormat = indexFormat;
+
+    GeometryAllocation allocation = {};
+    allocation.VertexType = vertexType;
+    allocation.IndexFormat = indexFormat;
+    allocation.VertexCount = vertexCount;
+    allocation.IndexCount = indexCount;
+    if (!AllocateRange(vertexBuffer, _initialVertexCapacity, vertices, vertexCount, allocation.BaseVertex))
+    {
+        return false;
+    }
+
+    if (!AllocateRange(indexBuffer, _initialIndexCapacity, indices, indexCount, allocation.FirstIndex))
+    {
+        vertexBuffer.Allocator.Free(allocation.BaseVertex, vertexCount);
+        return false;
+    }
+
+    allocation.IsAllocated = true;
+    if (_freeHandles.empty())
+    {
+        handle = static_cast<GeometryHandle>(_allocations.size());
+        _allocations.push_back(allocation);
+    }
+    else
+    {
+        handle = _freeHandles.back();
+        _freeHandles.pop_back();
+        _allocations[handle] = allocation;
+    }
+
+    return true;
+}
+
+void GeometryPool::Free(const GeometryHandle handle)
+{
+    if (handle >= _allocations.size() || !_allocations[handle].IsAllocated)
+    {
+        return;
+    }
+
+    // The ranges are only handed out again, their contents stay until something overwrites them
+    GeometryAllocation& allocation = _allocations[handle];
+    _vertexBuffers.at(allocation.VertexType).Allocator.Free(allocation.BaseVertex, allocation.VertexCount);
+    _indexBuffers.at(allocation.IndexFormat).Allocator.Free(allocation.FirstIndex, allocation.IndexCount);
+    allocation = {};
+    _freeHandles.push_back(handle);
+}
+
+bool GeometryPool::Defragment()
+{
+    bool isDefragmented = false;
+    for (auto& [vertexType, poolBuffer] : _vertexBuffers)
+    {
+        if (!poolBuffer.Allocator.IsPacked())
+        {
+            if (!Repack(poolBuffer, poolBuffer.Allocator.GetCapacity()))
+            {
+                return false;
+            }
+
+            isDefragmented = true;
+        }
+    }
+
+    for (auto& [indexFormat, poolBuffer] : _indexBuffers)
+    {
+        if (!poolBuffer.Allocator.IsPacked())
+        {
+            if (!Repack(poolBuffer, poolBuffer.Allocator.GetCapacity()))
+            {
+                return false;
+            }
+
+            isDefragmented = true;
+        }
+    }
+
+    if (isDefragmented)
+    {
+        _defragmentations++;
+    }
+
+    return true;
+}
+
+const GeometryAllocation& GeometryPool::GetAllocation(const GeometryHandle handle) const
+{
+    return _allocations[handle];
+}
+
+std::shared_ptr<RenderBuffer> GeometryPool::GetVertexBuffer(const VertexType vertexType) const
+{
+    const auto poolBuffer = _vertexBuffers.find(vertexType);
+    return poolBuffer == _vertexBuffers.end() ? nullptr : poolBuffer->second.Buffer;
+}
+
+std::shared_ptr<RenderBuffer> GeometryPool::GetIndexBuffer(const RenderFormat indexFormat) const
+{
+    const auto poolBuffer = _indexBuffers.find(indexFormat);
+    return poolBuffer == _indexBuffers.end() ? nullptr : poolBuffer->second.Buffer;
+}
+
+GeometryPoolStatistics GeometryPool::GetStatistics() const
+{
+    GeometryPoolStatistics statistics = {};
+    statistics.Allocations = static_cast<uint32_t>(_allocations.size() - _freeHandles.size());
+    statistics.Grows = _grows;
+    statistics.Defragmentations = _defragmentations;
+
+    const auto addBuffer = [&](const PoolBuffer& poolBuffer)
+    {
+        if (poolBuffer.Buffer == nullptr)
+        {
+            return;
+        }
+
+        const RangeAllocator& allocator = poolBuffer.Allocator;
+        statistics.Buffers++;
+        statistics.CapacityBytes += static_cast<uint64_t>(allocator.GetCapacity()) * poolBuffer.ElementSize;
+        statistics.UsedBytes += static_cast<uint64_t>(allocator.GetCapacity() - allocator.GetFreeCount()) * poolBuffer.ElementSize;
+        statistics.FreeRanges += allocator.GetFreeRangeCount();
+    };
+    for (const auto& [vertexType, poolBuffer] : _vertexBuffers)
+    {
+        addBuffer(poolBuffer);
+    }
+
+    for (const auto& [indexFormat, poolBuffer] : _indexBuffers)
+    {
+        addBuffer(poolBuffer);
+    }
+
+    return statistics;
+}
+
+void GeometryPool::PrintStatistics() const
+{
+    const GeometryPoolStatistics statistics = GetStatistics();
+    std::cout << "GeometryPool: " << statistics.Allocations << " allocations in " << statistics.Buffers << " buffers, "
+              << statistics.UsedBytes / 1024 << " of " << statistics.CapacityBytes / 1024 << " KiB used in "
+              << statistics.FreeRanges << " free ranges, " << statistics.Grows << " grows, "
+              << statistics.Defragmentations << " defragmentations\n";
+}
+
+bool GeometryPool::AllocateRange(
+    PoolBuffer& poolBuffer,
+    const uint32_t initialCapacity,
+    const void* data,
+    const uint32_t count,
+    uint32_t& offset)
+{
+    if (count == 0)
+    {
+        offset = 0;
+        return true;
+    }
+
+    if (poolBuffer.Buffer == nullptr || !poolBuffer.Allocator.Allocate(count, offset))
+    {
+        // Compacting alone is enough when the free space is only split up, otherwise the buffer doubles
+        RangeAllocator& allocator = poolBuffer.Allocator;
+        const uint64_t usedCount = allocator.GetCapacity() - allocator.GetFreeCount();
+        uint64_t capacity = allocator.GetCapacity() > initialCapacity ? allocator.GetCapacity() : initialCapacity;
+        while (usedCount + count > capacity)
+        {
+            capacity *= 2;
+        }
+
+        if (capacity * poolBuffer.ElementSize > RenderMaxResourceSize)
+        {
+            std::cout << "GeometryPool: Allocation of " << count << " elements exceeds the maximum buffer size\n";
+            return false;
+        }
+
+        const bool hasBuffer = poolBuffer.Buffer != nullptr;
+        const bool isGrowing = hasBuffer && capacity > allocator.GetCapacity();
+        if (!Repack(poolBuffer, static_cast<uint32_t>(capacity)) || !allocator.Allocate(count, offset))
+        {
+            return false;
+        }
+
+        if (isGrowing)
+        {
+            _grows++;
+        }
+        else if (hasBuffer && usedCount > 0)
+        {
+            _defragmentations++;
+        }
+    }
+
+    const RenderBox box = GetBufferBox(offset, count, poolBuffer.ElementSize);
+    _renderBackend->UpdateSubresource(poolBuffer.Buffer.get(), 0, &box, data, 0, 0);
+    return true;
+}
+
+bool GeometryPool::Repack(
+    PoolBuffer& poolBuffer,
+    const uint32_t capacity)
+{
+    RenderBufferDescription bufferDescription = {};
+    bufferDescription.Size = capacity * poolBuffer.ElementSize;
+    bufferDescription.Usage = RenderUsage::Default;
+    bufferDescription.BindFlags = poolBuffer.IsVertexBuffer
+                                      ? RenderBindFlags::RenderBindVertexBuffer
+                                      : RenderBindFlags::RenderBindIndexBuffer;
+
+    std::shared_ptr<RenderBuffer> buffer = nullptr;
+    if (!_renderBackend->CreateBuffer(
+            bufferDescription,
+            nullptr,
+            buffer))
+    {
+        std::cout << "GeometryPool: Failed to create geometry pool buffer\n";
+        return false;
+    }
+
+    std::vector<PoolRange> ranges;
+    for (GeometryAllocation& allocation : _allocations)
+    {
+        if (!allocation.IsAllocated)
+        {
+            continue;
+        }
+
+        if (poolBuffer.IsVertexBuffer && allocation.VertexType == poolBuffer.VertexType && allocation.VertexCount > 0)
+        {
+            ranges.push_back({ &allocation.BaseVertex, allocation.VertexCount });
+        }
+        else if (!poolBuffer.IsVertexBuffer && allocation.IndexFormat == poolBuffer.IndexFormat && allocation.IndexCount > 0)
+        {
+            ranges.push_back({ &allocation.FirstIndex, allocation.IndexCount });
+        }
+    }
+
+    std::sort(ranges.begin(), ranges.end(), [](const PoolRange& left, const PoolRange& right)
+    {
+        return *left.Offset < *right.Offset;
+    });
+
+    // Copied into a new buffer, D3D11 does not allow overlapping copies within one resource
+    uint32_t packedCount = 0;
+    for (const PoolRange& range : ranges)
+    {
+        const RenderBox sourceBox = GetBufferBox(*range.Offset, range.Count, poolBuffer.ElementSize);
+        _renderBackend->CopySubresourceRegion(
+            buffer.get(),
+            0,
+            packedCount * poolBuffer.ElementSize,
+            0,
+            0,
+            poolBuffer.Buffer.get(),
+            0,
+            &sourceBox);
+        *range.Offset = packedCount;
+        packedCount += range.Count;
+    }
+
+    poolBuffer.Buffer = std::move(buffer);
+    poolBuffer.Allocator.Reset(capacity);
+    uint32_t packedOffset = 0;
+    if (packedCount > 0 && !poolBuffer.Allocator.Allocate(packedCount, packedOffset))
+    {
+        return false;
+    }
+
+    return true;
+}
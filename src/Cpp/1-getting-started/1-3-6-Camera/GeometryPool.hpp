@@ -0,0 +1,102 @@
+#pragma once
+
+#include "RangeAllocator.hpp"
+#include "RenderTypes.hpp"
+#include "VertexType.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+class RenderBackend;
+
+using GeometryHandle = uint32_t;
+constexpr GeometryHandle InvalidGeometryHandle = ~0u;
+
+// Where a model's vertices and indices live in the pool's buffers, in vertices and indices.
+// Draws add BaseVertex and FirstIndex to the model's own offsets. Both change when the pool
+// grows or is defragmented, so they are looked up when drawing instead of being kept around.
+struct GeometryAllocation
+{
+    ::VertexType VertexType = VertexType::PositionColorUv;
+    RenderFormat IndexFormat = RenderFormat::R16Uint;
+    uint32_t BaseVertex = 0;
+    uint32_t VertexCount = 0;
+    uint32_t FirstIndex = 0;
+    uint32_t IndexCount = 0;
+    bool IsAllocated = false;
+};
+
+struct GeometryPoolStatistics
+{
+    uint32_t Allocations = 0;
+    uint32_t Buffers = 0;
+    uint64_t CapacityBytes = 0;
+    uint64_t UsedBytes = 0;
+    uint32_t FreeRanges = 0;
+    uint32_t Grows = 0;
+    uint32_t Defragmentations = 0;
+};
+
+// Owns one large vertex buffer per vertex type and one large index buffer per index format,
+// and sub-allocates ranges of them for models, so models sharing a vertex type are drawn without
+// rebinding any buffer. Buffers grow by copying their contents on the GPU when a range does not fit.
+class GeometryPool
+{
+public:
+    GeometryPool(
+        const std::shared_ptr<RenderBackend>& renderBackend,
+        uint32_t initialVertexCapacity,
+        uint32_t initialIndexCapacity);
+
+    bool Allocate(
+        VertexType vertexType,
+        const void* vertices,
+        uint32_t vertexCount,
+        RenderFormat indexFormat,
+        const void* indices,
+        uint32_t indexCount,
+        GeometryHandle& handle);
+    void Free(GeometryHandle handle);
+
+    // Moves every allocation to the front of its buffer, which closes the gaps freed allocations left
+    bool Defragment();
+
+    [[nodiscard]] const GeometryAllocation& GetAllocation(GeometryHandle handle) const;
+    [[nodiscard]] std::shared_ptr<RenderBuffer> GetVertexBuffer(VertexType vertexType) const;
+    [[nodiscard]] std::shared_ptr<RenderBuffer> GetIndexBuffer(RenderFormat indexFormat) const;
+    [[nodiscard]] GeometryPoolStatistics GetStatistics() const;
+    void PrintStatistics() const;
+
+private:
+    struct PoolBuffer
+    {
+        std::shared_ptr<RenderBuffer> Buffer = nullptr;
+        RangeAllocator Allocator = {};
+        uint32_t ElementSize = 0;
+        bool IsVertexBuffer = false;
+        ::VertexType VertexType = VertexType::PositionColorUv;
+        RenderFormat IndexFormat = RenderFormat::Unknown;
+    };
+
+    bool AllocateRange(
+        PoolBuffer& poolBuffer,
+        uint32_t initialCapacity,
+        const void* data,
+        uint32_t count,
+        uint32_t& offset);
+    bool Repack(
+        PoolBuffer& poolBuffer,
+        uint32_t capacity);
+
+    std::shared_ptr<RenderBackend> _renderBackend = nullptr;
+    uint32_t _initialVertexCapacity = 0;
+    uint32_t _initialIndexCapacity = 0;
+    std::map<VertexType, PoolBuffer> _vertexBuffers;
+    std::map<RenderFormat, PoolBuffer> _indexBuffers;
+    std::vector<GeometryAllocation> _allocations;
+    std::vector<GeometryHandle> _freeHandles;
+    uint32_t _grows = 0;
+    uint32_t _defragmentations = 0;
+};
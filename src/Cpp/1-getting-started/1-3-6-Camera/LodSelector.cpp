@@ -0,0 +1,84 @@
+#include "LodSelector.hpp"
+#include "Camera.hpp"
+#include "Model.hpp"
+
+#include <limits>
+
+namespace
+{
+struct ModelDistance
+{
+    float Scale = 1.0f;
+    float Radius = 0.0f;
+    float Distance = 0.0f;
+};
+
+ModelDistance GetModelDistance(
+    const Model& model,
+    const DirectX::XMFLOAT4X4& worldMatrix,
+    const PerspectiveCamera& camera)
+{
+    // Sizes are in model space, the largest scale of the world matrix turns them into world space
+    const DirectX::XMMATRIX world = DirectX::XMLoadFloat4x4(&worldMatrix);
+    const float scaleX = DirectX::XMVectorGetX(DirectX::XMVector3Length(world.r[0]));
+    const float scaleY = DirectX::XMVectorGetX(DirectX::XMVector3Length(world.r[1]));
+    const float scaleZ = DirectX::XMVectorGetX(DirectX::XMVector3Length(world.r[2]));
+
+    ModelDistance modelDistance = {};
+    modelDistance.Scale = scaleX > scaleY ? (scaleX > scaleZ ? scaleX : scaleZ) : (scaleY > scaleZ ? scaleY : scaleZ);
+
+    const DirectX::XMVECTOR center = DirectX::XMVector3TransformCoord(DirectX::XMLoadFloat3(&model.SphereBounds.Center), world);
+    modelDistance.Radius = model.SphereBounds.Radius * modelDistance.Scale;
+    const float centerDistance = DirectX::XMVectorGetX(DirectX::XMVector3Length(
+        DirectX::XMVectorSubtract(center, DirectX::XMLoadFloat3(&camera.GetPosition()))));
+    modelDistance.Distance = centerDistance - modelDistance.Radius;
+    return modelDistance;
+}
+} // namespace
+
+uint32_t SelectModelLod(
+    const Model& model,
+    const DirectX::XMFLOAT4X4& worldMatrix,
+    const PerspectiveCamera& camera,
+    const float maxScreenSpaceError)
+{
+    if (model.Lods.size() <= 1)
+    {
+        return 0;
+    }
+
+    // Inside the sphere every level could be right in front of the camera, only the full one is safe
+    const ModelDistance modelDistance = GetModelDistance(model, worldMatrix, camera);
+    if (modelDistance.Distance <= 0.0f)
+    {
+        return 0;
+    }
+
+    uint32_t selectedLod = 0;
+    for (uint32_t lod = 1; lod < model.Lods.size(); lod++)
+    {
+        if (camera.GetProjectedSize(model.Lods[lod].Error * modelDistance.Scale, modelDistance.Distance) > maxScreenSpaceError)
+        {
+            break;
+        }
+
+        selectedLod = lod;
+    }
+
+    return selectedLod;
+}
+
+float GetProjectedModelSize(
+    const Model& model,
+    const DirectX::XMFLOAT4X4& worldMatrix,
+    const PerspectiveCamera& camera)
+{
+    // Inside the sphere the model fills the screen at the very least
+    const ModelDistance modelDistance = GetModelDistance(model, worldMatrix, camera);
+    if (modelDistance.Distance <= 0.0f)
+    {
+        return std::numeric_limits<float>::max();
+    }
+
+    return camera.GetProjectedSize(modelDistance.Radius * 2.0f, modelDistance.Distance);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+
+class PerspectiveCamera;
+struct Model;
+
+// Picks the coarsest detail level of the model whose error, projected onto the screen from the
+// point of the model's bounding sphere closest to the camera, stays below maxScreenSpaceError pixels
+[[nodiscard]] uint32_t SelectModelLod(
+    const Model& model,
+    const DirectX::XMFLOAT4X4& worldMatrix,
+    const PerspectiveCamera& camera,
+    float maxScreenSpaceError);
+
+// How many pixels across the model's bounding sphere covers on screen, seen from its point closest
+// to the camera. Texture streaming picks the mips of the model's textures by it
+[[nodiscard]] float GetProjectedModelSize(
+    const Model& model,
+    const DirectX::XMFLOAT4X4& worldMatrix,
+    const PerspectiveCamera& camera);
@@ -1,8 +1,52 @@
 #include "CameraApplication.hpp"
 
-int main()
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+// Only plain decimal numbers which fit into 32 bits, strtoul would accept signs and wrap negative ones around
+bool ParseFrameCount(
+    const char* argument,
+    uint32_t& frameCount)
 {
+    if (argument[0] < '0' || argument[0] > '9')
+    {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long value = std::strtoull(argument, &end, 10);
+    if (errno != 0 || *end != '\0' || value > UINT32_MAX)
+    {
+        return false;
+    }
+
+    frameCount = static_cast<uint32_t>(value);
+    return true;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    uint32_t frameCount = 0;
+    const bool isHeadless = argc == 3 && std::strcmp(argv[1], "--headless") == 0 && ParseFrameCount(argv[2], frameCount);
+    if (argc > 1 && !isHeadless)
+    {
+        std::cout << "Usage: " << argv[0] << " [--headless <frames>]\n";
+        return 1;
+    }
+
     CameraApplication app{ "LearnD3D11 - Camera" };
+    if (isHeadless)
+    {
+        return app.RunHeadless(frameCount) ? 0 : 1;
+    }
+
     app.Run();
     return 0;
 }
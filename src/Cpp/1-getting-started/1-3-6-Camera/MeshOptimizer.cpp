@@ -0,0 +1,370 @@
+#include "MeshOptimizer.hpp"
+#include "Model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+constexpr uint32_t InvalidVertex = ~0u;
+
+struct Cluster
+{
+    uint32_t FirstTriangle = 0;
+    uint32_t TriangleCount = 0;
+    float SortKey = 0.0f;
+};
+} // namespace
+
+MeshOptimizer::MeshOptimizer(
+    const uint32_t cacheSize,
+    const float overdrawThreshold)
+{
+    _cacheSize = cacheSize;
+    _overdrawThreshold = overdrawThreshold;
+}
+
+void MeshOptimizer::Optimize(
+    std::vector<VertexPositionNormalColorUv>& vertices,
+    std::vector<uint32_t>& indices,
+    std::vector<Submesh>& submeshes)
+{
+    _statistics = {};
+
+    std::vector<VertexPositionNormalColorUv> optimizedVertices;
+    optimizedVertices.reserve(vertices.size());
+    std::vector<uint32_t> vertexRemap;
+    for (Submesh& submesh : submeshes)
+    {
+        const VertexPositionNormalColorUv* submeshVertices = &vertices[submesh.BaseVertex];
+        uint32_t* submeshIndices = &indices[submesh.IndexOffset];
+
+        const VertexCacheStatistics before = AnalyzeVertexCache(submeshIndices, submesh.IndexCount, submesh.VertexCount);
+        _statistics.Before.TransformedVertices += before.TransformedVertices;
+        _statistics.Before.Triangles += before.Triangles;
+        _statistics.Before.Vertices += before.Vertices;
+
+        _optimizedIndices.resize(submesh.IndexCount);
+        OptimizeVertexCache(submeshIndices, submesh.IndexCount, submesh.VertexCount, _optimizedIndices.data());
+        OptimizeOverdraw(_optimizedIndices.data(), submesh.IndexCount, submesh.VertexCount, submeshVertices, submeshIndices);
+
+        // Vertices are stored in the order the triangles first use them
+        const uint32_t baseVertex = static_cast<uint32_t>(optimizedVertices.size());
+        vertexRemap.assign(submesh.VertexCount, InvalidVertex);
+        for (uint32_t i = 0; i < submesh.IndexCount; i++)
+        {
+            uint32_t& remappedVertex = vertexRemap[submeshIndices[i]];
+            if (remappedVertex == InvalidVertex)
+            {
+                remappedVertex = static_cast<uint32_t>(optimizedVertices.size()) - baseVertex;
+                optimizedVertices.push_back(submeshVertices[submeshIndices[i]]);
+            }
+
+            submeshIndices[i] = remappedVertex;
+        }
+
+        submesh.BaseVertex = static_cast<int32_t>(baseVertex);
+        submesh.VertexCount = static_cast<uint32_t>(optimizedVertices.size()) - baseVertex;
+
+        const VertexCacheStatistics after = AnalyzeVertexCache(submeshIndices, submesh.IndexCount, submesh.VertexCount);
+        _statistics.After.TransformedVertices += after.TransformedVertices;
+        _statistics.After.Triangles += after.Triangles;
+        _statistics.After.Vertices += after.Vertices;
+    }
+
+    vertices = std::move(optimizedVertices);
+}
+
+const MeshOptimizerStatistics& MeshOptimizer::GetStatistics() const
+{
+    return _statistics;
+}
+
+void MeshOptimizer::PrintStatistics() const
+{
+    std::cout << "MeshOptimizer: ACMR " << _statistics.Before.GetAcmr() << " -> " << _statistics.After.GetAcmr()
+              << ", ATVR " << _statistics.Before.GetAtvr() << " -> " << _statistics.After.GetAtvr()
+              << " (" << _statistics.After.Triangles << " triangles, "
+              << _statistics.Before.Vertices << " -> " << _statistics.After.Vertices << " vertices)\n";
+}
+
+VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(
+    const uint32_t* indices,
+    const uint32_t indexCount,
+    const uint32_t vertexCount)
+{
+    // A vertex is in the cache while fewer than _cacheSize misses happened since it was transformed
+    _cacheTimestamps.assign(vertexCount, 0);
+    uint32_t timestamp = _cacheSize + 1;
+
+    VertexCacheStatistics statistics = {};
+    statistics.Triangles = indexCount / 3;
+    for (uint32_t i = 0; i < indexCount; i++)
+    {
+        const uint32_t vertex = indices[i];
+        if (_cacheTimestamps[vertex] == 0)
+        {
+            statistics.Vertices++;
+        }
+
+        if (timestamp - _cacheTimestamps[vertex] > _cacheSize)
+        {
+            _cacheTimestamps[vertex] = timestamp++;
+            statistics.TransformedVertices++;
+        }
+    }
+
+    return statistics;
+}
+
+// Tipsify, Sander et al. 2007. Fans around a vertex at a time and continues with the
+// neighbour that stays in the cache longest. Every time it runs into a dead end the cache
+// is effectively cold, those points start a new cluster in _clusterOffsets.
+void MeshOptimizer::OptimizeVertexCache(
+    const uint32_t* indices,
+    const uint32_t indexCount,
+    const uint32_t vertexCount,
+    uint32_t* optimizedIndices)
+{
+    const uint32_t triangleCount = indexCount / 3;
+
+    // Triangles using each vertex, stored as ranges of one shared list
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (uint32_t i = 0; i < indexCount; i++)
+    {
+        liveTriangles[indices[i]]++;
+    }
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + liveTriangles[vertex];
+    }
+
+    std::vector<uint32_t> adjacency(indexCount);
+    std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (uint32_t i = 0; i < indexCount; i++)
+    {
+        adjacency[adjacencyFill[indices[i]]++] = i / 3;
+    }
+
+    _cacheTimestamps.assign(vertexCount, 0);
+    _clusterOffsets.clear();
+    _clusterOffsets.push_back(0);
+
+    std::vector<bool> isTriangleEmitted(triangleCount, false);
+    std::vector<uint32_t> deadEndStack;
+    deadEndStack.reserve(indexCount);
+    std::vector<uint32_t> candidates;
+
+    uint32_t timestamp = _cacheSize + 1;
+    uint32_t emittedTriangles = 0;
+    uint32_t cursor = 0;
+    while (cursor < vertexCount && liveTriangles[cursor] == 0)
+    {
+        cursor++;
+    }
+
+    uint32_t fanningVertex = cursor < vertexCount ? cursor : InvalidVertex;
+    while (fanningVertex != InvalidVertex)
+    {
+        candidates.clear();
+        for (uint32_t i = adjacencyOffsets[fanningVertex]; i < adjacencyOffsets[fanningVertex + 1]; i++)
+        {
+            const uint32_t triangle = adjacency[i];
+            if (isTriangleEmitted[triangle])
+            {
+                continue;
+            }
+
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                const uint32_t vertex = indices[triangle * 3 + corner];
+                optimizedIndices[emittedTriangles * 3 + corner] = vertex;
+                deadEndStack.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                if (timestamp - _cacheTimestamps[vertex] > _cacheSize)
+                {
+                    _cacheTimestamps[vertex] = timestamp++;
+                }
+            }
+
+            isTriangleEmitted[triangle] = true;
+            emittedTriangles++;
+        }
+
+        // Candidates which would still be cached after fanning around them are preferred,
+        // the one transformed earliest first since it is closest to being evicted
+        uint32_t nextVertex = InvalidVertex;
+        int64_t bestPriority = -1;
+        for (const uint32_t vertex : candidates)
+        {
+            if (liveTriangles[vertex] == 0)
+            {
+                continue;
+            }
+
+            int64_t priority = 0;
+            const uint32_t age = timestamp - _cacheTimestamps[vertex];
+            if (age + 2 * liveTriangles[vertex] <= _cacheSize)
+            {
+                priority = age;
+            }
+
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                nextVertex = vertex;
+            }
+        }
+
+        if (nextVertex != InvalidVertex)
+        {
+            fanningVertex = nextVertex;
+            continue;
+        }
+
+        while (!deadEndStack.empty() && nextVertex == InvalidVertex)
+        {
+            const uint32_t vertex = deadEndStack.back();
+            deadEndStack.pop_back();
+            if (liveTriangles[vertex] > 0)
+            {
+                nextVertex = vertex;
+            }
+        }
+
+        while (nextVertex == InvalidVertex && cursor < vertexCount)
+        {
+            if (liveTriangles[cursor] > 0)
+            {
+                nextVertex = cursor;
+            }
+            cursor++;
+        }
+
+        if (nextVertex != InvalidVertex)
+        {
+            _clusterOffsets.push_back(emittedTriangles);
+        }
+        fanningVertex = nextVertex;
+    }
+}
+
+// Fast triangle reordering, Sander et al. 2007. Clusters are split further wherever the cache
+// already performs within _overdrawThreshold of the whole mesh, then sorted so clusters facing
+// away from the mesh centroid are drawn first, those tend to occlude the rest.
+void MeshOptimizer::OptimizeOverdraw(
+    const uint32_t* indices,
+    const uint32_t indexCount,
+    const uint32_t vertexCount,
+    const VertexPositionNormalColorUv* vertices,
+    uint32_t* optimizedIndices)
+{
+    const uint32_t triangleCount = indexCount / 3;
+    const float meshAcmr = AnalyzeVertexCache(indices, indexCount, vertexCount).GetAcmr();
+
+    std::vector<Cluster> clusters;
+    _cacheTimestamps.assign(vertexCount, 0);
+    uint32_t timestamp = _cacheSize + 1;
+    _clusterOffsets.push_back(triangleCount);
+    for (size_t hardCluster = 0; hardCluster + 1 < _clusterOffsets.size(); hardCluster++)
+    {
+        const uint32_t clusterEnd = _clusterOffsets[hardCluster + 1];
+        Cluster cluster = {};
+        cluster.FirstTriangle = _clusterOffsets[hardCluster];
+
+        // Moving the timestamp past the cache size makes every cached vertex miss again
+        timestamp += _cacheSize + 1;
+        uint32_t clusterMisses = 0;
+        for (uint32_t triangle = cluster.FirstTriangle; triangle < clusterEnd; triangle++)
+        {
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                const uint32_t vertex = indices[triangle * 3 + corner];
+                if (timestamp - _cacheTimestamps[vertex] > _cacheSize)
+                {
+                    _cacheTimestamps[vertex] = timestamp++;
+                    clusterMisses++;
+                }
+            }
+
+            cluster.TriangleCount++;
+            const float clusterAcmr = static_cast<float>(clusterMisses) / static_cast<float>(cluster.TriangleCount);
+            if (triangle + 1 < clusterEnd && clusterAcmr <= meshAcmr * _overdrawThreshold)
+            {
+                clusters.push_back(cluster);
+                cluster.FirstTriangle = triangle + 1;
+                cluster.TriangleCount = 0;
+                clusterMisses = 0;
+                timestamp += _cacheSize + 1;
+            }
+        }
+
+        if (cluster.TriangleCount > 0)
+        {
+            clusters.push_back(cluster);
+        }
+    }
+
+    // Area weighted centroid and normal per cluster
+    std::vector<DirectX::XMFLOAT3> clusterCentroids(clusters.size());
+    std::vector<DirectX::XMFLOAT3> clusterNormals(clusters.size());
+    DirectX::XMVECTOR meshCentroid = DirectX::XMVectorZero();
+    float meshArea = 0.0f;
+    for (size_t i = 0; i < clusters.size(); i++)
+    {
+        DirectX::XMVECTOR centroid = DirectX::XMVectorZero();
+        DirectX::XMVECTOR normal = DirectX::XMVectorZero();
+        float clusterArea = 0.0f;
+        for (uint32_t triangle = clusters[i].FirstTriangle; triangle < clusters[i].FirstTriangle + clusters[i].TriangleCount; triangle++)
+        {
+            const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&vertices[indices[triangle * 3 + 0]].position);
+            const DirectX::XMVECTOR p1 = DirectX::XMLoadFloat3(&vertices[indices[triangle * 3 + 1]].position);
+            const DirectX::XMVECTOR p2 = DirectX::XMLoadFloat3(&vertices[indices[triangle * 3 + 2]].position);
+            const DirectX::XMVECTOR triangleNormal = DirectX::XMVector3Cross(
+                DirectX::XMVectorSubtract(p1, p0),
+                DirectX::XMVectorSubtract(p2, p0));
+            const float triangleArea = DirectX::XMVectorGetX(DirectX::XMVector3Length(triangleNormal));
+            const DirectX::XMVECTOR triangleCentroid = DirectX::XMVectorScale(
+                DirectX::XMVectorAdd(DirectX::XMVectorAdd(p0, p1), p2),
+                1.0f / 3.0f);
+
+            centroid = DirectX::XMVectorAdd(centroid, DirectX::XMVectorScale(triangleCentroid, triangleArea));
+            normal = DirectX::XMVectorAdd(normal, triangleNormal);
+            clusterArea += triangleArea;
+        }
+
+        meshCentroid = DirectX::XMVectorAdd(meshCentroid, centroid);
+        meshArea += clusterArea;
+
+        DirectX::XMStoreFloat3(&clusterCentroids[i], clusterArea > 0.0f ? DirectX::XMVectorScale(centroid, 1.0f / clusterArea) : centroid);
+        DirectX::XMStoreFloat3(&clusterNormals[i], DirectX::XMVector3Normalize(normal));
+    }
+
+    if (meshArea > 0.0f)
+    {
+        meshCentroid = DirectX::XMVectorScale(meshCentroid, 1.0f / meshArea);
+    }
+
+    for (size_t i = 0; i < clusters.size(); i++)
+    {
+        const DirectX::XMVECTOR offset = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&clusterCentroids[i]), meshCentroid);
+        clusters[i].SortKey = DirectX::XMVectorGetX(DirectX::XMVector3Dot(offset, DirectX::XMLoadFloat3(&clusterNormals[i])));
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& left, const Cluster& right)
+    {
+        return left.SortKey > right.SortKey;
+    });
+
+    uint32_t* destination = optimizedIndices;
+    for (const Cluster& cluster : clusters)
+    {
+        std::memcpy(destination, &indices[cluster.FirstTriangle * 3], sizeof(uint32_t) * 3 * cluster.TriangleCount);
+        destination += 3 * cluster.TriangleCount;
+    }
+}
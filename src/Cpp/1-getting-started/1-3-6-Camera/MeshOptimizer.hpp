@@ -0,0 +1,80 @@
+#pragma once
+
+#include "VertexType.hpp"
+
+#include <cstdint>
+#include <vector>
+
+struct Submesh;
+
+// Vertex shader invocations as simulated with a FIFO post-transform cache.
+// ACMR is transformed vertices per triangle, ATVR transformed vertices per unique vertex,
+// the best possible ATVR is 1.0
+struct VertexCacheStatistics
+{
+    uint32_t TransformedVertices = 0;
+    uint32_t Triangles = 0;
+    uint32_t Vertices = 0;
+
+    [[nodiscard]] float GetAcmr() const
+    {
+        return Triangles == 0 ? 0.0f : static_cast<float>(TransformedVertices) / static_cast<float>(Triangles);
+    }
+
+    [[nodiscard]] float GetAtvr() const
+    {
+        return Vertices == 0 ? 0.0f : static_cast<float>(TransformedVertices) / static_cast<float>(Vertices);
+    }
+};
+
+struct MeshOptimizerStatistics
+{
+    VertexCacheStatistics Before = {};
+    VertexCacheStatistics After = {};
+};
+
+// Reorders the triangles of every submesh for post-transform vertex cache hits (Tipsify),
+// then reorders clusters of those triangles so outward facing ones are drawn first to reduce
+// overdraw, and finally reorders vertices in the order the indices first reference them.
+// Vertices no triangle references are dropped.
+class MeshOptimizer
+{
+public:
+    MeshOptimizer(
+        uint32_t cacheSize,
+        float overdrawThreshold);
+
+    void Optimize(
+        std::vector<VertexPositionNormalColorUv>& vertices,
+        std::vector<uint32_t>& indices,
+        std::vector<Submesh>& submeshes);
+
+    [[nodiscard]] const MeshOptimizerStatistics& GetStatistics() const;
+    void PrintStatistics() const;
+
+private:
+    VertexCacheStatistics AnalyzeVertexCache(
+        const uint32_t* indices,
+        uint32_t indexCount,
+        uint32_t vertexCount);
+    void OptimizeVertexCache(
+        const uint32_t* indices,
+        uint32_t indexCount,
+        uint32_t vertexCount,
+        uint32_t* optimizedIndices);
+    void OptimizeOverdraw(
+        const uint32_t* indices,
+        uint32_t indexCount,
+        uint32_t vertexCount,
+        const VertexPositionNormalColorUv* vertices,
+        uint32_t* optimizedIndices);
+
+    uint32_t _cacheSize = 16;
+    float _overdrawThreshold = 1.05f;
+    MeshOptimizerStatistics _statistics = {};
+
+    // Scratch memory reused between submeshes
+    std::vector<uint32_t> _cacheTimestamps;
+    std::vector<uint32_t> _clusterOffsets;
+    std::vector<uint32_t> _optimizedIndices;
+};
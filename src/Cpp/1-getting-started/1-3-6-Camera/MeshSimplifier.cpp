@@ -0,0 +1,534 @@
+#include "MeshSimplifier.hpp"
+#include "Model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+// A level which keeps more than this of the previous level's triangles is not worth switching to
+constexpr float MinLodReduction = 0.9f;
+
+DirectX::XMVECTOR GetTriangleNormal(
+    const DirectX::XMFLOAT3& p0,
+    const DirectX::XMFLOAT3& p1,
+    const DirectX::XMFLOAT3& p2)
+{
+    const DirectX::XMVECTOR position0 = DirectX::XMLoadFloat3(&p0);
+    return DirectX::XMVector3Cross(
+        DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&p1), position0),
+        DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&p2), position0));
+}
+
+float GetSquaredDistance(
+    const DirectX::XMFLOAT3& left,
+    const DirectX::XMFLOAT3& right)
+{
+    const float x = left.x - right.x;
+    const float y = left.y - right.y;
+    const float z = left.z - right.z;
+    return x * x + y * y + z * z;
+}
+
+float GetSquaredDistance(
+    const DirectX::XMFLOAT2& left,
+    const DirectX::XMFLOAT2& right)
+{
+    const float x = left.x - right.x;
+    const float y = left.y - right.y;
+    return x * x + y * y;
+}
+
+bool IsPositionLess(
+    const DirectX::XMFLOAT3& left,
+    const DirectX::XMFLOAT3& right)
+{
+    if (left.x != right.x)
+    {
+        return left.x < right.x;
+    }
+
+    if (left.y != right.y)
+    {
+        return left.y < right.y;
+    }
+
+    return left.z < right.z;
+}
+} // namespace
+
+MeshSimplifier::MeshSimplifier(const MeshSimplifierAttributeWeights& attributeWeights)
+{
+    _attributeWeights = attributeWeights;
+}
+
+void MeshSimplifier::GenerateLods(
+    const std::vector<VertexPositionNormalColorUv>& vertices,
+    std::vector<uint32_t>& indices,
+    const std::vector<Submesh>& submeshes,
+    const uint32_t maxLodCount,
+    const float lodReduction,
+    const float maxError,
+    std::vector<ModelLod>& lods,
+    std::vector<IndexRange>& lodIndexRanges)
+{
+    _statistics = {};
+    lods.clear();
+    lodIndexRanges.clear();
+
+    // Each submesh is simplified level after level, so the quadrics gathered for one level carry over to the next
+    const uint32_t submeshCount = static_cast<uint32_t>(submeshes.size());
+    std::vector<std::vector<uint32_t>> levelIndices(static_cast<size_t>(submeshCount) * maxLodCount);
+    std::vector<float> levelErrors(static_cast<size_t>(submeshCount) * maxLodCount, 0.0f);
+    std::vector<uint32_t> submeshIndices;
+    for (uint32_t i = 0; i < submeshCount; i++)
+    {
+        const Submesh& submesh = submeshes[i];
+        const VertexPositionNormalColorUv* submeshVertices = &vertices[submesh.BaseVertex];
+        submeshIndices.assign(indices.begin() + submesh.IndexOffset, indices.begin() + submesh.IndexOffset + submesh.IndexCount);
+        PrepareSubmesh(submeshVertices, submesh.VertexCount, submeshIndices);
+
+        for (uint32_t lod = 1; lod < maxLodCount; lod++)
+        {
+            const uint32_t targetIndexCount = static_cast<uint32_t>(static_cast<float>(submeshIndices.size() / 3) * lodReduction) * 3;
+            levelErrors[i * maxLodCount + lod] = Simplify(submeshVertices, submesh.VertexCount, submeshIndices, targetIndexCount, maxError);
+            levelIndices[i * maxLodCount + lod] = submeshIndices;
+        }
+    }
+
+    lods.push_back(ModelLod{ 0, 0.0f });
+    uint32_t previousIndexCount = 0;
+    for (const Submesh& submesh : submeshes)
+    {
+        lodIndexRanges.push_back(IndexRange{ submesh.IndexOffset, submesh.IndexCount });
+        previousIndexCount += submesh.IndexCount;
+    }
+
+    for (uint32_t lod = 1; lod < maxLodCount; lod++)
+    {
+        uint32_t indexCount = 0;
+        for (uint32_t i = 0; i < submeshCount; i++)
+        {
+            indexCount += static_cast<uint32_t>(levelIndices[i * maxLodCount + lod].size());
+        }
+
+        if (static_cast<float>(indexCount) > static_cast<float>(previousIndexCount) * MinLodReduction)
+        {
+            break;
+        }
+        previousIndexCount = indexCount;
+
+        ModelLod modelLod = {};
+        modelLod.IndexRangeOffset = static_cast<uint32_t>(lodIndexRanges.size());
+        for (uint32_t i = 0; i < submeshCount; i++)
+        {
+            // Submeshes which could not be simplified any further keep using the previous level's indices
+            const std::vector<uint32_t>& submeshLevelIndices = levelIndices[i * maxLodCount + lod];
+            const IndexRange& previousRange = lodIndexRanges[lodIndexRanges.size() - submeshCount];
+            if (submeshLevelIndices.size() == previousRange.IndexCount)
+            {
+                lodIndexRanges.push_back(previousRange);
+            }
+            else
+            {
+                lodIndexRanges.push_back(IndexRange{ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(submeshLevelIndices.size()) });
+                indices.insert(indices.end(), submeshLevelIndices.begin(), submeshLevelIndices.end());
+            }
+
+            const float error = levelErrors[i * maxLodCount + lod];
+            modelLod.Error = error > modelLod.Error ? error : modelLod.Error;
+        }
+
+        lods.push_back(modelLod);
+    }
+}
+
+const MeshSimplifierStatistics& MeshSimplifier::GetStatistics() const
+{
+    return _statistics;
+}
+
+void MeshSimplifier::PrintStatistics() const
+{
+    std::cout << "MeshSimplifier: " << _statistics.Collapses << " collapses, "
+              << _statistics.LockedVertices << " of " << _statistics.Vertices << " vertices locked on borders and seams\n";
+}
+
+// Builds the quadrics of the given triangles and finds the vertices which must stay where they are
+void MeshSimplifier::PrepareSubmesh(
+    const VertexPositionNormalColorUv* vertices,
+    const uint32_t vertexCount,
+    const std::vector<uint32_t>& submeshIndices)
+{
+    _submeshError = 0.0f;
+    _quadrics.assign(vertexCount, Quadric{});
+    _isLocked.assign(vertexCount, 0);
+
+    // Attribute differences are weighted relative to the submesh's size
+    DirectX::XMVECTOR minimum = DirectX::XMLoadFloat3(&vertices[0].position);
+    DirectX::XMVECTOR maximum = minimum;
+    for (uint32_t i = 1; i < vertexCount; i++)
+    {
+        const DirectX::XMVECTOR position = DirectX::XMLoadFloat3(&vertices[i].position);
+        minimum = DirectX::XMVectorMin(minimum, position);
+        maximum = DirectX::XMVectorMax(maximum, position);
+    }
+    _attributeScale = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVectorSubtract(maximum, minimum)));
+
+    // Area weighted plane quadrics, the error is divided by the weight to be a squared distance again
+    for (size_t i = 0; i < submeshIndices.size(); i += 3)
+    {
+        const DirectX::XMFLOAT3& p0 = vertices[submeshIndices[i + 0]].position;
+        const DirectX::XMVECTOR normal = GetTriangleNormal(p0, vertices[submeshIndices[i + 1]].position, vertices[submeshIndices[i + 2]].position);
+        const float length = DirectX::XMVectorGetX(DirectX::XMVector3Length(normal));
+        if (length == 0.0f)
+        {
+            continue;
+        }
+
+        const double area = 0.5 * length;
+        const double a = DirectX::XMVectorGetX(normal) / length;
+        const double b = DirectX::XMVectorGetY(normal) / length;
+        const double c = DirectX::XMVectorGetZ(normal) / length;
+        const double d = -(a * p0.x + b * p0.y + c * p0.z);
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            Quadric& quadric = _quadrics[submeshIndices[i + corner]];
+            quadric.A00 += area * a * a;
+            quadric.A11 += area * b * b;
+            quadric.A22 += area * c * c;
+            quadric.A01 += area * a * b;
+            quadric.A02 += area * a * c;
+            quadric.A12 += area * b * c;
+            quadric.B0 += area * a * d;
+            quadric.B1 += area * b * d;
+            quadric.B2 += area * c * d;
+            quadric.C += area * d * d;
+            quadric.Weight += area;
+        }
+    }
+
+    // Vertices sharing a position are the two sides of a uv or normal seam
+    std::vector<uint32_t> positionOrder(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        positionOrder[i] = i;
+    }
+    std::sort(positionOrder.begin(), positionOrder.end(), [&](const uint32_t left, const uint32_t right)
+              { return IsPositionLess(vertices[left].position, vertices[right].position); });
+
+    std::vector<uint32_t> positionRemap(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        const bool isSamePosition = i > 0 && !IsPositionLess(vertices[positionOrder[i - 1]].position, vertices[positionOrder[i]].position);
+        positionRemap[positionOrder[i]] = isSamePosition ? positionRemap[positionOrder[i - 1]] : positionOrder[i];
+        if (isSamePosition)
+        {
+            _isLocked[positionOrder[i - 1]] = 1;
+            _isLocked[positionOrder[i]] = 1;
+        }
+    }
+
+    // An edge without its opposite is on a border, one which is there twice is not manifold
+    std::vector<uint64_t> edges;
+    edges.reserve(submeshIndices.size());
+    for (size_t i = 0; i < submeshIndices.size(); i += 3)
+    {
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            const uint64_t from = positionRemap[submeshIndices[i + corner]];
+            const uint64_t to = positionRemap[submeshIndices[i + (corner + 1) % 3]];
+            edges.push_back(from << 32 | to);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+        const uint64_t edge = edges[i];
+        const uint64_t oppositeEdge = (edge & 0xFFFFFFFFull) << 32 | edge >> 32;
+        const bool isDuplicate = (i > 0 && edges[i - 1] == edge) || (i + 1 < edges.size() && edges[i + 1] == edge);
+        if (isDuplicate || !std::binary_search(edges.begin(), edges.end(), oppositeEdge))
+        {
+            _isLocked[static_cast<uint32_t>(edge >> 32)] = 1;
+            _isLocked[static_cast<uint32_t>(edge & 0xFFFFFFFFull)] = 1;
+        }
+    }
+
+    // Locking is decided on positions, every vertex at a locked position is locked
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        _isLocked[i] |= _isLocked[positionRemap[i]];
+    }
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        _isLocked[positionRemap[i]] |= _isLocked[i];
+    }
+
+    _statistics.Vertices += vertexCount;
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        _statistics.LockedVertices += _isLocked[i];
+    }
+}
+
+// Collapses vertices in passes until the target is reached or the next collapse would exceed maxError.
+// Within a pass a vertex whose triangles changed is not touched again, which keeps the checks valid.
+float MeshSimplifier::Simplify(
+    const VertexPositionNormalColorUv* vertices,
+    const uint32_t vertexCount,
+    std::vector<uint32_t>& submeshIndices,
+    const uint32_t targetIndexCount,
+    const float maxError)
+{
+    const float maxCollapseError = maxError * maxError;
+
+    _collapseTargets.resize(vertexCount);
+    _passStamps.assign(vertexCount, 0);
+    _neighborStamps.assign(vertexCount, 0);
+    _passStamp = 0;
+    _neighborStamp = 0;
+
+    while (submeshIndices.size() > targetIndexCount)
+    {
+        BuildAdjacency(submeshIndices, vertexCount);
+
+        _collapses.clear();
+        for (size_t i = 0; i < submeshIndices.size(); i += 3)
+        {
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                const uint32_t source = submeshIndices[i + corner];
+                const uint32_t target = submeshIndices[i + (corner + 1) % 3];
+                if (_isLocked[source] == 0)
+                {
+                    Collapse collapse = { source, target };
+                    EvaluateCollapse(vertices, collapse);
+                    _collapses.push_back(collapse);
+                }
+
+                if (_isLocked[target] == 0)
+                {
+                    Collapse collapse = { target, source };
+                    EvaluateCollapse(vertices, collapse);
+                    _collapses.push_back(collapse);
+                }
+            }
+        }
+
+        std::sort(_collapses.begin(), _collapses.end(), [](const Collapse& left, const Collapse& right)
+                  { return left.Error < right.Error; });
+
+        // An interior collapse removes two triangles
+        const uint32_t maxCollapseCount = (static_cast<uint32_t>(submeshIndices.size()) - targetIndexCount + 5) / 6;
+        uint32_t collapseCount = 0;
+        _passStamp++;
+        for (uint32_t i = 0; i < vertexCount; i++)
+        {
+            _collapseTargets[i] = i;
+        }
+
+        for (const Collapse& collapse : _collapses)
+        {
+            if (collapseCount == maxCollapseCount)
+            {
+                break;
+            }
+
+            if (collapse.GeometricError > maxCollapseError ||
+                _passStamps[collapse.Source] == _passStamp ||
+                _passStamps[collapse.Target] == _passStamp ||
+                !IsCollapseValid(vertices, submeshIndices, collapse))
+            {
+                continue;
+            }
+
+            // Locks the source's whole neighbourhood, its triangles are about to change
+            for (uint32_t j = _triangleOffsets[collapse.Source]; j < _triangleOffsets[collapse.Source + 1]; j++)
+            {
+                const uint32_t triangle = _vertexTriangles[j];
+                for (uint32_t corner = 0; corner < 3; corner++)
+                {
+                    _passStamps[submeshIndices[triangle * 3 + corner]] = _passStamp;
+                }
+            }
+
+            Quadric& target = _quadrics[collapse.Target];
+            const Quadric& source = _quadrics[collapse.Source];
+            target.A00 += source.A00;
+            target.A11 += source.A11;
+            target.A22 += source.A22;
+            target.A01 += source.A01;
+            target.A02 += source.A02;
+            target.A12 += source.A12;
+            target.B0 += source.B0;
+            target.B1 += source.B1;
+            target.B2 += source.B2;
+            target.C += source.C;
+            target.Weight += source.Weight;
+
+            _collapseTargets[collapse.Source] = collapse.Target;
+            _submeshError = collapse.GeometricError > _submeshError ? collapse.GeometricError : _submeshError;
+            collapseCount++;
+        }
+
+        if (collapseCount == 0)
+        {
+            break;
+        }
+        _statistics.Collapses += collapseCount;
+
+        // Triangles which had both ends of a collapsed edge are gone
+        size_t writeIndex = 0;
+        for (size_t i = 0; i < submeshIndices.size(); i += 3)
+        {
+            const uint32_t i0 = _collapseTargets[submeshIndices[i + 0]];
+            const uint32_t i1 = _collapseTargets[submeshIndices[i + 1]];
+            const uint32_t i2 = _collapseTargets[submeshIndices[i + 2]];
+            if (i0 == i1 || i1 == i2 || i0 == i2)
+            {
+                continue;
+            }
+
+            submeshIndices[writeIndex + 0] = i0;
+            submeshIndices[writeIndex + 1] = i1;
+            submeshIndices[writeIndex + 2] = i2;
+            writeIndex += 3;
+        }
+        submeshIndices.resize(writeIndex);
+    }
+
+    return std::sqrt(_submeshError);
+}
+
+void MeshSimplifier::BuildAdjacency(
+    const std::vector<uint32_t>& submeshIndices,
+    const uint32_t vertexCount)
+{
+    _triangleOffsets.assign(vertexCount + 1, 0);
+    for (const uint32_t index : submeshIndices)
+    {
+        _triangleOffsets[index + 1]++;
+    }
+
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        _triangleOffsets[i + 1] += _triangleOffsets[i];
+    }
+
+    _vertexTriangles.resize(submeshIndices.size());
+    _triangleCursors.assign(_triangleOffsets.begin(), _triangleOffsets.end() - 1);
+    for (size_t i = 0; i < submeshIndices.size(); i++)
+    {
+        _vertexTriangles[_triangleCursors[submeshIndices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+}
+
+// Rejects collapses which would make the mesh non manifold or turn one of its triangles over
+bool MeshSimplifier::IsCollapseValid(
+    const VertexPositionNormalColorUv* vertices,
+    const std::vector<uint32_t>& submeshIndices,
+    const Collapse& collapse)
+{
+    // An edge's ends may share only the two vertices opposite of it
+    _neighborStamp++;
+    for (uint32_t i = _triangleOffsets[collapse.Target]; i < _triangleOffsets[collapse.Target + 1]; i++)
+    {
+        const uint32_t triangle = _vertexTriangles[i];
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            _neighborStamps[submeshIndices[triangle * 3 + corner]] = _neighborStamp;
+        }
+    }
+
+    uint32_t sharedNeighborCount = 0;
+    const uint32_t targetStamp = _neighborStamp;
+    _neighborStamp++;
+    for (uint32_t i = _triangleOffsets[collapse.Source]; i < _triangleOffsets[collapse.Source + 1]; i++)
+    {
+        const uint32_t triangle = _vertexTriangles[i];
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            const uint32_t neighbor = submeshIndices[triangle * 3 + corner];
+            if (neighbor == collapse.Source || neighbor == collapse.Target)
+            {
+                continue;
+            }
+
+            if (_neighborStamps[neighbor] == targetStamp)
+            {
+                sharedNeighborCount++;
+            }
+            _neighborStamps[neighbor] = _neighborStamp;
+        }
+    }
+
+    if (sharedNeighborCount > 2)
+    {
+        return false;
+    }
+
+    for (uint32_t i = _triangleOffsets[collapse.Source]; i < _triangleOffsets[collapse.Source + 1]; i++)
+    {
+        const uint32_t* triangle = &submeshIndices[_vertexTriangles[i] * 3];
+        if (triangle[0] == collapse.Target || triangle[1] == collapse.Target || triangle[2] == collapse.Target)
+        {
+            continue;
+        }
+
+        const DirectX::XMFLOAT3& p0 = vertices[triangle[0] == collapse.Source ? collapse.Target : triangle[0]].position;
+        const DirectX::XMFLOAT3& p1 = vertices[triangle[1] == collapse.Source ? collapse.Target : triangle[1]].position;
+        const DirectX::XMFLOAT3& p2 = vertices[triangle[2] == collapse.Source ? collapse.Target : triangle[2]].position;
+        const DirectX::XMVECTOR normal = GetTriangleNormal(vertices[triangle[0]].position, vertices[triangle[1]].position, vertices[triangle[2]].position);
+        const DirectX::XMVECTOR collapsedNormal = GetTriangleNormal(p0, p1, p2);
+        // Triangles turning by more than about 75 degrees are as good as flipped
+        const float normalLengths = DirectX::XMVectorGetX(DirectX::XMVector3Length(normal)) * DirectX::XMVectorGetX(DirectX::XMVector3Length(collapsedNormal));
+        if (DirectX::XMVectorGetX(DirectX::XMVector3Dot(normal, collapsedNormal)) <= 0.25f * normalLengths)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MeshSimplifier::EvaluateCollapse(
+    const VertexPositionNormalColorUv* vertices,
+    Collapse& collapse) const
+{
+    const Quadric& sourceQuadric = _quadrics[collapse.Source];
+    const Quadric& targetQuadric = _quadrics[collapse.Target];
+    const double weight = sourceQuadric.Weight + targetQuadric.Weight;
+
+    // Both quadrics evaluated where the source moves to: p'Ap + 2b'p + c
+    const DirectX::XMFLOAT3& p = vertices[collapse.Target].position;
+    const double x = p.x;
+    const double y = p.y;
+    const double z = p.z;
+    const double a00 = sourceQuadric.A00 + targetQuadric.A00;
+    const double a11 = sourceQuadric.A11 + targetQuadric.A11;
+    const double a22 = sourceQuadric.A22 + targetQuadric.A22;
+    const double a01 = sourceQuadric.A01 + targetQuadric.A01;
+    const double a02 = sourceQuadric.A02 + targetQuadric.A02;
+    const double a12 = sourceQuadric.A12 + targetQuadric.A12;
+    const double b0 = sourceQuadric.B0 + targetQuadric.B0;
+    const double b1 = sourceQuadric.B1 + targetQuadric.B1;
+    const double b2 = sourceQuadric.B2 + targetQuadric.B2;
+    const double c = sourceQuadric.C + targetQuadric.C;
+    const double error = a00 * x * x + a11 * y * y + a22 * z * z +
+                         2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                         2.0 * (b0 * x + b1 * y + b2 * z) + c;
+    collapse.GeometricError = weight > 0.0 ? static_cast<float>(std::fabs(error) / weight) : 0.0f;
+
+    // The source's triangles take on the target's attributes
+    const VertexPositionNormalColorUv& sourceVertex = vertices[collapse.Source];
+    const VertexPositionNormalColorUv& targetVertex = vertices[collapse.Target];
+    const float normalWeight = _attributeWeights.Normal * _attributeScale;
+    const float colorWeight = _attributeWeights.Color * _attributeScale;
+    const float uvWeight = _attributeWeights.Uv * _attributeScale;
+    const float attributeError = normalWeight * normalWeight * GetSquaredDistance(sourceVertex.normal, targetVertex.normal) +
+                                 colorWeight * colorWeight * GetSquaredDistance(sourceVertex.color, targetVertex.color) +
+                                 uvWeight * uvWeight * GetSquaredDistance(sourceVertex.uv, targetVertex.uv);
+    collapse.Error = collapse.GeometricError + attributeError;
+}
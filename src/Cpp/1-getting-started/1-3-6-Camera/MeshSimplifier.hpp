@@ -0,0 +1,116 @@
+#pragma once
+
+#include "VertexType.hpp"
+
+#include <cstdint>
+#include <vector>
+
+struct IndexRange;
+struct ModelLod;
+struct Submesh;
+
+struct MeshSimplifierStatistics
+{
+    uint32_t Collapses = 0;
+    uint32_t LockedVertices = 0;
+    uint32_t Vertices = 0;
+};
+
+// Distance in model space which changing a vertex' attributes by one unit counts as,
+// relative to the size of the submesh the vertex belongs to
+struct MeshSimplifierAttributeWeights
+{
+    float Normal = 0.5f;
+    float Color = 0.25f;
+    float Uv = 1.0f;
+};
+
+// Generates a chain of detail levels by collapsing vertices onto one of their neighbours,
+// cheapest first as measured by the quadric error of the triangles around them plus the weighted
+// change of attributes. Only the quadric error is limited and recorded, it is a distance in model space.
+// Border and seam vertices, which share their position with a vertex with different attributes,
+// are never removed. Levels only reference existing vertices, their indices are appended to the index buffer.
+class MeshSimplifier
+{
+public:
+    MeshSimplifier(const MeshSimplifierAttributeWeights& attributeWeights);
+
+    // Level 0 is the unsimplified model. Each level keeps lodReduction of the previous level's
+    // triangles, generation stops early when that cannot be reached within maxError.
+    void GenerateLods(
+        const std::vector<VertexPositionNormalColorUv>& vertices,
+        std::vector<uint32_t>& indices,
+        const std::vector<Submesh>& submeshes,
+        uint32_t maxLodCount,
+        float lodReduction,
+        float maxError,
+        std::vector<ModelLod>& lods,
+        std::vector<IndexRange>& lodIndexRanges);
+
+    [[nodiscard]] const MeshSimplifierStatistics& GetStatistics() const;
+    void PrintStatistics() const;
+
+private:
+    struct Quadric
+    {
+        double A00 = 0.0;
+        double A11 = 0.0;
+        double A22 = 0.0;
+        double A01 = 0.0;
+        double A02 = 0.0;
+        double A12 = 0.0;
+        double B0 = 0.0;
+        double B1 = 0.0;
+        double B2 = 0.0;
+        double C = 0.0;
+        double Weight = 0.0;
+    };
+
+    struct Collapse
+    {
+        uint32_t Source = 0;
+        uint32_t Target = 0;
+        float Error = 0.0f;
+        float GeometricError = 0.0f;
+    };
+
+    void PrepareSubmesh(
+        const VertexPositionNormalColorUv* vertices,
+        uint32_t vertexCount,
+        const std::vector<uint32_t>& submeshIndices);
+    float Simplify(
+        const VertexPositionNormalColorUv* vertices,
+        uint32_t vertexCount,
+        std::vector<uint32_t>& submeshIndices,
+        uint32_t targetIndexCount,
+        float maxError);
+    void BuildAdjacency(
+        const std::vector<uint32_t>& submeshIndices,
+        uint32_t vertexCount);
+    [[nodiscard]] bool IsCollapseValid(
+        const VertexPositionNormalColorUv* vertices,
+        const std::vector<uint32_t>& submeshIndices,
+        const Collapse& collapse);
+    void EvaluateCollapse(
+        const VertexPositionNormalColorUv* vertices,
+        Collapse& collapse) const;
+
+    MeshSimplifierAttributeWeights _attributeWeights = {};
+    MeshSimplifierStatistics _statistics = {};
+    float _attributeScale = 0.0f;
+    // Largest squared geometric error of any collapse applied to the current submesh so far
+    float _submeshError = 0.0f;
+
+    // Scratch memory reused between submeshes
+    std::vector<Quadric> _quadrics;
+    std::vector<uint8_t> _isLocked;
+    std::vector<uint32_t> _collapseTargets;
+    std::vector<uint32_t> _passStamps;
+    std::vector<uint32_t> _neighborStamps;
+    std::vector<uint32_t> _triangleOffsets;
+    std::vector<uint32_t> _vertexTriangles;
+    std::vector<Collapse> _collapses;
+    std::vector<uint32_t> _triangleCursors;
+    uint32_t _passStamp = 0;
+    uint32_t _neighborStamp = 0;
+};
@@ -0,0 +1,177 @@
+#include "MeshletBuilder.hpp"
+#include "Model.hpp"
+
+#include <cmath>
+#include <iostream>
+
+MeshletBuilder::MeshletBuilder(
+    const uint32_t maxVertices,
+    const uint32_t maxTriangles)
+{
+    _maxVertices = maxVertices;
+    _maxTriangles = maxTriangles;
+}
+
+void MeshletBuilder::Build(
+    const std::vector<VertexPositionNormalColorUv>& vertices,
+    const std::vector<uint32_t>& indices,
+    std::vector<Submesh>& submeshes,
+    std::vector<Meshlet>& meshlets)
+{
+    _statistics = {};
+    meshlets.clear();
+
+    for (Submesh& submesh : submeshes)
+    {
+        const VertexPositionNormalColorUv* submeshVertices = &vertices[submesh.BaseVertex];
+        const uint32_t* submeshIndices = &indices[submesh.IndexOffset];
+        submesh.MeshletOffset = static_cast<uint32_t>(meshlets.size());
+
+        // A vertex belongs to the current meshlet when its stamp matches the meshlet's
+        _vertexStamps.assign(submesh.VertexCount, 0);
+        uint32_t stamp = 1;
+        _meshletVertices.clear();
+
+        Meshlet meshlet = {};
+        meshlet.IndexOffset = submesh.IndexOffset;
+        for (uint32_t i = 0; i < submesh.IndexCount; i += 3)
+        {
+            uint32_t newVertexCount = 0;
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                newVertexCount += _vertexStamps[submeshIndices[i + corner]] != stamp ? 1 : 0;
+            }
+
+            if (_meshletVertices.size() + newVertexCount > _maxVertices || meshlet.IndexCount == _maxTriangles * 3)
+            {
+                ComputeBounds(submeshVertices, &indices[meshlet.IndexOffset], meshlet);
+                meshlets.push_back(meshlet);
+
+                meshlet = {};
+                meshlet.IndexOffset = submesh.IndexOffset + i;
+                stamp++;
+                _meshletVertices.clear();
+            }
+
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                const uint32_t vertex = submeshIndices[i + corner];
+                if (_vertexStamps[vertex] != stamp)
+                {
+                    _vertexStamps[vertex] = stamp;
+                    _meshletVertices.push_back(vertex);
+                }
+            }
+            meshlet.IndexCount += 3;
+        }
+
+        if (meshlet.IndexCount > 0)
+        {
+            ComputeBounds(submeshVertices, &indices[meshlet.IndexOffset], meshlet);
+            meshlets.push_back(meshlet);
+        }
+
+        submesh.MeshletCount = static_cast<uint32_t>(meshlets.size()) - submesh.MeshletOffset;
+    }
+
+    _statistics.Meshlets = static_cast<uint32_t>(meshlets.size());
+}
+
+const MeshletBuilderStatistics& MeshletBuilder::GetStatistics() const
+{
+    return _statistics;
+}
+
+void MeshletBuilder::PrintStatistics() const
+{
+    const float meshlets = _statistics.Meshlets == 0 ? 1.0f : static_cast<float>(_statistics.Meshlets);
+    std::cout << "MeshletBuilder: " << _statistics.Meshlets << " meshlets, "
+              << static_cast<float>(_statistics.Triangles) / meshlets << " triangles and "
+              << static_cast<float>(_statistics.MeshletVertices) / meshlets << " vertices on average, "
+              << _statistics.MeshletsWithCone << " can be backface culled\n";
+}
+
+// The sphere is centered on the meshlet's bounding box. The cone contains every triangle
+// normal, its apex is placed so that a camera outside of it cannot see any of the triangles.
+void MeshletBuilder::ComputeBounds(
+    const VertexPositionNormalColorUv* vertices,
+    const uint32_t* indices,
+    Meshlet& meshlet)
+{
+    _statistics.Triangles += meshlet.IndexCount / 3;
+    _statistics.MeshletVertices += static_cast<uint32_t>(_meshletVertices.size());
+
+    DirectX::XMVECTOR minimum = DirectX::XMLoadFloat3(&vertices[_meshletVertices[0]].position);
+    DirectX::XMVECTOR maximum = minimum;
+    for (const uint32_t vertex : _meshletVertices)
+    {
+        const DirectX::XMVECTOR position = DirectX::XMLoadFloat3(&vertices[vertex].position);
+        minimum = DirectX::XMVectorMin(minimum, position);
+        maximum = DirectX::XMVectorMax(maximum, position);
+    }
+
+    const DirectX::XMVECTOR center = DirectX::XMVectorScale(DirectX::XMVectorAdd(minimum, maximum), 0.5f);
+    float radius = 0.0f;
+    for (const uint32_t vertex : _meshletVertices)
+    {
+        const DirectX::XMVECTOR position = DirectX::XMLoadFloat3(&vertices[vertex].position);
+        const float distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMVectorSubtract(position, center)));
+        radius = distance > radius ? distance : radius;
+    }
+
+    DirectX::XMStoreFloat3(&meshlet.Center, center);
+    meshlet.Radius = radius;
+
+    // Counter clockwise triangles face towards cross(p1 - p0, p2 - p0)
+    DirectX::XMVECTOR axis = DirectX::XMVectorZero();
+    for (uint32_t i = 0; i < meshlet.IndexCount; i += 3)
+    {
+        const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&vertices[indices[i + 0]].position);
+        const DirectX::XMVECTOR p1 = DirectX::XMLoadFloat3(&vertices[indices[i + 1]].position);
+        const DirectX::XMVECTOR p2 = DirectX::XMLoadFloat3(&vertices[indices[i + 2]].position);
+        const DirectX::XMVECTOR normal = DirectX::XMVector3Cross(DirectX::XMVectorSubtract(p1, p0), DirectX::XMVectorSubtract(p2, p0));
+        axis = DirectX::XMVectorAdd(axis, DirectX::XMVector3Normalize(normal));
+    }
+    axis = DirectX::XMVector3Normalize(axis);
+
+    float minimumDot = 1.0f;
+    for (uint32_t i = 0; i < meshlet.IndexCount && minimumDot > 0.0f; i += 3)
+    {
+        const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&vertices[indices[i + 0]].position);
+        const DirectX::XMVECTOR p1 = DirectX::XMLoadFloat3(&vertices[indices[i + 1]].position);
+        const DirectX::XMVECTOR p2 = DirectX::XMLoadFloat3(&vertices[indices[i + 2]].position);
+        const DirectX::XMVECTOR normal = DirectX::XMVector3Normalize(
+            DirectX::XMVector3Cross(DirectX::XMVectorSubtract(p1, p0), DirectX::XMVectorSubtract(p2, p0)));
+        const float dot = DirectX::XMVectorGetX(DirectX::XMVector3Dot(normal, axis));
+        minimumDot = dot < minimumDot ? dot : minimumDot;
+    }
+
+    // Normals spread over a half space or more, some triangle is always visible
+    if (minimumDot <= 0.0f)
+    {
+        meshlet.ConeApex = meshlet.Center;
+        meshlet.ConeAxis = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+        meshlet.ConeCutoff = 1.0f;
+        return;
+    }
+
+    // Moves the apex back along the axis until every triangle's plane lies in front of it
+    float apexDistance = 0.0f;
+    for (uint32_t i = 0; i < meshlet.IndexCount; i += 3)
+    {
+        const DirectX::XMVECTOR p0 = DirectX::XMLoadFloat3(&vertices[indices[i + 0]].position);
+        const DirectX::XMVECTOR p1 = DirectX::XMLoadFloat3(&vertices[indices[i + 1]].position);
+        const DirectX::XMVECTOR p2 = DirectX::XMLoadFloat3(&vertices[indices[i + 2]].position);
+        const DirectX::XMVECTOR normal = DirectX::XMVector3Normalize(
+            DirectX::XMVector3Cross(DirectX::XMVectorSubtract(p1, p0), DirectX::XMVectorSubtract(p2, p0)));
+        const float centerDistance = DirectX::XMVectorGetX(DirectX::XMVector3Dot(DirectX::XMVectorSubtract(center, p0), normal));
+        const float axisDot = DirectX::XMVectorGetX(DirectX::XMVector3Dot(axis, normal));
+        const float distance = centerDistance / axisDot;
+        apexDistance = distance > apexDistance ? distance : apexDistance;
+    }
+
+    DirectX::XMStoreFloat3(&meshlet.ConeApex, DirectX::XMVectorSubtract(center, DirectX::XMVectorScale(axis, apexDistance)));
+    DirectX::XMStoreFloat3(&meshlet.ConeAxis, axis);
+    meshlet.ConeCutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+    _statistics.MeshletsWithCone++;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "VertexType.hpp"
+
+#include <cstdint>
+#include <vector>
+
+struct Meshlet;
+struct Submesh;
+
+struct MeshletBuilderStatistics
+{
+    uint32_t Meshlets = 0;
+    uint32_t Triangles = 0;
+    uint32_t MeshletVertices = 0;
+    uint32_t MeshletsWithCone = 0;
+};
+
+// Partitions the triangles of every submesh, in index buffer order, into meshlets of at most
+// maxVertices unique vertices and maxTriangles triangles, and computes a bounding sphere and
+// a backface cone for each. Triangles stay where they are, a meshlet is a range of indices.
+class MeshletBuilder
+{
+public:
+    MeshletBuilder(
+        uint32_t maxVertices,
+        uint32_t maxTriangles);
+
+    void Build(
+        const std::vector<VertexPositionNormalColorUv>& vertices,
+        const std::vector<uint32_t>& indices,
+        std::vector<Submesh>& submeshes,
+        std::vector<Meshlet>& meshlets);
+
+    [[nodiscard]] const MeshletBuilderStatistics& GetStatistics() const;
+    void PrintStatistics() const;
+
+private:
+    void ComputeBounds(
+        const VertexPositionNormalColorUv* vertices,
+        const uint32_t* indices,
+        Meshlet& meshlet);
+
+    uint32_t _maxVertices = 64;
+    uint32_t _maxTriangles = 124;
+    MeshletBuilderStatistics _statistics = {};
+
+    // Scratch memory reused between meshlets
+    std::vector<uint32_t> _vertexStamps;
+    std::vector<uint32_t> _meshletVertices;
+};
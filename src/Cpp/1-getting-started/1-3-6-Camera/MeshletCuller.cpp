@@ -0,0 +1,153 @@
+#include "MeshletCuller.hpp"
+#include "Camera.hpp"
+#include "Model.hpp"
+#include "RenderBackend.hpp"
+
+#include <DirectXCollision.h>
+
+#include <cstring>
+#include <iostream>
+
+MeshletCuller::MeshletCuller(const std::shared_ptr<RenderBackend>& renderBackend)
+{
+    _renderBackend = renderBackend;
+}
+
+bool MeshletCuller::Initialize(const Model& model)
+{
+    _indexBuffer.reset();
+    _culledSubmeshes.clear();
+    if (model.IndexData.empty())
+    {
+        return true;
+    }
+
+    // Only the full detail level is split into meshlets
+    uint32_t indexCount = 0;
+    for (const Submesh& submesh : model.Submeshes)
+    {
+        indexCount += submesh.IndexCount;
+    }
+
+    RenderBufferDescription bufferDescription = {};
+    bufferDescription.Size = GetIndexSize(model.IndexFormat) * indexCount;
+    bufferDescription.Usage = RenderUsage::Dynamic;
+    bufferDescription.BindFlags = RenderBindFlags::RenderBindIndexBuffer;
+    if (!_renderBackend->CreateBuffer(
+            bufferDescription,
+            nullptr,
+            _indexBuffer))
+    {
+        std::cout << "MeshletCuller: Failed to create meshlet index buffer\n";
+        return false;
+    }
+
+    return true;
+}
+
+void MeshletCuller::Cull(
+    const Model& model,
+    const DirectX::XMFLOAT4X4& worldMatrix,
+    Camera& camera,
+    const bool cullBackfaces)
+{
+    _statistics = {};
+    _culledSubmeshes.clear();
+    if (_indexBuffer == nullptr)
+    {
+        return;
+    }
+
+    // Meshlet bounds stay in model space, the frustum and the camera are brought there instead
+    const DirectX::XMFLOAT4X4 viewMatrix = camera.GetViewMatrix();
+    const DirectX::XMFLOAT4X4 projectionMatrix = camera.GetProjectionMatrix();
+    const DirectX::XMMATRIX modelViewMatrix = DirectX::XMMatrixMultiply(
+        DirectX::XMLoadFloat4x4(&worldMatrix),
+        DirectX::XMLoadFloat4x4(&viewMatrix));
+    const DirectX::XMMATRIX viewToModelMatrix = DirectX::XMMatrixInverse(nullptr, modelViewMatrix);
+
+    DirectX::BoundingFrustum frustum(DirectX::XMLoadFloat4x4(&projectionMatrix), true);
+    frustum.Transform(frustum, viewToModelMatrix);
+    const DirectX::XMVECTOR cameraPosition = DirectX::XMVector3TransformCoord(DirectX::XMVectorZero(), viewToModelMatrix);
+
+    RenderMappedSubresource mappedIndexBuffer = {};
+    if (!_renderBackend->Map(_indexBuffer.get(), 0, RenderMapType::WriteDiscard, &mappedIndexBuffer))
+    {
+        std::cout << "MeshletCuller: Failed to map meshlet index buffer\n";
+        return;
+    }
+
+    const size_t indexSize = GetIndexSize(model.IndexFormat);
+    uint8_t* culledIndices = static_cast<uint8_t*>(mappedIndexBuffer.Data);
+    uint32_t culledIndexCount = 0;
+    for (uint32_t submeshIndex = 0; submeshIndex < model.Submeshes.size(); submeshIndex++)
+    {
+        const Submesh& submesh = model.Submeshes[submeshIndex];
+        _statistics.Meshlets += submesh.MeshletCount;
+
+        // Submeshes entirely outside of the frustum skip testing their meshlets one by one
+        if (!frustum.Intersects(submesh.SphereBounds))
+        {
+            _statistics.FrustumCulledMeshlets += submesh.MeshletCount;
+            continue;
+        }
+
+        CulledSubmesh culledSubmesh = {};
+        culledSubmesh.SubmeshIndex = submeshIndex;
+        culledSubmesh.IndexOffset = culledIndexCount;
+
+        for (uint32_t i = 0; i < submesh.MeshletCount; i++)
+        {
+            const Meshlet& meshlet = model.Meshlets[submesh.MeshletOffset + i];
+
+            const DirectX::BoundingSphere bounds(meshlet.Center, meshlet.Radius);
+            if (!frustum.Intersects(bounds))
+            {
+                _statistics.FrustumCulledMeshlets++;
+                continue;
+            }
+
+            if (cullBackfaces && meshlet.ConeCutoff < 1.0f)
+            {
+                const DirectX::XMVECTOR viewDirection = DirectX::XMVector3Normalize(
+                    DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&meshlet.ConeApex), cameraPosition));
+                if (DirectX::XMVectorGetX(DirectX::XMVector3Dot(viewDirection, DirectX::XMLoadFloat3(&meshlet.ConeAxis))) >= meshlet.ConeCutoff)
+                {
+                    _statistics.BackfaceCulledMeshlets++;
+                    continue;
+                }
+            }
+
+            // Surviving meshlets of a submesh are packed back to back, so one draw still covers the submesh
+            std::memcpy(
+                culledIndices + indexSize * (culledSubmesh.IndexOffset + culledSubmesh.IndexCount),
+                model.IndexData.data() + indexSize * meshlet.IndexOffset,
+                indexSize * meshlet.IndexCount);
+            culledSubmesh.IndexCount += meshlet.IndexCount;
+        }
+
+        if (culledSubmesh.IndexCount > 0)
+        {
+            culledIndexCount += culledSubmesh.IndexCount;
+            _culledSubmeshes.push_back(culledSubmesh);
+        }
+    }
+
+    _renderBackend->Unmap(_indexBuffer.get(), 0);
+    _statistics.SubmittedTriangles = culledIndexCount / 3;
+}
+
+const std::shared_ptr<RenderBuffer>& MeshletCuller::GetIndexBuffer() const
+{
+    return _indexBuffer;
+}
+
+const std::vector<CulledSubmesh>& MeshletCuller::GetCulledSubmeshes() const
+{
+    return _culledSubmeshes;
+}
+
+const MeshletCullingStatistics& MeshletCuller::GetStatistics() const
+{
+    return _statistics;
+}
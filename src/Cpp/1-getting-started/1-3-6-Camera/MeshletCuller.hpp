@@ -0,0 +1,54 @@
+#pragma once
+
+#include "RenderTypes.hpp"
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Camera;
+class RenderBackend;
+struct Model;
+
+struct MeshletCullingStatistics
+{
+    uint32_t Meshlets = 0;
+    uint32_t FrustumCulledMeshlets = 0;
+    uint32_t BackfaceCulledMeshlets = 0;
+    uint32_t SubmittedTriangles = 0;
+};
+
+// A submesh's surviving triangles, a range of the culler's index buffer
+struct CulledSubmesh
+{
+    uint32_t SubmeshIndex = 0;
+    uint32_t IndexOffset = 0;
+    uint32_t IndexCount = 0;
+};
+
+// Tests every meshlet of a model against the camera's frustum and backface cone each frame
+// and writes the indices of the visible ones, submesh by submesh, into a dynamic index buffer
+class MeshletCuller
+{
+public:
+    MeshletCuller(const std::shared_ptr<RenderBackend>& renderBackend);
+
+    bool Initialize(const Model& model);
+    void Cull(
+        const Model& model,
+        const DirectX::XMFLOAT4X4& worldMatrix,
+        Camera& camera,
+        bool cullBackfaces);
+
+    [[nodiscard]] const std::shared_ptr<RenderBuffer>& GetIndexBuffer() const;
+    [[nodiscard]] const std::vector<CulledSubmesh>& GetCulledSubmeshes() const;
+    [[nodiscard]] const MeshletCullingStatistics& GetStatistics() const;
+
+private:
+    std::shared_ptr<RenderBackend> _renderBackend = nullptr;
+    std::shared_ptr<RenderBuffer> _indexBuffer = nullptr;
+    std::vector<CulledSubmesh> _culledSubmeshes;
+    MeshletCullingStatistics _statistics = {};
+};
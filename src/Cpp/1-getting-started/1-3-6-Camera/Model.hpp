@@ -0,0 +1,78 @@
+#pragma once
+
+#include "GeometryPool.hpp"
+#include "RenderTypes.hpp"
+#include "VertexType.hpp"
+
+#include <DirectXCollision.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// A range of the model's index buffer drawn with one DrawIndexed call.
+// Indices are relative to BaseVertex, bounds are in model space.
+// Quantized positions are turned back into model space as position * PositionScale + PositionOffset.
+struct Submesh
+{
+    uint32_t IndexOffset = 0;
+    uint32_t IndexCount = 0;
+    int32_t BaseVertex = 0;
+    uint32_t VertexCount = 0;
+    uint32_t MaterialIndex = 0;
+    DirectX::BoundingBox Bounds = {};
+    DirectX::BoundingSphere SphereBounds = {};
+    DirectX::XMFLOAT3 PositionScale = { 1.0f, 1.0f, 1.0f };
+    DirectX::XMFLOAT3 PositionOffset = { 0.0f, 0.0f, 0.0f };
+    uint32_t MeshletOffset = 0;
+    uint32_t MeshletCount = 0;
+};
+
+// A small cluster of a submesh's triangles, culled as a whole on the CPU.
+// Its indices are a range of the model's index buffer, bounds and cone are in model space.
+// All triangles face away from a camera for which dot(normalize(ConeApex - camera), ConeAxis) >= ConeCutoff.
+struct Meshlet
+{
+    uint32_t IndexOffset = 0;
+    uint32_t IndexCount = 0;
+    DirectX::XMFLOAT3 Center = { 0.0f, 0.0f, 0.0f };
+    float Radius = 0.0f;
+    DirectX::XMFLOAT3 ConeApex = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 ConeAxis = { 0.0f, 0.0f, 0.0f };
+    float ConeCutoff = 1.0f;
+};
+
+struct IndexRange
+{
+    uint32_t IndexOffset = 0;
+    uint32_t IndexCount = 0;
+};
+
+// A detail level of the whole model, with one range of the index buffer per submesh starting at
+// IndexRangeOffset in LodIndexRanges. Error is how far in model space it deviates from level 0.
+struct ModelLod
+{
+    uint32_t IndexRangeOffset = 0;
+    float Error = 0.0f;
+};
+
+// Every mesh of a model file packed into one range of the geometry pool's vertex and index buffers
+struct Model
+{
+    GeometryHandle Geometry = InvalidGeometryHandle;
+    ::VertexType VertexType = VertexType::PositionColorUv;
+    RenderFormat IndexFormat = RenderFormat::R32Uint;
+    uint32_t VertexCount = 0;
+    uint32_t IndexCount = 0;
+    std::vector<Submesh> Submeshes;
+    std::vector<Meshlet> Meshlets;
+    // Empty for models without generated detail levels, level 0 is drawn from the submeshes then
+    std::vector<ModelLod> Lods;
+    std::vector<IndexRange> LodIndexRanges;
+    // CPU copy of the index buffer, only kept for models with meshlets
+    std::vector<uint8_t> IndexData;
+    DirectX::BoundingBox Bounds = {};
+    DirectX::BoundingSphere SphereBounds = {};
+    // Set for models imported with ModelProcessingBuildTextureAtlas, every submesh samples this texture then
+    std::filesystem::path TextureAtlasFilePath;
+};
@@ -1,5 +1,18 @@
 #include "ModelFactory.hpp"
+#include "GeometryPool.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "MeshletBuilder.hpp"
+#include "Model.hpp"
+#include "TextureAtlasBuilder.hpp"
 #include "VertexType.hpp"
+#include "VertexWelder.hpp"
+
+#include <Hash.hpp>
+#include <JobSystem.hpp>
+#include <MemoryMappedFile.hpp>
+
+#include <DirectXPackedVector.h>
 
 #undef min
 #undef max
@@ -8,26 +21,1049 @@
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <vector>
 
-ModelFactory::ModelFactory(const WRL::ComPtr<ID3D11Device>& device)
+namespace
+{
+constexpr uint32_t ImportFlags = aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs;
+
+// Changing this requires bumping CookedModelVersion
+constexpr float ApproximateWeldEpsilon = 0.0001f;
+
+constexpr uint32_t CookedModelMagic = 0x4D43444C; // "LDCM"
+constexpr uint32_t CookedModelVersion = 11;
+
+// Followed by the texture dependencies, the submesh, meshlet, lod and lod index range tables,
+// the vertices and the indices, each stored as they are in memory
+struct CookedModelHeader
+{
+    uint32_t Magic = CookedModelMagic;
+    uint32_t Version = CookedModelVersion;
+    uint64_t SourceHash = 0;
+    uint64_t SourceSize = 0;
+    int64_t SourceLastWriteTime = 0;
+    uint32_t ImportFlags = 0;
+    uint32_t ProcessingFlags = 0;
+    uint32_t VertexType = 0;
+    uint32_t VertexStride = 0;
+    uint32_t IndexFormat = 0;
+    uint32_t SubmeshStride = 0;
+    uint32_t MeshletStride = 0;
+    uint32_t LodStride = 0;
+    uint32_t IndexRangeStride = 0;
+    uint32_t MaxLodCount = 0;
+    float LodReduction = 0.0f;
+    float MaxRelativeLodError = 0.0f;
+    uint32_t VertexCount = 0;
+    uint32_t IndexCount = 0;
+    uint32_t SubmeshCount = 0;
+    uint32_t MeshletCount = 0;
+    uint32_t LodCount = 0;
+    uint32_t IndexRangeCount = 0;
+    // Set when the uvs point into the texture atlas written next to the cooked model
+    uint32_t HasTextureAtlas = 0;
+    uint32_t TextureDependencyCount = 0;
+    uint32_t TextureDependencySize = 0;
+};
+
+// A texture packed into the model's atlas, followed by PathSize bytes of its UTF-8 path. The
+// source hash only covers the model file, so the texture's size and last write time are checked
+// on every load instead, changing a texture imports the model and builds the atlas again.
+struct CookedTextureDependency
+{
+    uint64_t FileSize = 0;
+    int64_t LastWriteTime = 0;
+    uint32_t PathSize = 0;
+    uint32_t Reserved = 0;
+};
+
+bool GetFileStamp(
+    const std::filesystem::path& filePath,
+    uint64_t& fileSize,
+    int64_t& lastWriteTime)
+{
+    std::error_code errorCode;
+    const uintmax_t size = std::filesystem::file_size(filePath, errorCode);
+    if (errorCode)
+    {
+        return false;
+    }
+
+    const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(filePath, errorCode);
+    if (errorCode)
+    {
+        return false;
+    }
+
+    fileSize = static_cast<uint64_t>(size);
+    lastWriteTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+bool HashFile(
+    const std::filesystem::path& filePath,
+    uint64_t& hash)
+{
+    MemoryMappedFile file;
+    if (!file.Open(filePath))
+    {
+        return false;
+    }
+
+    hash = HashBytes(file.GetData(), file.GetSize());
+    return true;
+}
+
+bool GetTextureDependency(
+    const std::filesystem::path& filePath,
+    CookedTextureDependency& dependency)
+{
+    return GetFileStamp(filePath, dependency.FileSize, dependency.LastWriteTime);
+}
+
+// A damaged or stale file with matching counts must not make the model read past its buffers,
+// so every range the tables hold is checked against the counts in the header
+bool AreCookedRangesValid(
+    const CookedModelHeader& header,
+    const std::vector<Submesh>& submeshes,
+    const std::vector<Meshlet>& meshlets,
+    const std::vector<ModelLod>& lods,
+    const std::vector<IndexRange>& lodIndexRanges)
+{
+    const auto isInRange = [](const uint64_t offset, const uint64_t count, const uint64_t capacity)
+    {
+        return offset <= capacity && count <= capacity - offset;
+    };
+
+    for (const Submesh& submesh : submeshes)
+    {
+        if (submesh.BaseVertex < 0 ||
+            !isInRange(static_cast<uint64_t>(submesh.BaseVertex), submesh.VertexCount, header.VertexCount) ||
+            !isInRange(submesh.IndexOffset, submesh.IndexCount, header.IndexCount) ||
+            !isInRange(submesh.MeshletOffset, submesh.MeshletCount, header.MeshletCount))
+        {
+            return false;
+        }
+    }
+
+    for (const Meshlet& meshlet : meshlets)
+    {
+        if (!isInRange(meshlet.IndexOffset, meshlet.IndexCount, header.IndexCount))
+        {
+            return false;
+        }
+    }
+
+    for (const ModelLod& lod : lods)
+    {
+        if (!isInRange(lod.IndexRangeOffset, header.SubmeshCount, header.IndexRangeCount))
+        {
+            return false;
+        }
+    }
+
+    for (const IndexRange& indexRange : lodIndexRanges)
+    {
+        if (!isInRange(indexRange.IndexOffset, indexRange.IndexCount, header.IndexCount))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void WriteTextureDependencies(
+    const std::vector<std::filesystem::path>& texturePaths,
+    std::vector<uint8_t>& dependencyData)
+{
+    dependencyData.clear();
+    for (const std::filesystem::path& texturePath : texturePaths)
+    {
+        const std::string path = texturePath.u8string();
+        CookedTextureDependency dependency = {};
+        GetTextureDependency(texturePath, dependency);
+        dependency.PathSize = static_cast<uint32_t>(path.size());
+
+        const size_t offset = dependencyData.size();
+        dependencyData.resize(offset + sizeof(CookedTextureDependency) + path.size());
+        std::memcpy(dependencyData.data() + offset, &dependency, sizeof(CookedTextureDependency));
+        std::memcpy(dependencyData.data() + offset + sizeof(CookedTextureDependency), path.data(), path.size());
+    }
+}
+
+// False as soon as one texture is gone or differs from when it was packed, or the table does not add up
+bool AreTextureDependenciesCurrent(
+    const uint8_t* dependencyData,
+    const size_t dependencySize,
+    const uint32_t dependencyCount)
+{
+    size_t offset = 0;
+    for (uint32_t i = 0; i < dependencyCount; i++)
+    {
+        CookedTextureDependency dependency = {};
+        if (dependencySize - offset < sizeof(CookedTextureDependency))
+        {
+            return false;
+        }
+
+        std::memcpy(&dependency, dependencyData + offset, sizeof(CookedTextureDependency));
+        offset += sizeof(CookedTextureDependency);
+        if (dependencySize - offset < dependency.PathSize)
+        {
+            return false;
+        }
+
+        const std::string path(reinterpret_cast<const char*>(dependencyData + offset), dependency.PathSize);
+        offset += dependency.PathSize;
+        CookedTextureDependency currentDependency = {};
+        if (!GetTextureDependency(std::filesystem::u8path(path), currentDependency) ||
+            currentDependency.FileSize != dependency.FileSize ||
+            currentDependency.LastWriteTime != dependency.LastWriteTime)
+        {
+            return false;
+        }
+    }
+
+    return offset == dependencySize;
+}
+
+// Lod settings only matter, and only invalidate the cooked model, when lods are generated
+void WriteLodSettings(
+    CookedModelHeader& header,
+    const uint32_t processingFlags,
+    const ModelLodSettings& lodSettings)
+{
+    if ((processingFlags & ModelProcessingFlags::ModelProcessingGenerateLods) != 0)
+    {
+        header.MaxLodCount = lodSettings.MaxLodCount;
+        header.LodReduction = lodSettings.LodReduction;
+        header.MaxRelativeLodError = lodSettings.MaxRelativeError;
+    }
+}
+
+constexpr Normal DefaultNormal = Normal{ 0.0f, 1.0f, 0.0f };
+constexpr Color DefaultColor = Color{ 0.5f, 0.5f, 0.5f };
+constexpr Uv DefaultUv = Uv{ 0.0f, 0.0f };
+
+// Positions are imported at a tenth of their size
+constexpr float ImportScale = 0.1f;
+
+// Vertices or triangles converted by one job, larger meshes are split across several
+constexpr uint32_t ImportJobSize = 1 << 16;
+
+static_assert(sizeof(aiVector3D) == sizeof(DirectX::XMFLOAT3), "Positions and normals are read as XMFLOAT3 streams");
+static_assert(sizeof(aiColor4D) == sizeof(DirectX::XMFLOAT4), "Colors are read as XMFLOAT4s");
+
+// Vertices whose colors and uvs are loaded together before any of them is stored
+constexpr uint32_t AttributeBatchSize = 4;
+
+// A mesh as referenced by a node, meshes referenced by several nodes become several submeshes
+struct MeshInstance
+{
+    const aiMesh* Mesh = nullptr;
+    DirectX::XMFLOAT4X4 Transform = {};
+    DirectX::XMFLOAT4X4 NormalTransform = {};
+    uint32_t SubmeshIndex = 0;
+};
+
+// A range of one mesh instance's vertices or triangles
+struct ImportJob
+{
+    uint32_t InstanceIndex = 0;
+    uint32_t First = 0;
+    uint32_t Count = 0;
+    bool IsVertexJob = false;
+};
+
+DirectX::XMMATRIX LoadTransform(const aiMatrix4x4& transform)
+{
+    // Assimp transforms column vectors, DirectXMath row vectors
+    return DirectX::XMMatrixSet(
+        transform.a1, transform.b1, transform.c1, transform.d1,
+        transform.a2, transform.b2, transform.c2, transform.d2,
+        transform.a3, transform.b3, transform.c3, transform.d3,
+        transform.a4, transform.b4, transform.c4, transform.d4);
+}
+
+bool HasOnlyTriangles(const aiMesh* mesh)
+{
+    return (mesh->mPrimitiveTypes & ~aiPrimitiveType::aiPrimitiveType_TRIANGLE) == 0;
+}
+
+uint32_t CountTriangles(const aiMesh* mesh)
+{
+    if (HasOnlyTriangles(mesh))
+    {
+        return mesh->mNumFaces;
+    }
+
+    // Triangulation leaves points and lines alone, those cannot be part of a triangle list
+    uint32_t triangleCount = 0;
+    for (uint32_t i = 0; i < mesh->mNumFaces; i++)
+    {
+        triangleCount += mesh->mFaces[i].mNumIndices == 3 ? 1 : 0;
+    }
+
+    return triangleCount;
+}
+
+// Lays out a submesh for every mesh reference with triangles, so the vertices and indices
+// can be allocated once and every mesh converted on its own
+void CollectMeshInstances(
+    const aiScene* scene,
+    const aiNode* node,
+    const aiMatrix4x4& parentTransform,
+    std::vector<MeshInstance>& instances,
+    std::vector<Submesh>& submeshes,
+    uint32_t& vertexCount,
+    uint32_t& indexCount)
+{
+    const aiMatrix4x4 transform = parentTransform * node->mTransformation;
+    for (uint32_t i = 0; i < node->mNumMeshes; i++)
+    {
+        const aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
+        const uint32_t triangleCount = mesh->HasPositions() ? CountTriangles(mesh) : 0;
+        if (mesh->mNumVertices == 0 || triangleCount == 0)
+        {
+            continue;
+        }
+
+        Submesh submesh = {};
+        submesh.IndexOffset = indexCount;
+        submesh.IndexCount = triangleCount * 3;
+        submesh.BaseVertex = static_cast<int32_t>(vertexCount);
+        submesh.VertexCount = mesh->mNumVertices;
+        submesh.MaterialIndex = mesh->mMaterialIndex;
+        vertexCount += submesh.VertexCount;
+        indexCount += submesh.IndexCount;
+
+        // Normals go through the inverse transpose so non uniform scales keep them perpendicular
+        const DirectX::XMMATRIX meshTransform = LoadTransform(transform);
+        MeshInstance instance = {};
+        instance.Mesh = mesh;
+        instance.SubmeshIndex = static_cast<uint32_t>(submeshes.size());
+        DirectX::XMStoreFloat4x4(&instance.Transform, DirectX::XMMatrixMultiply(meshTransform, DirectX::XMMatrixScaling(ImportScale, ImportScale, ImportScale)));
+        DirectX::XMStoreFloat4x4(&instance.NormalTransform, DirectX::XMMatrixTranspose(DirectX::XMMatrixInverse(nullptr, meshTransform)));
+        instances.push_back(instance);
+        submeshes.push_back(submesh);
+    }
+
+    for (uint32_t i = 0; i < node->mNumChildren; i++)
+    {
+        CollectMeshInstances(scene, node->mChildren[i], transform, instances, submeshes, vertexCount, indexCount);
+    }
+}
+
+// Attributes a mesh lacks are filled in for the whole range at once instead of being checked per vertex
+void ImportVertices(
+    const MeshInstance& instance,
+    const ImportJob& job,
+    VertexPositionNormalColorUv* vertices)
+{
+    const aiMesh* mesh = instance.Mesh;
+    VertexPositionNormalColorUv* jobVertices = vertices + job.First;
+    const DirectX::XMMATRIX transform = DirectX::XMLoadFloat4x4(&instance.Transform);
+    DirectX::XMVector3TransformCoordStream(
+        &jobVertices[0].position,
+        sizeof(VertexPositionNormalColorUv),
+        reinterpret_cast<const DirectX::XMFLOAT3*>(mesh->mVertices + job.First),
+        sizeof(aiVector3D),
+        job.Count,
+        transform);
+
+    if (mesh->HasNormals())
+    {
+        DirectX::XMVector3TransformNormalStream(
+            &jobVertices[0].normal,
+            sizeof(VertexPositionNormalColorUv),
+            reinterpret_cast<const DirectX::XMFLOAT3*>(mesh->mNormals + job.First),
+            sizeof(aiVector3D),
+            job.Count,
+            DirectX::XMLoadFloat4x4(&instance.NormalTransform));
+
+        const DirectX::XMVECTOR defaultNormal = DirectX::XMLoadFloat3(&DefaultNormal);
+        for (uint32_t i = 0; i < job.Count; i++)
+        {
+            const DirectX::XMVECTOR normal = DirectX::XMLoadFloat3(&jobVertices[i].normal);
+            const bool hasLength = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(normal)) > 0.0f;
+            DirectX::XMStoreFloat3(&jobVertices[i].normal, hasLength ? DirectX::XMVector3Normalize(normal) : defaultNormal);
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < job.Count; i++)
+        {
+            jobVertices[i].normal = DefaultNormal;
+        }
+    }
+
+    // Colors and uvs are copied with one SIMD load and store per vertex rather than one per
+    // component. The vertices interleave every attribute, so there is no contiguous run of
+    // colors or uvs to store several vertices' worth at once, batches only keep the loads ahead.
+    if (mesh->HasVertexColors(0))
+    {
+        const DirectX::XMFLOAT4* colors = reinterpret_cast<const DirectX::XMFLOAT4*>(mesh->mColors[0] + job.First);
+        uint32_t i = 0;
+        for (; i + AttributeBatchSize <= job.Count; i += AttributeBatchSize)
+        {
+            const DirectX::XMVECTOR color0 = DirectX::XMLoadFloat4(&colors[i + 0]);
+            const DirectX::XMVECTOR color1 = DirectX::XMLoadFloat4(&colors[i + 1]);
+            const DirectX::XMVECTOR color2 = DirectX::XMLoadFloat4(&colors[i + 2]);
+            const DirectX::XMVECTOR color3 = DirectX::XMLoadFloat4(&colors[i + 3]);
+            DirectX::XMStoreFloat3(&jobVertices[i + 0].color, color0);
+            DirectX::XMStoreFloat3(&jobVertices[i + 1].color, color1);
+            DirectX::XMStoreFloat3(&jobVertices[i + 2].color, color2);
+            DirectX::XMStoreFloat3(&jobVertices[i + 3].color, color3);
+        }
+        for (; i < job.Count; i++)
+        {
+            DirectX::XMStoreFloat3(&jobVertices[i].color, DirectX::XMLoadFloat4(&colors[i]));
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < job.Count; i++)
+        {
+            jobVertices[i].color = DefaultColor;
+        }
+    }
+
+    if (mesh->HasTextureCoords(0))
+    {
+        // The first two components of each aiVector3D
+        const DirectX::XMFLOAT3* uvs = reinterpret_cast<const DirectX::XMFLOAT3*>(mesh->mTextureCoords[0] + job.First);
+        uint32_t i = 0;
+        for (; i + AttributeBatchSize <= job.Count; i += AttributeBatchSize)
+        {
+            const DirectX::XMVECTOR uv0 = DirectX::XMLoadFloat2(reinterpret_cast<const DirectX::XMFLOAT2*>(&uvs[i + 0]));
+            const DirectX::XMVECTOR uv1 = DirectX::XMLoadFloat2(reinterpret_cast<const DirectX::XMFLOAT2*>(&uvs[i + 1]));
+            const DirectX::XMVECTOR uv2 = DirectX::XMLoadFloat2(reinterpret_cast<const DirectX::XMFLOAT2*>(&uvs[i + 2]));
+            const DirectX::XMVECTOR uv3 = DirectX::XMLoadFloat2(reinterpret_cast<const DirectX::XMFLOAT2*>(&uvs[i + 3]));
+            DirectX::XMStoreFloat2(&jobVertices[i + 0].uv, uv0);
+            DirectX::XMStoreFloat2(&jobVertices[i + 1].uv, uv1);
+            DirectX::XMStoreFloat2(&jobVertices[i + 2].uv, uv2);
+            DirectX::XMStoreFloat2(&jobVertices[i + 3].uv, uv3);
+        }
+        for (; i < job.Count; i++)
+        {
+            DirectX::XMStoreFloat2(&jobVertices[i].uv, DirectX::XMLoadFloat2(reinterpret_cast<const DirectX::XMFLOAT2*>(&uvs[i])));
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < job.Count; i++)
+        {
+            jobVertices[i].uv = DefaultUv;
+        }
+    }
+}
+
+void ImportIndices(
+    const MeshInstance& instance,
+    const ImportJob& job,
+    uint32_t* indices)
+{
+    const aiMesh* mesh = instance.Mesh;
+    if (HasOnlyTriangles(mesh))
+    {
+        uint32_t* jobIndices = indices + static_cast<size_t>(job.First) * 3;
+        for (uint32_t i = 0; i < job.Count; i++)
+        {
+            const uint32_t* faceIndices = mesh->mFaces[job.First + i].mIndices;
+            jobIndices[i * 3 + 0] = faceIndices[0];
+            jobIndices[i * 3 + 1] = faceIndices[1];
+            jobIndices[i * 3 + 2] = faceIndices[2];
+        }
+
+        return;
+    }
+
+    // Meshes with points or lines are converted by a single job, the triangles' positions depend on every face before them
+    uint32_t indexCount = 0;
+    for (uint32_t i = 0; i < mesh->mNumFaces; i++)
+    {
+        const aiFace& face = mesh->mFaces[i];
+        if (face.mNumIndices != 3)
+        {
+            continue;
+        }
+
+        indices[indexCount + 0] = face.mIndices[0];
+        indices[indexCount + 1] = face.mIndices[1];
+        indices[indexCount + 2] = face.mIndices[2];
+        indexCount += 3;
+    }
+}
+
+// Converts every mesh of the scene into one vertex and one index array, allocated once up front.
+// Large meshes are split into several jobs, which run on the shared JobSystem.
+void ImportScene(
+    const aiScene* scene,
+    std::vector<VertexPositionNormalColorUv>& vertices,
+    std::vector<uint32_t>& indices,
+    std::vector<Submesh>& submeshes)
+{
+    std::vector<MeshInstance> instances;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    CollectMeshInstances(scene, scene->mRootNode, aiMatrix4x4(), instances, submeshes, vertexCount, indexCount);
+    vertices.resize(vertexCount);
+    indices.resize(indexCount);
+
+    std::vector<ImportJob> jobs;
+    for (uint32_t i = 0; i < instances.size(); i++)
+    {
+        const aiMesh* mesh = instances[i].Mesh;
+        for (uint32_t first = 0; first < mesh->mNumVertices; first += ImportJobSize)
+        {
+            const uint32_t remainingCount = mesh->mNumVertices - first;
+            jobs.push_back(ImportJob{ i, first, remainingCount < ImportJobSize ? remainingCount : ImportJobSize, true });
+        }
+
+        const uint32_t faceJobSize = HasOnlyTriangles(mesh) ? ImportJobSize : mesh->mNumFaces;
+        for (uint32_t first = 0; first < mesh->mNumFaces; first += faceJobSize)
+        {
+            const uint32_t remainingCount = mesh->mNumFaces - first;
+            jobs.push_back(ImportJob{ i, first, remainingCount < faceJobSize ? remainingCount : faceJobSize, false });
+        }
+    }
+
+    JobSystem::Get().RunJobs(static_cast<uint32_t>(jobs.size()), [&](const uint32_t jobIndex)
+    {
+        const ImportJob& job = jobs[jobIndex];
+        const MeshInstance& instance = instances[job.InstanceIndex];
+        const Submesh& submesh = submeshes[instance.SubmeshIndex];
+        if (job.IsVertexJob)
+        {
+            ImportVertices(instance, job, &vertices[submesh.BaseVertex]);
+        }
+        else
+        {
+            ImportIndices(instance, job, &indices[submesh.IndexOffset]);
+        }
+
+        return true;
+    });
+}
+
+// 0xFFFF is left out, it is the strip cut value for 16-bit indices
+constexpr uint32_t MaxSubmeshVertexCount = 0xFFFF;
+constexpr uint32_t InvalidVertex = ~0u;
+
+// Splits submeshes with more vertices than 16-bit indices can address into chunks of consecutive
+// triangles, so every model can use a 16-bit index buffer. Vertices used by several chunks are duplicated.
+void SplitLargeSubmeshes(
+    std::vector<VertexPositionNormalColorUv>& vertices,
+    std::vector<uint32_t>& indices,
+    std::vector<Submesh>& submeshes)
+{
+    bool hasLargeSubmeshes = false;
+    for (const Submesh& submesh : submeshes)
+    {
+        hasLargeSubmeshes |= submesh.VertexCount > MaxSubmeshVertexCount;
+    }
+
+    if (!hasLargeSubmeshes)
+    {
+        return;
+    }
+
+    std::vector<VertexPositionNormalColorUv> splitVertices;
+    std::vector<uint32_t> splitIndices;
+    std::vector<Submesh> splitSubmeshes;
+    splitVertices.reserve(vertices.size());
+    splitIndices.reserve(indices.size());
+
+    std::vector<uint32_t> vertexRemap;
+    for (const Submesh& submesh : submeshes)
+    {
+        const VertexPositionNormalColorUv* submeshVertices = &vertices[submesh.BaseVertex];
+        const uint32_t* submeshIndices = &indices[submesh.IndexOffset];
+
+        Submesh chunk = submesh;
+        chunk.IndexOffset = static_cast<uint32_t>(splitIndices.size());
+        chunk.BaseVertex = static_cast<int32_t>(splitVertices.size());
+        if (submesh.VertexCount <= MaxSubmeshVertexCount)
+        {
+            splitVertices.insert(splitVertices.end(), submeshVertices, submeshVertices + submesh.VertexCount);
+            splitIndices.insert(splitIndices.end(), submeshIndices, submeshIndices + submesh.IndexCount);
+            splitSubmeshes.push_back(chunk);
+            continue;
+        }
+
+        const auto finishChunk = [&]()
+        {
+            chunk.IndexCount = static_cast<uint32_t>(splitIndices.size()) - chunk.IndexOffset;
+            chunk.VertexCount = static_cast<uint32_t>(splitVertices.size()) - chunk.BaseVertex;
+            splitSubmeshes.push_back(chunk);
+        };
+
+        vertexRemap.assign(submesh.VertexCount, InvalidVertex);
+        for (uint32_t i = 0; i < submesh.IndexCount; i += 3)
+        {
+            uint32_t newVertexCount = 0;
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                newVertexCount += vertexRemap[submeshIndices[i + corner]] == InvalidVertex ? 1 : 0;
+            }
+
+            if (splitVertices.size() - chunk.BaseVertex + newVertexCount > MaxSubmeshVertexCount)
+            {
+                finishChunk();
+                chunk.IndexOffset = static_cast<uint32_t>(splitIndices.size());
+                chunk.BaseVertex = static_cast<int32_t>(splitVertices.size());
+                vertexRemap.assign(submesh.VertexCount, InvalidVertex);
+            }
+
+            for (uint32_t corner = 0; corner < 3; corner++)
+            {
+                uint32_t& remappedVertex = vertexRemap[submeshIndices[i + corner]];
+                if (remappedVertex == InvalidVertex)
+                {
+                    remappedVertex = static_cast<uint32_t>(splitVertices.size()) - chunk.BaseVertex;
+                    splitVertices.push_back(submeshVertices[submeshIndices[i + corner]]);
+                }
+
+                splitIndices.push_back(remappedVertex);
+            }
+        }
+
+        finishChunk();
+    }
+
+    vertices = std::move(splitVertices);
+    indices = std::move(splitIndices);
+    submeshes = std::move(splitSubmeshes);
+}
+
+// Box and sphere around every submesh's vertices, the sphere is centered on the box.
+// Both are reductions over XMVECTORs, min/max for the box and the largest squared distance for the sphere.
+void ComputeSubmeshBounds(
+    const std::vector<VertexPositionNormalColorUv>& vertices,
+    std::vector<Submesh>& submeshes)
+{
+    for (Submesh& submesh : submeshes)
+    {
+        const VertexPositionNormalColorUv* submeshVertices = &vertices[submesh.BaseVertex];
+        DirectX::XMVECTOR minimum = DirectX::XMLoadFloat3(&submeshVertices[0].position);
+        DirectX::XMVECTOR maximum = minimum;
+        for (uint32_t i = 1; i < submesh.VertexCount; i++)
+        {
+            const DirectX::XMVECTOR position = DirectX::XMLoadFloat3(&submeshVertices[i].position);
+            minimum = DirectX::XMVectorMin(minimum, position);
+            maximum = DirectX::XMVectorMax(maximum, position);
+        }
+
+        DirectX::BoundingBox::CreateFromPoints(submesh.Bounds, minimum, maximum);
+
+        const DirectX::XMVECTOR center = DirectX::XMLoadFloat3(&submesh.Bounds.Center);
+        DirectX::XMVECTOR maxDistanceSquared = DirectX::XMVectorZero();
+        for (uint32_t i = 0; i < submesh.VertexCount; i++)
+        {
+            const DirectX::XMVECTOR offset = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&submeshVertices[i].position), center);
+            maxDistanceSquared = DirectX::XMVectorMax(maxDistanceSquared, DirectX::XMVector3LengthSq(offset));
+        }
+
+        submesh.SphereBounds.Center = submesh.Bounds.Center;
+        submesh.SphereBounds.Radius = std::sqrt(DirectX::XMVectorGetX(maxDistanceSquared));
+    }
+}
+
+uint16_t QuantizeUnorm16(const float value)
+{
+    const float clampedValue = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    return static_cast<uint16_t>(clampedValue * 65535.0f + 0.5f);
+}
+
+int16_t QuantizeSnorm16(const float value)
+{
+    const float clampedValue = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+    return static_cast<int16_t>(std::round(clampedValue * 32767.0f));
+}
+
+uint8_t QuantizeUnorm8(const float value)
+{
+    const float clampedValue = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    return static_cast<uint8_t>(clampedValue * 255.0f + 0.5f);
+}
+
+// Projects the unit normal onto an octahedron and folds the lower half over the upper one.
+// A shader decodes it with n = float3(e, 1 - |e.x| - |e.y|); n.xy -= sign(n.xy) * saturate(-n.z)
+void EncodeOctahedralNormal(
+    const Normal& normal,
+    int16_t encodedNormal[2])
+{
+    const float length = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    float x = normal.x / length;
+    float y = normal.y / length;
+    if (normal.z < 0.0f)
+    {
+        const float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        const float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = foldedX;
+        y = foldedY;
+    }
+
+    encodedNormal[0] = QuantizeSnorm16(x);
+    encodedNormal[1] = QuantizeSnorm16(y);
+}
+
+// Converts the imported vertices into the layout the GPU reads. Quantized positions are stored
+// relative to each submesh's bounds, which keeps 16 bits enough even for large scenes.
+VertexType ConvertVertices(
+    const std::vector<VertexPositionNormalColorUv>& vertices,
+    const bool quantize,
+    std::vector<Submesh>& submeshes,
+    std::vector<uint8_t>& vertexData)
+{
+    if (!quantize)
+    {
+        vertexData.resize(sizeof(VertexPositionColorUv) * vertices.size());
+        VertexPositionColorUv* convertedVertices = reinterpret_cast<VertexPositionColorUv*>(vertexData.data());
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            convertedVertices[i] = VertexPositionColorUv{ vertices[i].position, vertices[i].color, vertices[i].uv };
+        }
+
+        return VertexType::PositionColorUv;
+    }
+
+    // unorm16 is twice as precise as half floats over [0, 1], which is where most uvs are
+    bool hasUnitUvs = true;
+    for (const VertexPositionNormalColorUv& vertex : vertices)
+    {
+        if (vertex.uv.x < 0.0f || vertex.uv.x > 1.0f || vertex.uv.y < 0.0f || vertex.uv.y > 1.0f)
+        {
+            hasUnitUvs = false;
+            break;
+        }
+    }
+
+    vertexData.resize(sizeof(VertexQuantizedPositionNormalColorUv) * vertices.size());
+    VertexQuantizedPositionNormalColorUv* quantizedVertices = reinterpret_cast<VertexQuantizedPositionNormalColorUv*>(vertexData.data());
+    for (Submesh& submesh : submeshes)
+    {
+        const VertexPositionNormalColorUv* submeshVertices = &vertices[submesh.BaseVertex];
+        DirectX::XMVECTOR minimum = DirectX::XMLoadFloat3(&submeshVertices[0].position);
+        DirectX::XMVECTOR maximum = minimum;
+        for (uint32_t i = 1; i < submesh.VertexCount; i++)
+        {
+            const DirectX::XMVECTOR position = DirectX::XMLoadFloat3(&submeshVertices[i].position);
+            minimum = DirectX::XMVectorMin(minimum, position);
+            maximum = DirectX::XMVectorMax(maximum, position);
+        }
+
+        DirectX::XMStoreFloat3(&submesh.PositionOffset, minimum);
+        DirectX::XMStoreFloat3(&submesh.PositionScale, DirectX::XMVectorSubtract(maximum, minimum));
+        const DirectX::XMFLOAT3& scale = submesh.PositionScale;
+        const DirectX::XMFLOAT3& offset = submesh.PositionOffset;
+
+        for (uint32_t i = 0; i < submesh.VertexCount; i++)
+        {
+            const VertexPositionNormalColorUv& vertex = submeshVertices[i];
+            VertexQuantizedPositionNormalColorUv& quantizedVertex = quantizedVertices[submesh.BaseVertex + i];
+            quantizedVertex.position[0] = scale.x > 0.0f ? QuantizeUnorm16((vertex.position.x - offset.x) / scale.x) : 0;
+            quantizedVertex.position[1] = scale.y > 0.0f ? QuantizeUnorm16((vertex.position.y - offset.y) / scale.y) : 0;
+            quantizedVertex.position[2] = scale.z > 0.0f ? QuantizeUnorm16((vertex.position.z - offset.z) / scale.z) : 0;
+            quantizedVertex.position[3] = 0;
+            EncodeOctahedralNormal(vertex.normal, quantizedVertex.normal);
+            quantizedVertex.color[0] = QuantizeUnorm8(vertex.color.x);
+            quantizedVertex.color[1] = QuantizeUnorm8(vertex.color.y);
+            quantizedVertex.color[2] = QuantizeUnorm8(vertex.color.z);
+            quantizedVertex.color[3] = 255;
+            if (hasUnitUvs)
+            {
+                quantizedVertex.uv[0] = QuantizeUnorm16(vertex.uv.x);
+                quantizedVertex.uv[1] = QuantizeUnorm16(vertex.uv.y);
+            }
+            else
+            {
+                quantizedVertex.uv[0] = DirectX::PackedVector::XMConvertFloatToHalf(vertex.uv.x);
+                quantizedVertex.uv[1] = DirectX::PackedVector::XMConvertFloatToHalf(vertex.uv.y);
+            }
+        }
+    }
+
+    return hasUnitUvs
+             ? VertexType::QuantizedPositionNormalColorUnormUv
+             : VertexType::QuantizedPositionNormalColorHalfUv;
+}
+
+// Uvs of textured surfaces may leave [0, 1] by this much and are still clamped into their region
+constexpr float AtlasUvTolerance = 0.001f;
+
+std::filesystem::path GetTextureAtlasFilePath(const std::filesystem::path& cookedFilePath)
+{
+    std::filesystem::path atlasFilePath = cookedFilePath;
+    atlasFilePath.replace_extension(".dds");
+    return atlasFilePath;
+}
+
+// Looks for a material's diffuse texture as written, relative to the model, and by its file name
+// next to the model and in the Textures directory beside the model's, each also as a DDS file.
+// Exporters often store absolute paths of the machine the model was made on.
+std::filesystem::path FindDiffuseTexture(
+    const aiMaterial* material,
+    const std::filesystem::path& modelDirectory)
+{
+    aiString texturePath;
+    if (material->GetTextureCount(aiTextureType_DIFFUSE) == 0 ||
+        material->GetTexture(aiTextureType_DIFFUSE, 0, &texturePath) != aiReturn_SUCCESS)
+    {
+        return {};
+    }
+
+    std::string texturePathString = texturePath.C_Str();
+    std::replace(texturePathString.begin(), texturePathString.end(), '\\', '/');
+    const std::filesystem::path path = std::filesystem::u8path(texturePathString);
+    const std::filesystem::path candidates[] = {
+        path,
+        modelDirectory / path,
+        modelDirectory / path.filename(),
+        modelDirectory.parent_path() / "Textures" / path.filename(),
+    };
+
+    for (const std::filesystem::path& candidate : candidates)
+    {
+        std::error_code errorCode;
+        if (std::filesystem::is_regular_file(candidate, errorCode))
+        {
+            return candidate;
+        }
+
+        std::filesystem::path ddsCandidate = candidate;
+        ddsCandidate.replace_extension(".dds");
+        if (std::filesystem::is_regular_file(ddsCandidate, errorCode))
+        {
+            return ddsCandidate;
+        }
+    }
+
+    return path;
+}
+
+// Packs the diffuse textures of every material into one atlas and moves each submesh's uvs into
+// its material's region, so the whole model samples a single texture. Surfaces without a texture
+// get a white texel. Repeating textures cannot be packed, models with uvs outside [0, 1] on a
+// textured surface keep their uvs and textures, as do models whose textures cannot be loaded.
+bool BuildTextureAtlas(
+    const aiScene* scene,
+    const std::filesystem::path& modelFilePath,
+    const std::filesystem::path& atlasFilePath,
+    std::vector<VertexPositionNormalColorUv>& vertices,
+    const std::vector<Submesh>& submeshes,
+    std::vector<std::filesystem::path>& texturePaths)
+{
+    const std::filesystem::path modelDirectory = modelFilePath.parent_path();
+    TextureAtlasBuilder atlasBuilder(TextureAtlasSettings{});
+    std::vector<uint32_t> materialRegions(scene->mNumMaterials, InvalidAtlasRegion);
+    std::vector<bool> isMaterialTextured(scene->mNumMaterials, false);
+    for (uint32_t i = 0; i < scene->mNumMaterials; i++)
+    {
+        const std::filesystem::path texturePath = FindDiffuseTexture(scene->mMaterials[i], modelDirectory);
+        isMaterialTextured[i] = !texturePath.empty();
+        materialRegions[i] = isMaterialTextured[i]
+                               ? atlasBuilder.AddTexture(texturePath)
+                               : atlasBuilder.AddSolidColor(0xFFFFFFFF);
+        if (materialRegions[i] == InvalidAtlasRegion)
+        {
+            std::cout << "ModelFactory: Failed to load texture " << texturePath.u8string() << " for the texture atlas\n";
+            return false;
+        }
+
+        if (isMaterialTextured[i] && std::find(texturePaths.begin(), texturePaths.end(), texturePath) == texturePaths.end())
+        {
+            texturePaths.push_back(texturePath);
+        }
+    }
+
+    for (const Submesh& submesh : submeshes)
+    {
+        if (submesh.MaterialIndex >= scene->mNumMaterials || !isMaterialTextured[submesh.MaterialIndex])
+        {
+            continue;
+        }
+
+        for (uint32_t i = 0; i < submesh.VertexCount; i++)
+        {
+            const Uv& uv = vertices[submesh.BaseVertex + i].uv;
+            if (uv.x < -AtlasUvTolerance || uv.x > 1.0f + AtlasUvTolerance || uv.y < -AtlasUvTolerance || uv.y > 1.0f + AtlasUvTolerance)
+            {
+                std::cout << "ModelFactory: Model repeats its textures, they cannot be packed into an atlas\n";
+                return false;
+            }
+        }
+    }
+
+    if (!atlasBuilder.Build())
+    {
+        return false;
+    }
+    atlasBuilder.PrintStatistics();
+
+    if (!atlasBuilder.Save(atlasFilePath))
+    {
+        std::cout << "ModelFactory: Failed to write texture atlas " << atlasFilePath.u8string() << "\n";
+        return false;
+    }
+
+    for (const Submesh& submesh : submeshes)
+    {
+        if (submesh.MaterialIndex >= scene->mNumMaterials)
+        {
+            continue;
+        }
+
+        const AtlasRegion& atlasRegion = atlasBuilder.GetRegion(materialRegions[submesh.MaterialIndex]);
+        for (uint32_t i = 0; i < submesh.VertexCount; i++)
+        {
+            Uv& uv = vertices[submesh.BaseVertex + i].uv;
+            const float u = uv.x < 0.0f ? 0.0f : (uv.x > 1.0f ? 1.0f : uv.x);
+            const float v = uv.y < 0.0f ? 0.0f : (uv.y > 1.0f ? 1.0f : uv.y);
+            uv = Uv{ atlasRegion.UvOffset.x + u * atlasRegion.UvScale.x, atlasRegion.UvOffset.y + v * atlasRegion.UvScale.y };
+        }
+    }
+
+    return true;
+}
+
+std::filesystem::path GetCookedFilePath(const std::string& filePath)
 {
-    _device = device;
+    // The path hash keeps models with the same name in different directories apart
+    char pathHash[17] = {};
+    snprintf(pathHash, sizeof(pathHash), "%016llx", static_cast<unsigned long long>(HashBytes(filePath.data(), filePath.size())));
+
+    std::filesystem::path cookedFileName = std::filesystem::path(filePath).stem();
+    cookedFileName += "_";
+    cookedFileName += pathHash;
+    cookedFileName += ".mesh";
+    return std::filesystem::path("ModelCache") / cookedFileName;
+}
+
+bool WriteCookedModel(
+    const std::filesystem::path& cookedFilePath,
+    const uint64_t sourceHash,
+    const uint64_t sourceSize,
+    const int64_t sourceLastWriteTime,
+    const uint32_t processingFlags,
+    const ModelLodSettings& lodSettings,
+    const VertexType vertexType,
+    const std::vector<uint8_t>& vertexData,
+    const std::vector<uint16_t>& indices,
+    const std::vector<Submesh>& submeshes,
+    const std::vector<Meshlet>& meshlets,
+    const std::vector<ModelLod>& lods,
+    const std::vector<IndexRange>& lodIndexRanges,
+    const bool hasTextureAtlas,
+    const std::vector<std::filesystem::path>& textureDependencies)
+{
+    std::vector<uint8_t> dependencyData;
+    WriteTextureDependencies(textureDependencies, dependencyData);
+
+    CookedModelHeader header = {};
+    header.SourceHash = sourceHash;
+    header.SourceSize = sourceSize;
+    header.SourceLastWriteTime = sourceLastWriteTime;
+    header.ImportFlags = ImportFlags;
+    header.ProcessingFlags = processingFlags;
+    header.VertexType = static_cast<uint32_t>(vertexType);
+    header.VertexStride = static_cast<uint32_t>(GetVertexSize(vertexType));
+    header.IndexFormat = static_cast<uint32_t>(RenderFormat::R16Uint);
+    header.SubmeshStride = sizeof(Submesh);
+    header.MeshletStride = sizeof(Meshlet);
+    header.LodStride = sizeof(ModelLod);
+    header.IndexRangeStride = sizeof(IndexRange);
+    WriteLodSettings(header, processingFlags, lodSettings);
+    header.VertexCount = static_cast<uint32_t>(vertexData.size() / header.VertexStride);
+    header.IndexCount = static_cast<uint32_t>(indices.size());
+    header.SubmeshCount = static_cast<uint32_t>(submeshes.size());
+    header.MeshletCount = static_cast<uint32_t>(meshlets.size());
+    header.LodCount = static_cast<uint32_t>(lods.size());
+    header.IndexRangeCount = static_cast<uint32_t>(lodIndexRanges.size());
+    header.HasTextureAtlas = hasTextureAtlas ? 1 : 0;
+    header.TextureDependencyCount = static_cast<uint32_t>(textureDependencies.size());
+    header.TextureDependencySize = static_cast<uint32_t>(dependencyData.size());
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(cookedFilePath.parent_path(), errorCode);
+
+    // Written to a temporary file first so an interrupted write never leaves half a model behind
+    std::filesystem::path temporaryFilePath = cookedFilePath;
+    temporaryFilePath += ".tmp";
+    {
+        std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(dependencyData.data()), dependencyData.size());
+        file.write(reinterpret_cast<const char*>(submeshes.data()), sizeof(Submesh) * submeshes.size());
+        file.write(reinterpret_cast<const char*>(meshlets.data()), sizeof(Meshlet) * meshlets.size());
+        file.write(reinterpret_cast<const char*>(lods.data()), sizeof(ModelLod) * lods.size());
+        file.write(reinterpret_cast<const char*>(lodIndexRanges.data()), sizeof(IndexRange) * lodIndexRanges.size());
+        file.write(reinterpret_cast<const char*>(vertexData.data()), vertexData.size());
+        file.write(reinterpret_cast<const char*>(indices.data()), sizeof(uint16_t) * indices.size());
+        if (!file)
+        {
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporaryFilePath, cookedFilePath, errorCode);
+    if (errorCode)
+    {
+        std::filesystem::remove(temporaryFilePath, errorCode);
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+ModelFactory::ModelFactory(const std::shared_ptr<GeometryPool>& geometryPool)
+{
+    _geometryPool = geometryPool;
+}
+
+void ModelFactory::SetLodSettings(const ModelLodSettings& lodSettings)
+{
+    _lodSettings = lodSettings;
 }
 
 bool ModelFactory::LoadModel(
     const std::string& filePath,
-    WRL::ComPtr<ID3D11Buffer>& vertexBuffer,
-    uint32_t* vertexCount,
-    WRL::ComPtr<ID3D11Buffer>& indexBuffer,
-    uint32_t* indexCount)
+    const uint32_t processingFlags,
+    Model& model)
 {
-    constexpr uint32_t importFlags = aiProcess_Triangulate | aiProcess_FlipUVs;
+    uint64_t sourceSize = 0;
+    int64_t sourceLastWriteTime = 0;
+    if (!GetFileStamp(filePath, sourceSize, sourceLastWriteTime))
+    {
+        std::cout << "ModelFactory: Failed to open model file\n";
+        return false;
+    }
+
+    const std::filesystem::path cookedFilePath = GetCookedFilePath(filePath);
+    if (LoadCookedModel(cookedFilePath, filePath, sourceSize, sourceLastWriteTime, processingFlags, model))
+    {
+        return true;
+    }
+
+    uint64_t sourceHash = 0;
+    if (!HashFile(filePath, sourceHash))
+    {
+        std::cout << "ModelFactory: Failed to open model file\n";
+        return false;
+    }
+
     const std::string fileName{ filePath.begin(), filePath.end() };
 
     Assimp::Importer sceneImporter;
-    const aiScene* scene = sceneImporter.ReadFile(fileName.c_str(), importFlags);
+    const aiScene* scene = sceneImporter.ReadFile(fileName.c_str(), ImportFlags);
 
     if (scene == nullptr)
     {
@@ -35,81 +1071,314 @@ bool ModelFactory::LoadModel(
         return false;
     }
 
-    if (!scene->HasMeshes())
+    if (!scene->HasMeshes() || scene->mRootNode == nullptr)
     {
         std::cout << "ASSIMP: Model file is empty\n";
         return false;
     }
 
-    const aiMesh* mesh = scene->mMeshes[0];
-    if (!mesh->HasPositions())
+    std::vector<VertexPositionNormalColorUv> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<Submesh> submeshes;
+    ImportScene(scene, vertices, indices, submeshes);
+    if (submeshes.empty())
+    {
+        std::cout << "ASSIMP: Model has no meshes with positions and triangles\n";
+        return false;
+    }
+
+    // Remapped first, everything after works on the uvs the GPU will see
+    std::filesystem::path textureAtlasFilePath;
+    std::vector<std::filesystem::path> textureDependencies;
+    if ((processingFlags & ModelProcessingFlags::ModelProcessingBuildTextureAtlas) != 0)
+    {
+        textureAtlasFilePath = GetTextureAtlasFilePath(cookedFilePath);
+        if (!BuildTextureAtlas(scene, filePath, textureAtlasFilePath, vertices, submeshes, textureDependencies))
+        {
+            textureAtlasFilePath.clear();
+            textureDependencies.clear();
+        }
+    }
+
+    // Assimp emits a separate vertex per face corner for most formats
+    if ((processingFlags & (ModelProcessingFlags::ModelProcessingWeldVertices | ModelProcessingFlags::ModelProcessingWeldVerticesApproximately)) != 0)
+    {
+        const bool isApproximate = (processingFlags & ModelProcessingFlags::ModelProcessingWeldVerticesApproximately) != 0;
+        VertexWelder vertexWelder(isApproximate ? ApproximateWeldEpsilon : 0.0f);
+        vertexWelder.Weld(vertices, indices, submeshes);
+        vertexWelder.PrintStatistics();
+    }
+
+    if ((processingFlags & ModelProcessingFlags::ModelProcessingOptimizeMeshes) != 0)
+    {
+        MeshOptimizer meshOptimizer(16, 1.05f);
+        meshOptimizer.Optimize(vertices, indices, submeshes);
+        meshOptimizer.PrintStatistics();
+    }
+
+    SplitLargeSubmeshes(vertices, indices, submeshes);
+    ComputeSubmeshBounds(vertices, submeshes);
+
+    // Lod indices are appended behind the full detail ones and use the same vertices
+    std::vector<ModelLod> lods;
+    std::vector<IndexRange> lodIndexRanges;
+    if ((processingFlags & ModelProcessingFlags::ModelProcessingGenerateLods) != 0 && _lodSettings.MaxLodCount > 1)
+    {
+        DirectX::BoundingBox bounds = submeshes.front().Bounds;
+        for (const Submesh& submesh : submeshes)
+        {
+            DirectX::BoundingBox::CreateMerged(bounds, bounds, submesh.Bounds);
+        }
+
+        const float boundsDiagonal = 2.0f * DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&bounds.Extents)));
+        MeshSimplifier meshSimplifier(MeshSimplifierAttributeWeights{});
+        meshSimplifier.GenerateLods(
+            vertices,
+            indices,
+            submeshes,
+            _lodSettings.MaxLodCount,
+            _lodSettings.LodReduction,
+            _lodSettings.MaxRelativeError * boundsDiagonal,
+            lods,
+            lodIndexRanges);
+        meshSimplifier.PrintStatistics();
+    }
+
+    // Built last, meshlets are ranges of the final index buffer, of the full detail level only
+    std::vector<Meshlet> meshlets;
+    if ((processingFlags & ModelProcessingFlags::ModelProcessingBuildMeshlets) != 0)
+    {
+        MeshletBuilder meshletBuilder(64, 124);
+        meshletBuilder.Build(vertices, indices, submeshes, meshlets);
+        meshletBuilder.PrintStatistics();
+    }
+
+    std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+    std::vector<uint8_t> vertexData;
+    const bool quantize = (processingFlags & ModelProcessingFlags::ModelProcessingQuantizeVertices) != 0;
+    const VertexType vertexType = ConvertVertices(vertices, quantize, submeshes, vertexData);
+
+    if (!WriteCookedModel(
+            cookedFilePath,
+            sourceHash,
+            sourceSize,
+            sourceLastWriteTime,
+            processingFlags,
+            _lodSettings,
+            vertexType,
+            vertexData,
+            shortIndices,
+            submeshes,
+            meshlets,
+            lods,
+            lodIndexRanges,
+            !textureAtlasFilePath.empty(),
+            textureDependencies))
+    {
+        std::cout << "ModelFactory: Failed to write cooked model " << cookedFilePath.u8string() << "\n";
+    }
+
+    if (!CreateModel(
+            vertexData.data(),
+            vertexType,
+            static_cast<uint32_t>(vertices.size()),
+            shortIndices.data(),
+            RenderFormat::R16Uint,
+            static_cast<uint32_t>(shortIndices.size()),
+            std::move(submeshes),
+            std::move(meshlets),
+            std::move(lods),
+            std::move(lodIndexRanges),
+            model))
+    {
+        return false;
+    }
+
+    model.TextureAtlasFilePath = textureAtlasFilePath;
+    return true;
+}
+
+bool ModelFactory::LoadCookedModel(
+    const std::filesystem::path& cookedFilePath,
+    const std::string& sourceFilePath,
+    const uint64_t sourceSize,
+    const int64_t sourceLastWriteTime,
+    const uint32_t processingFlags,
+    Model& model)
+{
+    MemoryMappedFile cookedFile;
+    if (!cookedFile.Open(cookedFilePath) || cookedFile.GetSize() < sizeof(CookedModelHeader))
     {
-        std::cout << "ASSIMP: Model mesh has no positions\n";
         return false;
     }
 
-    constexpr Color defaultColor = Color{ 0.5f, 0.5f, 0.5f };
-    constexpr Uv defaultUv = Uv{ 0.0f, 0.0f };
-    std::vector<VertexPositionColorUv> vertices;
-    for (size_t i = 0; i < (mesh->mNumVertices); i++)
+    CookedModelHeader header = {};
+    std::memcpy(&header, cookedFile.GetData(), sizeof(CookedModelHeader));
+    CookedModelHeader expectedLodSettings = {};
+    WriteLodSettings(expectedLodSettings, processingFlags, _lodSettings);
+    if (header.Magic != CookedModelMagic ||
+        header.Version != CookedModelVersion ||
+        header.SourceSize != sourceSize ||
+        header.ImportFlags != ImportFlags ||
+        header.ProcessingFlags != processingFlags ||
+        header.VertexStride != GetVertexSize(static_cast<VertexType>(header.VertexType)) ||
+        (header.IndexFormat != static_cast<uint32_t>(RenderFormat::R16Uint) && header.IndexFormat != static_cast<uint32_t>(RenderFormat::R32Uint)) ||
+        header.SubmeshStride != sizeof(Submesh) ||
+        header.MeshletStride != sizeof(Meshlet) ||
+        header.LodStride != sizeof(ModelLod) ||
+        header.IndexRangeStride != sizeof(IndexRange) ||
+        header.MaxLodCount != expectedLodSettings.MaxLodCount ||
+        header.LodReduction != expectedLodSettings.LodReduction ||
+        header.MaxRelativeLodError != expectedLodSettings.MaxRelativeLodError ||
+        header.SubmeshCount == 0)
     {
-        const Position& position = Position{ mesh->mVertices[i].x / 10.0f, mesh->mVertices[i].y / 10.0f, mesh->mVertices[i].z / 10.0f };
-        const Color& color = mesh->HasVertexColors(0)
-                               ? Color{ mesh->mColors[0][i].r, mesh->mColors[0][i].g, mesh->mColors[0][i].b }
-                               : defaultColor;
-        const Uv& uv = mesh->HasTextureCoords(0)
-                         ? Uv{ mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y }
-                         : defaultUv;
+        return false;
+    }
 
-        vertices.push_back(VertexPositionColorUv{ Position{ position }, Color{ color }, Uv{ uv } });
+    // An unchanged size and write time are taken as an unchanged source. Only when the write time
+    // differs, after a copy or checkout for example, is the whole source hashed to make sure.
+    uint64_t sourceHash = 0;
+    if (header.SourceLastWriteTime != sourceLastWriteTime &&
+        (!HashFile(sourceFilePath, sourceHash) || header.SourceHash != sourceHash))
+    {
+        return false;
     }
 
-    *vertexCount = static_cast<uint32_t>(vertices.size());
+    // Without its atlas the cooked uvs are useless, importing again writes both anew
+    const std::filesystem::path textureAtlasFilePath = header.HasTextureAtlas != 0 ? GetTextureAtlasFilePath(cookedFilePath) : std::filesystem::path();
+    std::error_code errorCode;
+    if (header.HasTextureAtlas != 0 && !std::filesystem::is_regular_file(textureAtlasFilePath, errorCode))
+    {
+        return false;
+    }
 
-    D3D11_BUFFER_DESC vertexBufferDescriptor = {};
-    vertexBufferDescriptor.ByteWidth = static_cast<uint32_t>(sizeof(VertexPositionColorUv) * vertices.size());
-    vertexBufferDescriptor.Usage = D3D11_USAGE::D3D11_USAGE_IMMUTABLE;
-    vertexBufferDescriptor.BindFlags = D3D11_BIND_FLAG::D3D11_BIND_VERTEX_BUFFER;
+    const size_t dependenciesOffset = sizeof(CookedModelHeader);
+    if (cookedFile.GetSize() - dependenciesOffset < header.TextureDependencySize ||
+        !AreTextureDependenciesCurrent(cookedFile.GetData() + dependenciesOffset, header.TextureDependencySize, header.TextureDependencyCount))
+    {
+        return false;
+    }
 
-    D3D11_SUBRESOURCE_DATA vertexBufferData = {};
-    vertexBufferData.pSysMem = vertices.data();
+    const size_t submeshesOffset = dependenciesOffset + header.TextureDependencySize;
+    const size_t meshletsOffset = submeshesOffset + sizeof(Submesh) * header.SubmeshCount;
+    const size_t lodsOffset = meshletsOffset + sizeof(Meshlet) * header.MeshletCount;
+    const size_t indexRangesOffset = lodsOffset + sizeof(ModelLod) * header.LodCount;
+    const size_t verticesOffset = indexRangesOffset + sizeof(IndexRange) * header.IndexRangeCount;
+    const size_t indicesOffset = verticesOffset + static_cast<size_t>(header.VertexStride) * header.VertexCount;
+    const size_t indexSize = GetIndexSize(static_cast<RenderFormat>(header.IndexFormat));
+    if (cookedFile.GetSize() != indicesOffset + indexSize * header.IndexCount)
+    {
+        return false;
+    }
 
-    if (FAILED(_device->CreateBuffer(
-            &vertexBufferDescriptor,
-            &vertexBufferData,
-            &vertexBuffer)))
+    // Vertices and indices go straight from the mapped file to the GPU
+    std::vector<Submesh> submeshes(header.SubmeshCount);
+    std::vector<Meshlet> meshlets(header.MeshletCount);
+    std::memcpy(submeshes.data(), cookedFile.GetData() + submeshesOffset, sizeof(Submesh) * header.SubmeshCount);
+    std::vector<ModelLod> lods(header.LodCount);
+    std::vector<IndexRange> lodIndexRanges(header.IndexRangeCount);
+    std::memcpy(meshlets.data(), cookedFile.GetData() + meshletsOffset, sizeof(Meshlet) * header.MeshletCount);
+    std::memcpy(lods.data(), cookedFile.GetData() + lodsOffset, sizeof(ModelLod) * header.LodCount);
+    std::memcpy(lodIndexRanges.data(), cookedFile.GetData() + indexRangesOffset, sizeof(IndexRange) * header.IndexRangeCount);
+    if (!AreCookedRangesValid(header, submeshes, meshlets, lods, lodIndexRanges))
     {
-        std::cout << "D3D11: Failed to create model vertex buffer\n";
+        std::cout << "ModelFactory: Cooked model " << cookedFilePath.u8string() << " is damaged, importing it again\n";
         return false;
     }
 
-    std::vector<uint32_t> indices;
-    for (uint32_t i = 0; i < mesh->mNumFaces; i++)
+    if (!CreateModel(
+            cookedFile.GetData() + verticesOffset,
+            static_cast<VertexType>(header.VertexType),
+            header.VertexCount,
+            cookedFile.GetData() + indicesOffset,
+            static_cast<RenderFormat>(header.IndexFormat),
+            header.IndexCount,
+            std::move(submeshes),
+            std::move(meshlets),
+            std::move(lods),
+            std::move(lodIndexRanges),
+            model))
     {
-        for (uint32_t j = 0; j < mesh->mFaces[i].mNumIndices; j++)
-        {
-            indices.push_back(mesh->mFaces[i].mIndices[j]);
-        }
+        return false;
     }
 
-    *indexCount = static_cast<uint32_t>(indices.size());
+    model.TextureAtlasFilePath = textureAtlasFilePath;
 
-    D3D11_BUFFER_DESC indexBufferDescriptor = {};
-    indexBufferDescriptor.ByteWidth = static_cast<uint32_t>(sizeof(uint32_t) * indices.size());
-    indexBufferDescriptor.Usage = D3D11_USAGE::D3D11_USAGE_IMMUTABLE;
-    indexBufferDescriptor.BindFlags = D3D11_BIND_FLAG::D3D11_BIND_INDEX_BUFFER;
+    // The new write time goes into the header, so the next load does not hash the source again
+    if (header.SourceLastWriteTime != sourceLastWriteTime)
+    {
+        cookedFile.Close();
+        header.SourceLastWriteTime = sourceLastWriteTime;
+        std::fstream file(cookedFilePath, std::ios::binary | std::ios::in | std::ios::out);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
 
-    D3D11_SUBRESOURCE_DATA indexBufferData = {};
-    indexBufferData.pSysMem = indices.data();
+    return true;
+}
 
-    if (FAILED(_device->CreateBuffer(
-            &indexBufferDescriptor,
-            &indexBufferData,
-            &indexBuffer)))
+bool ModelFactory::CreateModel(
+    const void* vertices,
+    const VertexType vertexType,
+    const uint32_t vertexCount,
+    const void* indices,
+    const RenderFormat indexFormat,
+    const uint32_t indexCount,
+    std::vector<Submesh> submeshes,
+    std::vector<Meshlet> meshlets,
+    std::vector<ModelLod> lods,
+    std::vector<IndexRange> lodIndexRanges,
+    Model& model)
+{
+    // Reloading into a model hands its previous range back to the pool first
+    _geometryPool->Free(model.Geometry);
+    model.Geometry = InvalidGeometryHandle;
+    if (!_geometryPool->Allocate(
+            vertexType,
+            vertices,
+            vertexCount,
+            indexFormat,
+            indices,
+            indexCount,
+            model.Geometry))
     {
-        std::cout << "D3D11: Failed to create model index buffer\n";
+        std::cout << "ModelFactory: Failed to allocate model geometry\n";
         return false;
     }
 
+    model.VertexType = vertexType;
+    model.IndexFormat = indexFormat;
+    model.VertexCount = vertexCount;
+    model.IndexCount = indexCount;
+    model.Bounds = submeshes.front().Bounds;
+    for (const Submesh& submesh : submeshes)
+    {
+        DirectX::BoundingBox::CreateMerged(model.Bounds, model.Bounds, submesh.Bounds);
+    }
+
+    // Centered on the model's box, which is tighter than merging the submesh spheres one by one
+    const DirectX::XMVECTOR modelCenter = DirectX::XMLoadFloat3(&model.Bounds.Center);
+    model.SphereBounds.Center = model.Bounds.Center;
+    model.SphereBounds.Radius = 0.0f;
+    for (const Submesh& submesh : submeshes)
+    {
+        const float centerDistance = DirectX::XMVectorGetX(DirectX::XMVector3Length(
+            DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&submesh.SphereBounds.Center), modelCenter)));
+        const float radius = centerDistance + submesh.SphereBounds.Radius;
+        model.SphereBounds.Radius = radius > model.SphereBounds.Radius ? radius : model.SphereBounds.Radius;
+    }
+    model.Submeshes = std::move(submeshes);
+    model.Lods = std::move(lods);
+    model.LodIndexRanges = std::move(lodIndexRanges);
+
+    // Culling meshlets writes their index ranges into a separate buffer every frame
+    model.Meshlets = std::move(meshlets);
+    model.IndexData.clear();
+    if (!model.Meshlets.empty())
+    {
+        const size_t indexSize = GetIndexSize(indexFormat);
+        const uint8_t* indexBytes = static_cast<const uint8_t*>(indices);
+        model.IndexData.assign(indexBytes, indexBytes + indexSize * indexCount);
+    }
+
     return true;
 }
@@ -1,23 +1,79 @@
 #pragma once
 
-#include <d3d11.h>
-
-#include "Definitions.hpp"
+#include "RenderTypes.hpp"
+#include "VertexType.hpp"
 
+#include <filesystem>
+#include <memory>
 #include <string>
+#include <vector>
+
+class GeometryPool;
+struct IndexRange;
+struct Meshlet;
+struct Model;
+struct ModelLod;
+struct Submesh;
+
+// Optional steps run on a model after importing it. They are part of the cooked model's
+// cache key, so changing them imports the model again.
+enum ModelProcessingFlags : uint32_t
+{
+    ModelProcessingNone = 0,
+    ModelProcessingOptimizeMeshes = 1 << 0,
+    ModelProcessingWeldVertices = 1 << 1,
+    ModelProcessingWeldVerticesApproximately = 1 << 2,
+    ModelProcessingQuantizeVertices = 1 << 3,
+    ModelProcessingBuildMeshlets = 1 << 4,
+    ModelProcessingGenerateLods = 1 << 5,
+    // Packs the materials' diffuse textures into one atlas written next to the cooked model
+    // and moves the uvs into it, see Model::TextureAtlasFilePath
+    ModelProcessingBuildTextureAtlas = 1 << 6,
+};
+
+// Detail levels generated with ModelProcessingGenerateLods. Every level keeps LodReduction of the
+// previous level's triangles, MaxRelativeError limits how far a level may deviate from the model,
+// relative to the diagonal of its bounds. Part of the cooked model's cache key as well.
+struct ModelLodSettings
+{
+    uint32_t MaxLodCount = 4;
+    float LodReduction = 0.5f;
+    float MaxRelativeError = 0.02f;
+};
 
 class ModelFactory
 {
 public:
-    ModelFactory(const WRL::ComPtr<ID3D11Device>& device);
+    ModelFactory(const std::shared_ptr<GeometryPool>& geometryPool);
+
+    void SetLodSettings(const ModelLodSettings& lodSettings);
 
     bool LoadModel(
         const std::string& filePath,
-        WRL::ComPtr<ID3D11Buffer>& vertexBuffer,
-        uint32_t* vertexCount,
-        WRL::ComPtr<ID3D11Buffer>& indexBuffer,
-        uint32_t* indexCount);
+        uint32_t processingFlags,
+        Model& model);
 
 private:
-    WRL::ComPtr<ID3D11Device> _device = nullptr;
+    bool LoadCookedModel(
+        const std::filesystem::path& cookedFilePath,
+        const std::string& sourceFilePath,
+        uint64_t sourceSize,
+        int64_t sourceLastWriteTime,
+        uint32_t processingFlags,
+        Model& model);
+    bool CreateModel(
+        const void* vertices,
+        VertexType vertexType,
+        uint32_t vertexCount,
+        const void* indices,
+        RenderFormat indexFormat,
+        uint32_t indexCount,
+        std::vector<Submesh> submeshes,
+        std::vector<Meshlet> meshlets,
+        std::vector<ModelLod> lods,
+        std::vector<IndexRange> lodIndexRanges,
+        Model& model);
+
+    std::shared_ptr<GeometryPool> _geometryPool = nullptr;
+    ModelLodSettings _lodSettings = {};
 };
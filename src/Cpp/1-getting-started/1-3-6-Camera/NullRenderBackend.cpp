@@ -0,0 +1,831 @@
+#include "NullRenderBackend.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+std::string GetDebugName(const RenderObject* renderObject)
+{
+    if (renderObject == nullptr || renderObject->GetDebugName().empty())
+    {
+        return "<unnamed>";
+    }
+    return renderObject->GetDebugName();
+}
+
+// The full chain down to 1x1 when MipLevels is 0
+uint32_t GetMipLevels(const RenderTextureDescription& textureDescription)
+{
+    if (textureDescription.MipLevels > 0)
+    {
+        return textureDescription.MipLevels;
+    }
+
+    return GetFullMipLevelCount(textureDescription.Width, textureDescription.Height);
+}
+
+// What D3D11 reads of a 2D subresource: one row pitch per row of texels, or of 4x4 blocks for block compressed formats
+uint64_t GetSubresourceSize(
+    const RenderTextureDescription& textureDescription,
+    const uint32_t mip,
+    const uint32_t rowPitch)
+{
+    const uint32_t mipHeight = textureDescription.Height >> mip;
+    const uint32_t height = mipHeight > 0 ? mipHeight : 1;
+    const uint32_t rowCount = IsBlockCompressed(textureDescription.Format) ? (height + 3) / 4 : height;
+    return static_cast<uint64_t>(rowPitch) * rowCount;
+}
+} // namespace
+
+bool NullRenderBackend::CreateBuffer(
+    const RenderBufferDescription& description,
+    const void* initialData,
+    std::shared_ptr<RenderBuffer>& buffer)
+{
+    if (description.Size == 0)
+    {
+        ReportValidationError("CreateBuffer: Invalid buffer description");
+        return false;
+    }
+
+    if (description.Usage == RenderUsage::Immutable && initialData == nullptr)
+    {
+        ReportValidationError("CreateBuffer: Immutable buffers need initial data");
+        return false;
+    }
+
+    if ((description.BindFlags & RenderBindFlags::RenderBindConstantBuffer) != 0)
+    {
+        if (description.BindFlags != RenderBindFlags::RenderBindConstantBuffer || description.Size % 16 != 0)
+        {
+            ReportValidationError("CreateBuffer: Constant buffers must be exclusive and a multiple of 16 bytes in size");
+            return false;
+        }
+    }
+
+    buffer = std::make_shared<RenderBuffer>(description);
+    _statistics.CreatedObjects++;
+    if (initialData != nullptr)
+    {
+        _statistics.Uploads++;
+        _statistics.UploadedBytes += description.Size;
+    }
+    return true;
+}
+
+bool NullRenderBackend::CreateTexture2D(
+    const RenderTextureDescription& description,
+    const RenderSubresourceData* initialData,
+    std::shared_ptr<RenderTexture2D>& texture)
+{
+    if (description.Width == 0 ||
+        description.Height == 0 ||
+        description.Width > RenderMaxTextureDimension ||
+        description.Height > RenderMaxTextureDimension ||
+        description.ArraySize == 0 ||
+        description.ArraySize > RenderMaxTextureArraySize ||
+        description.MipLevels > GetFullMipLevelCount(description.Width, description.Height))
+    {
+        ReportValidationError("CreateTexture2D: Invalid texture description");
+        return false;
+    }
+
+    if (description.Usage == RenderUsage::Immutable && (initialData == nullptr || initialData->Data == nullptr))
+    {
+        ReportValidationError("CreateTexture2D: Immutable textures need initial data");
+        return false;
+    }
+
+    texture = std::make_shared<RenderTexture2D>(description);
+    _statistics.CreatedObjects++;
+    if (initialData != nullptr && initialData->Data != nullptr)
+    {
+        // Counted from the row pitches, D3D11 ignores the slice pitches of 2D textures and so may callers
+        _statistics.Uploads++;
+        const uint32_t mipLevels = GetMipLevels(description);
+        for (uint32_t i = 0; i < mipLevels * description.ArraySize; i++)
+        {
+            _statistics.UploadedBytes += GetSubresourceSize(description, i % mipLevels, initialData[i].RowPitch);
+        }
+    }
+    return true;
+}
+
+bool NullRenderBackend::CreateShaderResourceView(
+    RenderTexture2D* texture,
+    const RenderShaderResourceViewDescription& description,
+    std::shared_ptr<RenderShaderResourceView>& shaderResourceView)
+{
+    if (texture == nullptr)
+    {
+        ReportValidationError("CreateShaderResourceView: No texture given");
+        return false;
+    }
+
+    const RenderTextureDescription& textureDescription = texture->GetDescription();
+    if ((textureDescription.BindFlags & RenderBindFlags::RenderBindShaderResource) == 0)
+    {
+        ReportValidationError("CreateShaderResourceView: " + GetDebugName(texture) + " was not created with RenderBindShaderResource");
+        return false;
+    }
+
+    if (description.MostDetailedMip + description.MipLevels > GetMipLevels(textureDescription) ||
+        description.FirstArraySlice + description.ArraySize > textureDescription.ArraySize)
+    {
+        ReportValidationError("CreateShaderResourceView: View is outside of " + GetDebugName(texture));
+        return false;
+    }
+
+    shaderResourceView = std::make_shared<RenderShaderResourceView>(description);
+    _statistics.CreatedObjects++;
+    return true;
+}
+
+bool NullRenderBackend::CreateSamplerState(
+    const RenderSamplerDescription& description,
+    std::shared_ptr<RenderSamplerState>& samplerState)
+{
+    if (description.MinLod > description.MaxLod)
+    {
+        ReportValidationError("CreateSamplerState: MinLod must not be larger than MaxLod");
+        return false;
+    }
+
+    samplerState = std::make_shared<RenderSamplerState>(description);
+    _statistics.CreatedObjects++;
+    return true;
+}
+
+bool NullRenderBackend::CreateDepthStencilState(
+    const RenderDepthStencilDescription& description,
+    std::shared_ptr<RenderDepthStencilState>& depthStencilState)
+{
+    depthStencilState = std::make_shared<RenderDepthStencilState>(description);
+    _statistics.CreatedObjects++;
+    return true;
+}
+
+bool NullRenderBackend::CreateRasterizerState(
+    const RenderRasterizerDescription& description,
+    std::shared_ptr<RenderRasterizerState>& rasterizerState)
+{
+    rasterizerState = std::make_shared<RenderRasterizerState>(description);
+    _statistics.CreatedObjects++;
+    return true;
+}
+
+bool NullRenderBackend::CreateVertexShader(
+    const void* byteCode,
+    const size_t byteCodeSize,
+    std::shared_ptr<RenderVertexShader>& vertexShader)
+{
+    if (byteCode == nullptr || byteCodeSize == 0)
+    {
+        ReportValidationError("CreateVertexShader: No byte code given");
+        return false;
+    }
+
+    vertexShader = std::make_shared<RenderVertexShader>();
+    _statistics.CreatedObjects++;
+    return true;
+}
+
+bool NullRenderBackend::CreatePixelShader(
+    const void* byteCode,
+    const size_t byteCodeSize,
+    std::shared_ptr<RenderPixelShader>& pixelShader)
+{
+    if (byteCode == nullptr || byteCodeSize == 0)
+    {
+        ReportValidationError("CreatePixelShader: No byte code given");
+        return false;
+    }
+
+    pixelShader = std::make_shared<RenderPixelShader>();
+    _statistics.CreatedObjects++;
+    return true;
+}
+
+bool NullRenderBackend::CreateInputLayout(
+    const RenderInputElement* elements,
+    const uint32_t elementCount,
+    const void* byteCode,
+    const size_t byteCodeSize,
+    std::shared_ptr<RenderInputLayout>& inputLayout)
+{
+    if (elements == nullptr || elementCount == 0 || byteCode == nullptr || byteCodeSize == 0)
+    {
+        ReportValidationError("CreateInputLayout: Input layouts need elements and vertex shader byte code");
+        return false;
+    }
+
+    inputLayout = std::make_shared<RenderInputLayout>();
+    _statistics.CreatedObjects++;
+    return true;
+}
+
+// Reading the source still fails for missing files, like compiling would
+bool NullRenderBackend::CompileShader(
+    const std::wstring& filePath,
+    const std::string& entryPoint,
+    const std::string& profile,
+    std::vector<uint8_t>& byteCode)
+{
+    std::ifstream file(std::filesystem::path(filePath), std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "NullRenderBackend: Failed to read shader " << std::filesystem::path(filePath).u8string() << "\n";
+        return false;
+    }
+
+    byteCode.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (byteCode.empty())
+    {
+        std::cout << "NullRenderBackend: Shader " << std::filesystem::path(filePath).u8string() << " is empty\n";
+        return false;
+    }
+
+    _compiledShaders++;
+    return true;
+}
+
+void NullRenderBackend::PrintShaderStatistics() const
+{
+    std::cout << "NullRenderBackend: Shaders read instead of compiled: " << _compiledShaders << "\n";
+}
+
+void NullRenderBackend::ClearRenderTargetView(
+    RenderTargetView* renderTarget,
+    const float clearColor[4])
+{
+    _statistics.Clears++;
+}
+
+void NullRenderBackend::ClearDepthStencilView(
+    RenderDepthStencilView* depthStencilView,
+    const uint32_t clearFlags,
+    const float clearDepth,
+    const uint8_t clearStencil)
+{
+    if (clearDepth < 0.0f || clearDepth > 1.0f)
+    {
+        ReportValidationError("ClearDepthStencilView: Depth must be within [0, 1]");
+    }
+    _statistics.Clears++;
+}
+
+void NullRenderBackend::OMSetRenderTargets(
+    const uint32_t renderTargetCount,
+    RenderTargetView* const* renderTargets,
+    RenderDepthStencilView* depthStencilView)
+{
+    _statistics.StateBinds++;
+}
+
+void NullRenderBackend::IASetInputLayout(RenderInputLayout* inputLayout)
+{
+    _inputLayout = inputLayout;
+    _statistics.StateBinds++;
+}
+
+void NullRenderBackend::IASetPrimitiveTopology(const RenderPrimitiveTopology primitiveTopology)
+{
+    _primitiveTopology = primitiveTopology;
+    _statistics.StateBinds++;
+}
+
+void NullRenderBackend::IASetVertexBuffers(
+    const uint32_t startSlot,
+    const uint32_t bufferCount,
+    RenderBuffer* const* vertexBuffers,
+    const uint32_t* strides,
+    const uint32_t* offsets)
+{
+    _statistics.ResourceBinds += bufferCount;
+    if (!ValidateSlotRange(startSlot, bufferCount, RenderVertexBufferSlotCount, "IASetVertexBuffers"))
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < bufferCount; i++)
+    {
+        ValidateBufferBinding(vertexBuffers[i], RenderBindFlags::RenderBindVertexBuffer, "IASetVertexBuffers");
+    }
+
+    if (startSlot == 0 && bufferCount > 0)
+    {
+        _vertexBuffer = vertexBuffers[0];
+        _vertexStride = strides[0];
+        _vertexOffset = offsets[0];
+    }
+}
+
+void NullRenderBackend::IASetIndexBuffer(
+    RenderBuffer* indexBuffer,
+    const RenderFormat format,
+    const uint32_t offset)
+{
+    _statistics.ResourceBinds++;
+    ValidateBufferBinding(indexBuffer, RenderBindFlags::RenderBindIndexBuffer, "IASetIndexBuffer");
+    if (indexBuffer != nullptr && format != RenderFormat::R16Uint && format != RenderFormat::R32Uint)
+    {
+        ReportValidationError("IASetIndexBuffer: Index format must be RenderFormat::R16Uint or RenderFormat::R32Uint");
+    }
+
+    _indexBuffer = indexBuffer;
+    _indexFormat = format;
+    _indexOffset = offset;
+}
+
+void NullRenderBackend::VSSetShader(RenderVertexShader* vertexShader)
+{
+    _vertexShader = vertexShader;
+    _statistics.StateBinds++;
+}
+
+void NullRenderBackend::PSSetShader(RenderPixelShader* pixelShader)
+{
+    _pixelShader = pixelShader;
+    _statistics.StateBinds++;
+}
+
+void NullRenderBackend::VSSetConstantBuffers(
+    const uint32_t startSlot,
+    const uint32_t bufferCount,
+    RenderBuffer* const* constantBuffers)
+{
+    _statistics.ResourceBinds += bufferCount;
+    if (!ValidateSlotRange(startSlot, bufferCount, RenderConstantBufferSlotCount, "VSSetConstantBuffers"))
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < bufferCount; i++)
+    {
+        ValidateBufferBinding(constantBuffers[i], RenderBindFlags::RenderBindConstantBuffer, "VSSetConstantBuffers");
+    }
+}
+
+void NullRenderBackend::PSSetConstantBuffers(
+    const uint32_t startSlot,
+    const uint32_t bufferCount,
+    RenderBuffer* const* constantBuffers)
+{
+    _statistics.ResourceBinds += bufferCount;
+    if (!ValidateSlotRange(startSlot, bufferCount, RenderConstantBufferSlotCount, "PSSetConstantBuffers"))
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < bufferCount; i++)
+    {
+        ValidateBufferBinding(constantBuffers[i], RenderBindFlags::RenderBindConstantBuffer, "PSSetConstantBuffers");
+    }
+}
+
+void NullRenderBackend::PSSetShaderResources(
+    const uint32_t startSlot,
+    const uint32_t viewCount,
+    RenderShaderResourceView* const* shaderResourceViews)
+{
+    _statistics.ResourceBinds += viewCount;
+    ValidateSlotRange(startSlot, viewCount, RenderShaderResourceSlotCount, "PSSetShaderResources");
+}
+
+void NullRenderBackend::PSSetSamplers(
+    const uint32_t startSlot,
+    const uint32_t samplerCount,
+    RenderSamplerState* const* samplers)
+{
+    _statistics.ResourceBinds += samplerCount;
+    ValidateSlotRange(startSlot, samplerCount, RenderSamplerSlotCount, "PSSetSamplers");
+}
+
+void NullRenderBackend::OMSetDepthStencilState(
+    RenderDepthStencilState* depthStencilState,
+    const uint32_t stencilReference)
+{
+    _statistics.StateBinds++;
+}
+
+void NullRenderBackend::RSSetViewports(
+    const uint32_t viewportCount,
+    const RenderViewport* viewports)
+{
+    _statistics.StateBinds++;
+    for (uint32_t i = 0; i < viewportCount; i++)
+    {
+        if (viewports[i].Width <= 0.0f || viewports[i].Height <= 0.0f)
+        {
+            ReportValidationError("RSSetViewports: Viewports must have a positive size");
+        }
+    }
+    _viewportCount = viewportCount;
+}
+
+void NullRenderBackend::RSSetState(RenderRasterizerState* rasterizerState)
+{
+    _statistics.StateBinds++;
+}
+
+void NullRenderBackend::UpdateSubresource(
+    RenderResource* resource,
+    const uint32_t subresource,
+    const RenderBox* box,
+    const void* data,
+    const uint32_t rowPitch,
+    const uint32_t depthPitch)
+{
+    _statistics.Updates++;
+    if (resource == nullptr || data == nullptr)
+    {
+        ReportValidationError("UpdateSubresource: No resource or data given");
+        return;
+    }
+
+    if (resource->GetDimension() == RenderResourceDimension::Buffer)
+    {
+        const RenderBufferDescription& bufferDescription = static_cast<RenderBuffer*>(resource)->GetDescription();
+        if (bufferDescription.Usage != RenderUsage::Default)
+        {
+            ReportValidationError("UpdateSubresource: " + GetDebugName(resource) + " is not a RenderUsage::Default buffer");
+            return;
+        }
+
+        if (box == nullptr)
+        {
+            _statistics.UpdatedBytes += bufferDescription.Size;
+            return;
+        }
+
+        // Constant buffers can only be updated as a whole
+        if (box->Left >= box->Right || box->Right > bufferDescription.Size ||
+            (bufferDescription.BindFlags & RenderBindFlags::RenderBindConstantBuffer) != 0)
+        {
+            ReportValidationError("UpdateSubresource: Box is outside of " + GetDebugName(resource));
+            return;
+        }
+        _statistics.UpdatedBytes += box->Right - box->Left;
+    }
+    else
+    {
+        const RenderTextureDescription& textureDescription = static_cast<RenderTexture2D*>(resource)->GetDescription();
+        if (textureDescription.Usage != RenderUsage::Default)
+        {
+            ReportValidationError("UpdateSubresource: " + GetDebugName(resource) + " is not a RenderUsage::Default texture");
+            return;
+        }
+        _statistics.UpdatedBytes += GetSubresourceSize(textureDescription, subresource % GetMipLevels(textureDescription), rowPitch);
+    }
+}
+
+void NullRenderBackend::CopySubresourceRegion(
+    RenderResource* destinationResource,
+    const uint32_t destinationSubresource,
+    const uint32_t destinationX,
+    const uint32_t destinationY,
+    const uint32_t destinationZ,
+    RenderResource* sourceResource,
+    const uint32_t sourceSubresource,
+    const RenderBox* sourceBox)
+{
+    _statistics.Copies++;
+    if (destinationResource == nullptr || sourceResource == nullptr)
+    {
+        ReportValidationError("CopySubresourceRegion: No source or destination given");
+        return;
+    }
+
+    const RenderResourceDimension destinationDimension = destinationResource->GetDimension();
+    const RenderResourceDimension sourceDimension = sourceResource->GetDimension();
+    if (destinationDimension == RenderResourceDimension::Texture2D &&
+        sourceDimension == RenderResourceDimension::Texture2D)
+    {
+        CopyTextureSubresource(
+            static_cast<RenderTexture2D*>(destinationResource),
+            destinationSubresource,
+            destinationX,
+            destinationY,
+            destinationZ,
+            static_cast<RenderTexture2D*>(sourceResource),
+            sourceSubresource,
+            sourceBox);
+        return;
+    }
+
+    if (destinationDimension != RenderResourceDimension::Buffer ||
+        sourceDimension != RenderResourceDimension::Buffer ||
+        destinationSubresource != 0 ||
+        sourceSubresource != 0)
+    {
+        ReportValidationError("CopySubresourceRegion: Only copies between buffers are recorded");
+        return;
+    }
+
+    const RenderBufferDescription& destinationDescription = static_cast<RenderBuffer*>(destinationResource)->GetDescription();
+    const RenderBufferDescription& sourceDescription = static_cast<RenderBuffer*>(sourceResource)->GetDescription();
+    if (destinationDescription.Usage == RenderUsage::Immutable)
+    {
+        ReportValidationError("CopySubresourceRegion: " + GetDebugName(destinationResource) + " is immutable");
+        return;
+    }
+
+    const uint32_t sourceBegin = sourceBox != nullptr ? sourceBox->Left : 0;
+    const uint32_t sourceEnd = sourceBox != nullptr ? sourceBox->Right : sourceDescription.Size;
+    const uint32_t size = sourceEnd > sourceBegin ? sourceEnd - sourceBegin : 0;
+    if (size == 0 ||
+        sourceEnd > sourceDescription.Size ||
+        destinationX + size > destinationDescription.Size ||
+        destinationY != 0 ||
+        destinationZ != 0)
+    {
+        ReportValidationError("CopySubresourceRegion: Range is outside of " + GetDebugName(sourceResource) + " or " + GetDebugName(destinationResource));
+        return;
+    }
+
+    if (destinationResource == sourceResource && destinationX < sourceEnd && sourceBegin < destinationX + size)
+    {
+        ReportValidationError("CopySubresourceRegion: Source and destination overlap in " + GetDebugName(sourceResource));
+        return;
+    }
+
+    _statistics.CopiedBytes += size;
+}
+
+bool NullRenderBackend::Map(
+    RenderResource* resource,
+    const uint32_t subresource,
+    const RenderMapType mapType,
+    RenderMappedSubresource* mappedSubresource)
+{
+    if (resource == nullptr || mappedSubresource == nullptr)
+    {
+        ReportValidationError("Map: No resource or mapped subresource given");
+        return false;
+    }
+
+    if (resource->GetDimension() != RenderResourceDimension::Buffer || subresource != 0)
+    {
+        ReportValidationError("Map: Only buffers can be mapped");
+        return false;
+    }
+
+    const RenderBufferDescription& bufferDescription = static_cast<RenderBuffer*>(resource)->GetDescription();
+    if (bufferDescription.Usage != RenderUsage::Dynamic)
+    {
+        ReportValidationError("Map: " + GetDebugName(resource) + " must be a RenderUsage::Dynamic buffer");
+        return false;
+    }
+
+    if (_mappedResource != nullptr)
+    {
+        ReportValidationError("Map: " + GetDebugName(_mappedResource) + " is still mapped");
+        return false;
+    }
+
+    _mappedData.resize(bufferDescription.Size);
+    _mappedResource = resource;
+    mappedSubresource->Data = _mappedData.data();
+    mappedSubresource->RowPitch = bufferDescription.Size;
+    mappedSubresource->DepthPitch = bufferDescription.Size;
+    return true;
+}
+
+void NullRenderBackend::Unmap(
+    RenderResource* resource,
+    const uint32_t subresource)
+{
+    if (resource == nullptr || resource != _mappedResource)
+    {
+        ReportValidationError("Unmap: " + GetDebugName(resource) + " is not mapped");
+        return;
+    }
+
+    _statistics.Updates++;
+    _statistics.UpdatedBytes += _mappedData.size();
+    _mappedResource = nullptr;
+}
+
+void NullRenderBackend::Draw(
+    const uint32_t vertexCount,
+    const uint32_t startVertex)
+{
+    _statistics.Draws++;
+    _statistics.DrawnVertices += vertexCount;
+    if (!ValidateDrawState("Draw"))
+    {
+        return;
+    }
+
+    const uint64_t lastByte = _vertexOffset + static_cast<uint64_t>(startVertex + vertexCount) * _vertexStride;
+    if (lastByte > _vertexBuffer->GetDescription().Size)
+    {
+        ReportValidationError("Draw: Reads past the end of vertex buffer " + GetDebugName(_vertexBuffer));
+    }
+}
+
+void NullRenderBackend::DrawIndexed(
+    const uint32_t indexCount,
+    const uint32_t startIndex,
+    const int32_t baseVertex)
+{
+    _statistics.Draws++;
+    _statistics.DrawnVertices += indexCount;
+    if (!ValidateDrawState("DrawIndexed"))
+    {
+        return;
+    }
+
+    if (_indexBuffer == nullptr)
+    {
+        ReportValidationError("DrawIndexed: No index buffer bound");
+        return;
+    }
+
+    const uint64_t lastByte = _indexOffset + static_cast<uint64_t>(startIndex + indexCount) * GetIndexSize(_indexFormat);
+    if (lastByte > _indexBuffer->GetDescription().Size)
+    {
+        ReportValidationError("DrawIndexed: Reads past the end of index buffer " + GetDebugName(_indexBuffer));
+    }
+}
+
+void NullRenderBackend::Flush()
+{
+}
+
+RenderTargetView* NullRenderBackend::GetBackBufferRenderTarget() const
+{
+    return nullptr;
+}
+
+RenderDepthStencilView* NullRenderBackend::GetBackBufferDepthStencil() const
+{
+    return nullptr;
+}
+
+bool NullRenderBackend::ResizeBackBuffer(
+    const uint32_t width,
+    const uint32_t height)
+{
+    return true;
+}
+
+void NullRenderBackend::Present()
+{
+}
+
+void NullRenderBackend::NewUiFrame()
+{
+}
+
+void NullRenderBackend::RenderUiDrawData()
+{
+}
+
+const NullRenderBackendStatistics& NullRenderBackend::GetStatistics() const
+{
+    return _statistics;
+}
+
+void NullRenderBackend::PrintStatistics() const
+{
+    std::cout << "NullRenderBackend: Created objects: " << _statistics.CreatedObjects << "\n";
+    std::cout << "NullRenderBackend: State binds: " << _statistics.StateBinds << "\n";
+    std::cout << "NullRenderBackend: Resource binds: " << _statistics.ResourceBinds << "\n";
+    std::cout << "NullRenderBackend: Clears: " << _statistics.Clears << "\n";
+    std::cout << "NullRenderBackend: Uploads: " << _statistics.Uploads << " (" << _statistics.UploadedBytes << " bytes)\n";
+    std::cout << "NullRenderBackend: Updates: " << _statistics.Updates << " (" << _statistics.UpdatedBytes << " bytes)\n";
+    std::cout << "NullRenderBackend: Copies: " << _statistics.Copies << " (" << _statistics.CopiedBytes << " bytes)\n";
+    std::cout << "NullRenderBackend: Draws: " << _statistics.Draws << " (" << _statistics.DrawnVertices << " vertices)\n";
+    std::cout << "NullRenderBackend: Validation errors: " << _statistics.ValidationErrors << "\n";
+}
+
+bool NullRenderBackend::ValidateBufferBinding(
+    RenderBuffer* buffer,
+    const uint32_t bindFlag,
+    const char* bindingName)
+{
+    if (buffer == nullptr)
+    {
+        return true;
+    }
+
+    if ((buffer->GetDescription().BindFlags & bindFlag) == 0)
+    {
+        ReportValidationError(std::string(bindingName) + ": " + GetDebugName(buffer) + " was not created with the matching bind flag");
+        return false;
+    }
+    return true;
+}
+
+bool NullRenderBackend::ValidateSlotRange(
+    const uint32_t startSlot,
+    const uint32_t count,
+    const uint32_t slotCount,
+    const char* bindingName)
+{
+    if (startSlot + count > slotCount)
+    {
+        ReportValidationError(std::string(bindingName) + ": Slot range exceeds " + std::to_string(slotCount) + " slots");
+        return false;
+    }
+    return true;
+}
+
+bool NullRenderBackend::ValidateDrawState(const char* drawName)
+{
+    const char* missingState = nullptr;
+    if (_inputLayout == nullptr)
+    {
+        missingState = "input layout";
+    }
+    else if (_primitiveTopology == RenderPrimitiveTopology::Undefined)
+    {
+        missingState = "primitive topology";
+    }
+    else if (_vertexShader == nullptr)
+    {
+        missingState = "vertex shader";
+    }
+    else if (_pixelShader == nullptr)
+    {
+        missingState = "pixel shader";
+    }
+    else if (_viewportCount == 0)
+    {
+        missingState = "viewport";
+    }
+    else if (_vertexBuffer == nullptr)
+    {
+        missingState = "vertex buffer";
+    }
+
+    if (missingState != nullptr)
+    {
+        ReportValidationError(std::string(drawName) + ": No " + missingState + " bound");
+        return false;
+    }
+    return true;
+}
+
+// Only whole subresources of the same size and format are copied between textures, which is what
+// streaming mips in and out needs. Their bytes are not counted, they depend on the format
+void NullRenderBackend::CopyTextureSubresource(
+    RenderTexture2D* destinationTexture,
+    const uint32_t destinationSubresource,
+    const uint32_t destinationX,
+    const uint32_t destinationY,
+    const uint32_t destinationZ,
+    RenderTexture2D* sourceTexture,
+    const uint32_t sourceSubresource,
+    const RenderBox* sourceBox)
+{
+    const RenderTextureDescription& destinationDescription = destinationTexture->GetDescription();
+    const RenderTextureDescription& sourceDescription = sourceTexture->GetDescription();
+    if (destinationDescription.Usage == RenderUsage::Immutable)
+    {
+        ReportValidationError("CopySubresourceRegion: " + GetDebugName(destinationTexture) + " is immutable");
+        return;
+    }
+
+    const uint32_t destinationMipLevels = GetMipLevels(destinationDescription);
+    const uint32_t sourceMipLevels = GetMipLevels(sourceDescription);
+    if (destinationSubresource >= destinationMipLevels * destinationDescription.ArraySize ||
+        sourceSubresource >= sourceMipLevels * sourceDescription.ArraySize)
+    {
+        ReportValidationError("CopySubresourceRegion: Subresource is outside of " + GetDebugName(sourceTexture) + " or " + GetDebugName(destinationTexture));
+        return;
+    }
+
+    const uint32_t destinationMip = destinationSubresource % destinationMipLevels;
+    const uint32_t sourceMip = sourceSubresource % sourceMipLevels;
+    const uint32_t destinationWidth = destinationDescription.Width >> destinationMip;
+    const uint32_t destinationHeight = destinationDescription.Height >> destinationMip;
+    const uint32_t sourceWidth = sourceDescription.Width >> sourceMip;
+    const uint32_t sourceHeight = sourceDescription.Height >> sourceMip;
+    if (sourceBox != nullptr ||
+        destinationX != 0 ||
+        destinationY != 0 ||
+        destinationZ != 0 ||
+        destinationDescription.Format != sourceDescription.Format ||
+        (destinationWidth > 1 ? destinationWidth : 1) != (sourceWidth > 1 ? sourceWidth : 1) ||
+        (destinationHeight > 1 ? destinationHeight : 1) != (sourceHeight > 1 ? sourceHeight : 1))
+    {
+        ReportValidationError("CopySubresourceRegion: Only whole subresources of the same size and format are recorded between textures");
+        return;
+    }
+
+    if (destinationTexture == sourceTexture && destinationSubresource == sourceSubresource)
+    {
+        ReportValidationError("CopySubresourceRegion: Source and destination overlap in " + GetDebugName(sourceTexture));
+    }
+}
+
+void NullRenderBackend::ReportValidationError(const std::string& message)
+{
+    _statistics.ValidationErrors++;
+    std::cout << "NullRenderBackend: " << message << "\n";
+}
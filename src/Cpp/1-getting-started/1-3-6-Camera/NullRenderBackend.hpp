@@ -0,0 +1,212 @@
+#pragma once
+
+#include "RenderBackend.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct NullRenderBackendStatistics
+{
+    uint64_t CreatedObjects = 0;
+    uint64_t StateBinds = 0;
+    uint64_t ResourceBinds = 0;
+    uint64_t Clears = 0;
+    uint64_t Uploads = 0;
+    uint64_t UploadedBytes = 0;
+    uint64_t Updates = 0;
+    uint64_t UpdatedBytes = 0;
+    uint64_t Copies = 0;
+    uint64_t CopiedBytes = 0;
+    uint64_t Draws = 0;
+    uint64_t DrawnVertices = 0;
+    uint64_t ValidationErrors = 0;
+};
+
+// Records every call instead of talking to a GPU. Objects handed out by the Create*
+// functions are the plain render objects, which remember their descriptions, so binds,
+// updates and draws can be validated the way the debug layer would (missing shaders,
+// wrong bind flags, draws reading past the bound buffers, ...). Shaders are not compiled,
+// their source stands in for the byte code.
+class NullRenderBackend final : public RenderBackend
+{
+public:
+    bool CreateBuffer(
+        const RenderBufferDescription& description,
+        const void* initialData,
+        std::shared_ptr<RenderBuffer>& buffer) override;
+    bool CreateTexture2D(
+        const RenderTextureDescription& description,
+        const RenderSubresourceData* initialData,
+        std::shared_ptr<RenderTexture2D>& texture) override;
+    bool CreateShaderResourceView(
+        RenderTexture2D* texture,
+        const RenderShaderResourceViewDescription& description,
+        std::shared_ptr<RenderShaderResourceView>& shaderResourceView) override;
+    bool CreateSamplerState(
+        const RenderSamplerDescription& description,
+        std::shared_ptr<RenderSamplerState>& samplerState) override;
+    bool CreateDepthStencilState(
+        const RenderDepthStencilDescription& description,
+        std::shared_ptr<RenderDepthStencilState>& depthStencilState) override;
+    bool CreateRasterizerState(
+        const RenderRasterizerDescription& description,
+        std::shared_ptr<RenderRasterizerState>& rasterizerState) override;
+    bool CreateVertexShader(
+        const void* byteCode,
+        size_t byteCodeSize,
+        std::shared_ptr<RenderVertexShader>& vertexShader) override;
+    bool CreatePixelShader(
+        const void* byteCode,
+        size_t byteCodeSize,
+        std::shared_ptr<RenderPixelShader>& pixelShader) override;
+    bool CreateInputLayout(
+        const RenderInputElement* elements,
+        uint32_t elementCount,
+        const void* byteCode,
+        size_t byteCodeSize,
+        std::shared_ptr<RenderInputLayout>& inputLayout) override;
+
+    bool CompileShader(
+        const std::wstring& filePath,
+        const std::string& entryPoint,
+        const std::string& profile,
+        std::vector<uint8_t>& byteCode) override;
+    void PrintShaderStatistics() const override;
+
+    void ClearRenderTargetView(
+        RenderTargetView* renderTarget,
+        const float clearColor[4]) override;
+    void ClearDepthStencilView(
+        RenderDepthStencilView* depthStencilView,
+        uint32_t clearFlags,
+        float clearDepth,
+        uint8_t clearStencil) override;
+    void OMSetRenderTargets(
+        uint32_t renderTargetCount,
+        RenderTargetView* const* renderTargets,
+        RenderDepthStencilView* depthStencilView) override;
+    void IASetInputLayout(RenderInputLayout* inputLayout) override;
+    void IASetPrimitiveTopology(RenderPrimitiveTopology primitiveTopology) override;
+    void IASetVertexBuffers(
+        uint32_t startSlot,
+        uint32_t bufferCount,
+        RenderBuffer* const* vertexBuffers,
+        const uint32_t* strides,
+        const uint32_t* offsets) override;
+    void IASetIndexBuffer(
+        RenderBuffer* indexBuffer,
+        RenderFormat format,
+        uint32_t offset) override;
+    void VSSetShader(RenderVertexShader* vertexShader) override;
+    void PSSetShader(RenderPixelShader* pixelShader) override;
+    void VSSetConstantBuffers(
+        uint32_t startSlot,
+        uint32_t bufferCount,
+        RenderBuffer* const* constantBuffers) override;
+    void PSSetConstantBuffers(
+        uint32_t startSlot,
+        uint32_t bufferCount,
+        RenderBuffer* const* constantBuffers) override;
+    void PSSetShaderResources(
+        uint32_t startSlot,
+        uint32_t viewCount,
+        RenderShaderResourceView* const* shaderResourceViews) override;
+    void PSSetSamplers(
+        uint32_t startSlot,
+        uint32_t samplerCount,
+        RenderSamplerState* const* samplers) override;
+    void OMSetDepthStencilState(
+        RenderDepthStencilState* depthStencilState,
+        uint32_t stencilReference) override;
+    void RSSetViewports(
+        uint32_t viewportCount,
+        const RenderViewport* viewports) override;
+    void RSSetState(RenderRasterizerState* rasterizerState) override;
+    void UpdateSubresource(
+        RenderResource* resource,
+        uint32_t subresource,
+        const RenderBox* box,
+        const void* data,
+        uint32_t rowPitch,
+        uint32_t depthPitch) override;
+    void CopySubresourceRegion(
+        RenderResource* destinationResource,
+        uint32_t destinationSubresource,
+        uint32_t destinationX,
+        uint32_t destinationY,
+        uint32_t destinationZ,
+        RenderResource* sourceResource,
+        uint32_t sourceSubresource,
+        const RenderBox* sourceBox) override;
+    bool Map(
+        RenderResource* resource,
+        uint32_t subresource,
+        RenderMapType mapType,
+        RenderMappedSubresource* mappedSubresource) override;
+    void Unmap(
+        RenderResource* resource,
+        uint32_t subresource) override;
+    void Draw(
+        uint32_t vertexCount,
+        uint32_t startVertex) override;
+    void DrawIndexed(
+        uint32_t indexCount,
+        uint32_t startIndex,
+        int32_t baseVertex) override;
+    void Flush() override;
+
+    [[nodiscard]] RenderTargetView* GetBackBufferRenderTarget() const override;
+    [[nodiscard]] RenderDepthStencilView* GetBackBufferDepthStencil() const override;
+    bool ResizeBackBuffer(
+        uint32_t width,
+        uint32_t height) override;
+    void Present() override;
+
+    void NewUiFrame() override;
+    void RenderUiDrawData() override;
+
+    [[nodiscard]] const NullRenderBackendStatistics& GetStatistics() const;
+    void PrintStatistics() const;
+
+private:
+    bool ValidateBufferBinding(
+        RenderBuffer* buffer,
+        uint32_t bindFlag,
+        const char* bindingName);
+    bool ValidateSlotRange(
+        uint32_t startSlot,
+        uint32_t count,
+        uint32_t slotCount,
+        const char* bindingName);
+    bool ValidateDrawState(const char* drawName);
+    void CopyTextureSubresource(
+        RenderTexture2D* destinationTexture,
+        uint32_t destinationSubresource,
+        uint32_t destinationX,
+        uint32_t destinationY,
+        uint32_t destinationZ,
+        RenderTexture2D* sourceTexture,
+        uint32_t sourceSubresource,
+        const RenderBox* sourceBox);
+    void ReportValidationError(const std::string& message);
+
+    // Only compared against null and read while bound, the binding side keeps them alive
+    RenderInputLayout* _inputLayout = nullptr;
+    RenderVertexShader* _vertexShader = nullptr;
+    RenderPixelShader* _pixelShader = nullptr;
+    RenderBuffer* _vertexBuffer = nullptr;
+    RenderBuffer* _indexBuffer = nullptr;
+    RenderPrimitiveTopology _primitiveTopology = RenderPrimitiveTopology::Undefined;
+    RenderFormat _indexFormat = RenderFormat::Unknown;
+    uint32_t _vertexStride = 0;
+    uint32_t _vertexOffset = 0;
+    uint32_t _indexOffset = 0;
+    uint32_t _viewportCount = 0;
+    // Backs every mapped buffer, only one can be mapped at a time
+    std::vector<uint8_t> _mappedData;
+    RenderResource* _mappedResource = nullptr;
+    std::atomic<uint32_t> _compiledShaders = 0;
+    NullRenderBackendStatistics _statistics = {};
+};
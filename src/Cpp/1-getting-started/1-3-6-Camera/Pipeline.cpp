@@ -1,28 +1,23 @@
 #include "Pipeline.hpp"
 
-void Pipeline::BindTexture(uint32_t slotIndex, ID3D11ShaderResourceView* texture)
+void Pipeline::BindTexture(uint32_t slotIndex, const std::shared_ptr<RenderShaderResourceView>& texture)
 {
-    ResourceDescriptor descriptor = {};
-    descriptor.SlotIndex = slotIndex;
-    descriptor.Type = ResourceType::Texture;
-    _resources[descriptor] = static_cast<ID3D11DeviceChild*>(texture);
+    _pixelShaderResources.Set(slotIndex, texture);
 }
 
-void Pipeline::BindSampler(uint32_t slotIndex, ID3D11SamplerState* sampler)
+void Pipeline::BindSampler(uint32_t slotIndex, const std::shared_ptr<RenderSamplerState>& sampler)
 {
-    ResourceDescriptor descriptor = {};
-    descriptor.SlotIndex = slotIndex;
-    descriptor.Type = ResourceType::Sampler;
-    _resources[descriptor] = static_cast<ID3D11DeviceChild*>(sampler);
+    _pixelSamplers.Set(slotIndex, sampler);
 }
 
-void Pipeline::BindVertexStageConstantBuffer(uint32_t slotIndex, ID3D11Buffer* buffer)
+void Pipeline::BindVertexStageConstantBuffer(uint32_t slotIndex, const std::shared_ptr<RenderBuffer>& buffer)
 {
-    ResourceDescriptor descriptor = {};
-    descriptor.SlotIndex = slotIndex;
-    descriptor.Stage = ResourceStage::VertexStage;
-    descriptor.Type = ResourceType::Buffer;
-    _resources[descriptor] = static_cast<ID3D11DeviceChild*>(buffer);
+    _vertexConstantBuffers.Set(slotIndex, buffer);
+}
+
+void Pipeline::BindPixelStageConstantBuffer(uint32_t slotIndex, const std::shared_ptr<RenderBuffer>& buffer)
+{
+    _pixelConstantBuffers.Set(slotIndex, buffer);
 }
 
 void Pipeline::SetViewport(
@@ -31,20 +26,20 @@ void Pipeline::SetViewport(
     const float width,
     const float height)
 {
-    _viewport.TopLeftX = left;
-    _viewport.TopLeftY = top;
+    _viewport.Left = left;
+    _viewport.Top = top;
     _viewport.Width = width;
     _viewport.Height = height;
     _viewport.MinDepth = 0.0f;
     _viewport.MaxDepth = 1.0f;
 }
 
-void Pipeline::SetDepthStencilState(ID3D11DepthStencilState* depthStencilState)
+void Pipeline::SetDepthStencilState(const std::shared_ptr<RenderDepthStencilState>& depthStencilState)
 {
     _depthStencilState = depthStencilState;
 }
 
-void Pipeline::SetRasterizerState(ID3D11RasterizerState* rasterizerState)
+void Pipeline::SetRasterizerState(const std::shared_ptr<RenderRasterizerState>& rasterizerState)
 {
     _rasterizerState = rasterizerState;
 }
@@ -1,12 +1,10 @@
 #pragma once
 
-#include "Definitions.hpp"
-#include "ResourceDescriptor.hpp"
-
-#include <d3d11_2.h>
+#include "RenderTypes.hpp"
+#include "ResourceSlotTable.hpp"
 
 #include <cstdint>
-#include <unordered_map>
+#include <memory>
 
 class Pipeline
 {
@@ -14,25 +12,29 @@ public:
     friend class PipelineFactory;
     friend class DeviceContext;
 
-    void BindTexture(uint32_t slotIndex, ID3D11ShaderResourceView* texture);
-    void BindSampler(uint32_t slotIndex, ID3D11SamplerState* sampler);
-    void BindVertexStageConstantBuffer(uint32_t slotIndex, ID3D11Buffer* buffer);
+    void BindTexture(uint32_t slotIndex, const std::shared_ptr<RenderShaderResourceView>& texture);
+    void BindSampler(uint32_t slotIndex, const std::shared_ptr<RenderSamplerState>& sampler);
+    void BindVertexStageConstantBuffer(uint32_t slotIndex, const std::shared_ptr<RenderBuffer>& buffer);
+    void BindPixelStageConstantBuffer(uint32_t slotIndex, const std::shared_ptr<RenderBuffer>& buffer);
     void SetViewport(
         float left,
         float top,
         float width,
         float height);
-    void SetDepthStencilState(ID3D11DepthStencilState* depthStencilState);
-    void SetRasterizerState(ID3D11RasterizerState* rasterizerState);
+    void SetDepthStencilState(const std::shared_ptr<RenderDepthStencilState>& depthStencilState);
+    void SetRasterizerState(const std::shared_ptr<RenderRasterizerState>& rasterizerState);
 
 private:
-    WRL::ComPtr<ID3D11VertexShader> _vertexShader = nullptr;
-    WRL::ComPtr<ID3D11PixelShader> _pixelShader = nullptr;
-    WRL::ComPtr<ID3D11InputLayout> _inputLayout = nullptr;
-    WRL::ComPtr<ID3D11DepthStencilState> _depthStencilState = nullptr;
-    WRL::ComPtr<ID3D11RasterizerState> _rasterizerState = nullptr;
-    std::unordered_map<ResourceDescriptor, ID3D11DeviceChild*> _resources;
-    D3D11_PRIMITIVE_TOPOLOGY _primitiveTopology = {};
+    std::shared_ptr<RenderVertexShader> _vertexShader = nullptr;
+    std::shared_ptr<RenderPixelShader> _pixelShader = nullptr;
+    std::shared_ptr<RenderInputLayout> _inputLayout = nullptr;
+    std::shared_ptr<RenderDepthStencilState> _depthStencilState = nullptr;
+    std::shared_ptr<RenderRasterizerState> _rasterizerState = nullptr;
+    SamplerSlotTable _pixelSamplers = {};
+    ShaderResourceSlotTable _pixelShaderResources = {};
+    ConstantBufferSlotTable _vertexConstantBuffers = {};
+    ConstantBufferSlotTable _pixelConstantBuffers = {};
+    RenderPrimitiveTopology _primitiveTopology = RenderPrimitiveTopology::Undefined;
     uint32_t _vertexSize = 0;
-    D3D11_VIEWPORT _viewport = {};
+    RenderViewport _viewport = {};
 };
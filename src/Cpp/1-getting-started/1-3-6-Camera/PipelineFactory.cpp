@@ -1,26 +1,18 @@
 #include "PipelineFactory.hpp"
 #include "Pipeline.hpp"
+#include "RenderBackend.hpp"
 
-#include <d3d11_2.h>
-#include <d3dcompiler.h>
+#include <JobSystem.hpp>
 
+#include <cstddef>
+#include <filesystem>
 #include <iostream>
+#include <map>
+#include <utility>
 
-size_t PipelineFactory::GetLayoutByteSize(const VertexType vertexType)
+PipelineFactory::PipelineFactory(const std::shared_ptr<RenderBackend>& renderBackend)
 {
-    switch (vertexType)
-    {
-    case VertexType::PositionColor:
-        return sizeof(VertexPositionColor);
-    case VertexType::PositionColorUv:
-        return sizeof(VertexPositionColorUv);
-    }
-    return 0;
-}
-
-PipelineFactory::PipelineFactory(const WRL::ComPtr<ID3D11Device>& device)
-{
-    _device = device;
+    _renderBackend = renderBackend;
 
     // clang-format off
     _layoutMap[VertexType::PositionColor] =
@@ -29,20 +21,16 @@ PipelineFactory::PipelineFactory(const WRL::ComPtr<ID3D11Device>& device)
             {
                 "POSITION",
                 0,
-                DXGI_FORMAT::DXGI_FORMAT_R32G32B32_FLOAT,
+                RenderFormat::R32G32B32Float,
                 0,
-                offsetof(VertexPositionColor, position),
-                D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA,
-                0
+                offsetof(VertexPositionColor, position)
             },
             {
                 "COLOR",
                 0,
-                DXGI_FORMAT::DXGI_FORMAT_R32G32B32_FLOAT,
+                RenderFormat::R32G32B32Float,
                 0,
-                offsetof(VertexPositionColor, color),
-                D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA,
-                0
+                offsetof(VertexPositionColor, color)
             },
         }
     };
@@ -53,29 +41,91 @@ PipelineFactory::PipelineFactory(const WRL::ComPtr<ID3D11Device>& device)
             {
                 "POSITION",
                 0,
-                DXGI_FORMAT::DXGI_FORMAT_R32G32B32_FLOAT,
+                RenderFormat::R32G32B32Float,
+                0,
+                offsetof(VertexPositionColorUv, position)
+            },
+            {
+                "COLOR",
+                0,
+                RenderFormat::R32G32B32Float,
+                0,
+                offsetof(VertexPositionColorUv, color)
+            },
+            {
+                "TEXCOORD",
+                0,
+                RenderFormat::R32G32Float,
+                0,
+                offsetof(VertexPositionColorUv, uv)
+            }
+        }
+    };
+
+    _layoutMap[VertexType::QuantizedPositionNormalColorHalfUv] =
+    {
+        {
+            {
+                "POSITION",
+                0,
+                RenderFormat::R16G16B16A16Unorm,
+                0,
+                offsetof(VertexQuantizedPositionNormalColorUv, position)
+            },
+            {
+                "NORMAL",
+                0,
+                RenderFormat::R16G16Snorm,
+                0,
+                offsetof(VertexQuantizedPositionNormalColorUv, normal)
+            },
+            {
+                "COLOR",
+                0,
+                RenderFormat::R8G8B8A8Unorm,
+                0,
+                offsetof(VertexQuantizedPositionNormalColorUv, color)
+            },
+            {
+                "TEXCOORD",
+                0,
+                RenderFormat::R16G16Float,
+                0,
+                offsetof(VertexQuantizedPositionNormalColorUv, uv)
+            }
+        }
+    };
+
+    _layoutMap[VertexType::QuantizedPositionNormalColorUnormUv] =
+    {
+        {
+            {
+                "POSITION",
+                0,
+                RenderFormat::R16G16B16A16Unorm,
+                0,
+                offsetof(VertexQuantizedPositionNormalColorUv, position)
+            },
+            {
+                "NORMAL",
+                0,
+                RenderFormat::R16G16Snorm,
                 0,
-                offsetof(VertexPositionColorUv, position),
-                D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA,
-                0
+                offsetof(VertexQuantizedPositionNormalColorUv, normal)
             },
             {
                 "COLOR",
                 0,
-                DXGI_FORMAT::DXGI_FORMAT_R32G32B32_FLOAT,
+                RenderFormat::R8G8B8A8Unorm,
                 0,
-                offsetof(VertexPositionColorUv, color),
-                D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA,
-                0
+                offsetof(VertexQuantizedPositionNormalColorUv, color)
             },
             {
                 "TEXCOORD",
                 0,
-                DXGI_FORMAT::DXGI_FORMAT_R32G32_FLOAT,
+                RenderFormat::R16G16Unorm,
                 0,
-                offsetof(VertexPositionColorUv, uv),
-                D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA,
-                0
+                offsetof(VertexQuantizedPositionNormalColorUv, uv)
             }
         }
     };
@@ -86,92 +136,125 @@ bool PipelineFactory::CreatePipeline(
     const PipelineDescriptor& settings,
     std::unique_ptr<Pipeline>& pipeline)
 {
-    WRL::ComPtr<ID3DBlob> vertexShaderBlob;
-    pipeline = std::make_unique<Pipeline>();
-    pipeline->_vertexShader = CreateVertexShader(settings.VertexFilePath, vertexShaderBlob);
-    pipeline->_pixelShader = CreatePixelShader(settings.PixelFilePath);
-    if (!CreateInputLayout(settings.VertexType, vertexShaderBlob, pipeline->_inputLayout))
+    std::vector<std::unique_ptr<Pipeline>> pipelines;
+    if (!CreatePipelines({ settings }, pipelines))
     {
         return false;
     }
-    pipeline->_primitiveTopology = D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-    pipeline->_vertexSize = static_cast<uint32_t>(GetLayoutByteSize(settings.VertexType));
+
+    pipeline = std::move(pipelines.front());
     return true;
 }
 
-bool PipelineFactory::CompileShader(
-    const std::wstring& filePath,
-    const std::string& entryPoint,
-    const std::string& profile,
-    WRL::ComPtr<ID3DBlob>& shaderBlob) const
+bool PipelineFactory::CreatePipelines(
+    const std::vector<PipelineDescriptor>& settings,
+    std::vector<std::unique_ptr<Pipeline>>& pipelines)
 {
-    constexpr uint32_t compileFlags = D3DCOMPILE_ENABLE_STRICTNESS;
-
-    WRL::ComPtr<ID3DBlob> tempShaderBlob = nullptr;
-    WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
-    if (FAILED(D3DCompileFromFile(
-            filePath.data(),
-            nullptr,
-            D3D_COMPILE_STANDARD_FILE_INCLUDE,
-            entryPoint.data(),
-            profile.data(),
-            compileFlags,
-            0,
-            &tempShaderBlob,
-            &errorBlob)))
+    // Pipelines tend to share shaders, each file and profile combination is compiled only once
+    std::vector<ShaderStage> shaderStages;
+    std::map<std::pair<std::wstring, std::string>, size_t> shaderStageIndices;
+    const auto addShaderStage = [&](const std::wstring& filePath, const std::string& profile)
     {
-        std::cout << "D3D11: Failed to read shader from file\n";
-        if (errorBlob != nullptr)
+        const auto [shaderStageIndex, isInserted] = shaderStageIndices.try_emplace({ filePath, profile }, shaderStages.size());
+        if (isInserted)
         {
-            std::cout << "D3D11: With message: " << static_cast<const char*>(errorBlob->GetBufferPointer()) << "\n";
+            shaderStages.push_back({ filePath, profile });
         }
+        return shaderStageIndex->second;
+    };
 
+    std::vector<std::pair<size_t, size_t>> pipelineShaderStages;
+    pipelineShaderStages.reserve(settings.size());
+    for (const PipelineDescriptor& descriptor : settings)
+    {
+        pipelineShaderStages.emplace_back(
+            addShaderStage(descriptor.VertexFilePath, "vs_5_0"),
+            addShaderStage(descriptor.PixelFilePath, "ps_5_0"));
+    }
+
+    pipelines.clear();
+    if (!CompileShaderStages(shaderStages))
+    {
         return false;
     }
 
-    shaderBlob = std::move(tempShaderBlob);
+    // Filled separately, so a failing batch leaves no pipelines behind
+    std::vector<std::unique_ptr<Pipeline>> createdPipelines;
+    createdPipelines.reserve(settings.size());
+    for (size_t i = 0; i < settings.size(); i++)
+    {
+        ShaderStage& vertexStage = shaderStages[pipelineShaderStages[i].first];
+        ShaderStage& pixelStage = shaderStages[pipelineShaderStages[i].second];
+        if (vertexStage.VertexShader == nullptr)
+        {
+            vertexStage.VertexShader = CreateVertexShader(vertexStage.ByteCode);
+        }
+        if (pixelStage.PixelShader == nullptr)
+        {
+            pixelStage.PixelShader = CreatePixelShader(pixelStage.ByteCode);
+        }
+
+        std::unique_ptr<Pipeline> pipeline = std::make_unique<Pipeline>();
+        pipeline->_vertexShader = vertexStage.VertexShader;
+        pipeline->_pixelShader = pixelStage.PixelShader;
+        if (vertexStage.VertexShader == nullptr ||
+            pixelStage.PixelShader == nullptr ||
+            !CreateInputLayout(settings[i].VertexType, vertexStage.ByteCode, pipeline->_inputLayout))
+        {
+            std::cout << "PipelineFactory: Failed to create pipeline " << i << " from "
+                      << std::filesystem::path(settings[i].VertexFilePath).u8string() << " and "
+                      << std::filesystem::path(settings[i].PixelFilePath).u8string() << "\n";
+            return false;
+        }
+        pipeline->_primitiveTopology = RenderPrimitiveTopology::TriangleList;
+        pipeline->_vertexSize = static_cast<uint32_t>(GetVertexSize(settings[i].VertexType));
+        createdPipelines.push_back(std::move(pipeline));
+    }
+
+    pipelines = std::move(createdPipelines);
     return true;
 }
 
-WRL::ComPtr<ID3D11VertexShader> PipelineFactory::CreateVertexShader(
-    const std::wstring& filePath,
-    WRL::ComPtr<ID3DBlob>& vertexShaderBlob) const
+bool PipelineFactory::CompileShaderStages(std::vector<ShaderStage>& shaderStages)
 {
-    if (!CompileShader(filePath, "Main", "vs_5_0", vertexShaderBlob))
+    return JobSystem::Get().RunJobs(static_cast<uint32_t>(shaderStages.size()), [&](const uint32_t shaderStageIndex)
     {
-        return nullptr;
-    }
+        ShaderStage& shaderStage = shaderStages[shaderStageIndex];
+        if (!_renderBackend->CompileShader(shaderStage.FilePath, "Main", shaderStage.Profile, shaderStage.ByteCode))
+        {
+            std::cout << "PipelineFactory: Failed to compile " << std::filesystem::path(shaderStage.FilePath).u8string()
+                      << " for " << shaderStage.Profile << "\n";
+            return false;
+        }
+
+        return true;
+    });
+}
 
-    WRL::ComPtr<ID3D11VertexShader> vertexShader;
-    if (FAILED(_device->CreateVertexShader(
-            vertexShaderBlob->GetBufferPointer(),
-            vertexShaderBlob->GetBufferSize(),
-            nullptr,
-            &vertexShader)))
+std::shared_ptr<RenderVertexShader> PipelineFactory::CreateVertexShader(const std::vector<uint8_t>& vertexShaderByteCode) const
+{
+    std::shared_ptr<RenderVertexShader> vertexShader;
+    if (!_renderBackend->CreateVertexShader(
+            vertexShaderByteCode.data(),
+            vertexShaderByteCode.size(),
+            vertexShader))
     {
-        std::cout << "D3D11: Failed to compile vertex shader\n";
+        std::cout << "PipelineFactory: Failed to create vertex shader\n";
         return nullptr;
     }
 
     return vertexShader;
 }
 
-WRL::ComPtr<ID3D11PixelShader> PipelineFactory::CreatePixelShader(const std::wstring& filePath) const
+std::shared_ptr<RenderPixelShader> PipelineFactory::CreatePixelShader(const std::vector<uint8_t>& pixelShaderByteCode) const
 {
-    WRL::ComPtr<ID3DBlob> pixelShaderBlob = nullptr;
-    if (!CompileShader(filePath, "Main", "ps_5_0", pixelShaderBlob))
-    {
-        return nullptr;
-    }
-
-    WRL::ComPtr<ID3D11PixelShader> pixelShader;
-    if (FAILED(_device->CreatePixelShader(
-            pixelShaderBlob->GetBufferPointer(),
-            pixelShaderBlob->GetBufferSize(),
-            nullptr,
-            &pixelShader)))
+    std::shared_ptr<RenderPixelShader> pixelShader;
+    if (!_renderBackend->CreatePixelShader(
+            pixelShaderByteCode.data(),
+            pixelShaderByteCode.size(),
+            pixelShader))
     {
-        std::cout << "D3D11: Failed to compile pixel shader\n";
+        std::cout << "PipelineFactory: Failed to create pixel shader\n";
         return nullptr;
     }
 
@@ -180,18 +263,18 @@ WRL::ComPtr<ID3D11PixelShader> PipelineFactory::CreatePixelShader(const std::wst
 
 bool PipelineFactory::CreateInputLayout(
     const VertexType layoutInfo,
-    const WRL::ComPtr<ID3DBlob>& vertexBlob,
-    WRL::ComPtr<ID3D11InputLayout>& inputLayout)
+    const std::vector<uint8_t>& vertexByteCode,
+    std::shared_ptr<RenderInputLayout>& inputLayout)
 {
-    const std::vector<D3D11_INPUT_ELEMENT_DESC> inputLayoutDesc = _layoutMap[layoutInfo];
-    if (FAILED(_device->CreateInputLayout(
+    const std::vector<RenderInputElement> inputLayoutDesc = _layoutMap[layoutInfo];
+    if (!_renderBackend->CreateInputLayout(
             inputLayoutDesc.data(),
             static_cast<uint32_t>(inputLayoutDesc.size()),
-            vertexBlob->GetBufferPointer(),
-            vertexBlob->GetBufferSize(),
-            &inputLayout)))
+            vertexByteCode.data(),
+            vertexByteCode.size(),
+            inputLayout))
     {
-        std::cout << "D3D11: Failed to create the input layout";
+        std::cout << "PipelineFactory: Failed to create the input layout\n";
         return false;
     }
     return true;
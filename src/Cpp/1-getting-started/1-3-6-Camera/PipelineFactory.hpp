@@ -1,48 +1,59 @@
 #pragma once
 
-#include "Definitions.hpp"
 #include "Pipeline.hpp"
+#include "RenderTypes.hpp"
 #include "VertexType.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+class RenderBackend;
 
 struct PipelineDescriptor
 {
     std::wstring VertexFilePath;
     std::wstring PixelFilePath;
-    VertexType VertexType;
+    ::VertexType VertexType;
 };
 
 class PipelineFactory
 {
 public:
-    PipelineFactory(const WRL::ComPtr<ID3D11Device>& device);
+    PipelineFactory(const std::shared_ptr<RenderBackend>& renderBackend);
 
     bool CreatePipeline(
         const PipelineDescriptor& settings,
         std::unique_ptr<Pipeline>& pipeline);
+    // Compiles every distinct shader of the batch once on the shared JobSystem and creates the
+    // pipelines in the order of their descriptors. It blocks until the batch is done instead of
+    // handing out futures, the application creates its pipelines up front while loading anyway.
+    // Fails without any pipelines when a shader does not compile or a pipeline cannot be created.
+    bool CreatePipelines(
+        const std::vector<PipelineDescriptor>& settings,
+        std::vector<std::unique_ptr<Pipeline>>& pipelines);
 
 private:
-    static size_t GetLayoutByteSize(VertexType vertexType);
-
-    [[nodiscard]] WRL::ComPtr<ID3D11VertexShader> CreateVertexShader(
-        const std::wstring& filePath,
-        WRL::ComPtr<ID3DBlob>& vertexShaderBlob) const;
-    [[nodiscard]] WRL::ComPtr<ID3D11PixelShader> CreatePixelShader(const std::wstring& filePath) const;
+    struct ShaderStage
+    {
+        std::wstring FilePath;
+        std::string Profile;
+        std::vector<uint8_t> ByteCode;
+        std::shared_ptr<RenderVertexShader> VertexShader = nullptr;
+        std::shared_ptr<RenderPixelShader> PixelShader = nullptr;
+    };
+
+    bool CompileShaderStages(std::vector<ShaderStage>& shaderStages);
+    [[nodiscard]] std::shared_ptr<RenderVertexShader> CreateVertexShader(const std::vector<uint8_t>& vertexShaderByteCode) const;
+    [[nodiscard]] std::shared_ptr<RenderPixelShader> CreatePixelShader(const std::vector<uint8_t>& pixelShaderByteCode) const;
 
     bool CreateInputLayout(
         VertexType layoutInfo,
-        const WRL::ComPtr<ID3DBlob>& vertexBlob,
-        WRL::ComPtr<ID3D11InputLayout>& inputLayout);
-
-    bool CompileShader(
-        const std::wstring& filePath,
-        const std::string& entryPoint,
-        const std::string& profile,
-        WRL::ComPtr<ID3DBlob>& shaderBlob) const;
+        const std::vector<uint8_t>& vertexByteCode,
+        std::shared_ptr<RenderInputLayout>& inputLayout);
 
-    WRL::ComPtr<ID3D11Device> _device = nullptr;
-    std::unordered_map<VertexType, std::vector<D3D11_INPUT_ELEMENT_DESC>> _layoutMap;
+    std::shared_ptr<RenderBackend> _renderBackend = nullptr;
+    std::unordered_map<VertexType, std::vector<RenderInputElement>> _layoutMap;
 };
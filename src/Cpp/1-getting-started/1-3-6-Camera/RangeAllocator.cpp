@@ -0,0 +1,124 @@
+#include "RangeAllocator.hpp"
+
+#include <iterator>
+
+void RangeAllocator::Reset(const uint32_t capacity)
+{
+    _capacity = capacity;
+    _freeCount = capacity;
+    _freeRanges.clear();
+    if (capacity > 0)
+    {
+        _freeRanges[0] = capacity;
+    }
+}
+
+bool RangeAllocator::Allocate(
+    const uint32_t count,
+    uint32_t& offset)
+{
+    if (count == 0 || count > _freeCount)
+    {
+        return false;
+    }
+
+    auto bestRange = _freeRanges.end();
+    for (auto range = _freeRanges.begin(); range != _freeRanges.end(); ++range)
+    {
+        if (range->second >= count && (bestRange == _freeRanges.end() || range->second < bestRange->second))
+        {
+            bestRange = range;
+            if (range->second == count)
+            {
+                break;
+            }
+        }
+    }
+
+    if (bestRange == _freeRanges.end())
+    {
+        return false;
+    }
+
+    offset = bestRange->first;
+    const uint32_t remainingCount = bestRange->second - count;
+    _freeRanges.erase(bestRange);
+    if (remainingCount > 0)
+    {
+        _freeRanges[offset + count] = remainingCount;
+    }
+
+    _freeCount -= count;
+    return true;
+}
+
+void RangeAllocator::Free(
+    const uint32_t offset,
+    const uint32_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    uint32_t freeOffset = offset;
+    uint32_t freeCount = count;
+
+    auto next = _freeRanges.lower_bound(offset);
+    if (next != _freeRanges.end() && next->first == offset + count)
+    {
+        freeCount += next->second;
+        next = _freeRanges.erase(next);
+    }
+
+    if (next != _freeRanges.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset)
+        {
+            freeOffset = previous->first;
+            freeCount += previous->second;
+            _freeRanges.erase(previous);
+        }
+    }
+
+    _freeRanges[freeOffset] = freeCount;
+    _freeCount += count;
+}
+
+uint32_t RangeAllocator::GetCapacity() const
+{
+    return _capacity;
+}
+
+uint32_t RangeAllocator::GetFreeCount() const
+{
+    return _freeCount;
+}
+
+uint32_t RangeAllocator::GetLargestFreeRange() const
+{
+    uint32_t largestFreeRange = 0;
+    for (const auto& [offset, count] : _freeRanges)
+    {
+        largestFreeRange = count > largestFreeRange ? count : largestFreeRange;
+    }
+
+    return largestFreeRange;
+}
+
+uint32_t RangeAllocator::GetFreeRangeCount() const
+{
+    return static_cast<uint32_t>(_freeRanges.size());
+}
+
+bool RangeAllocator::IsPacked() const
+{
+    if (_freeRanges.empty())
+    {
+        return true;
+    }
+
+    const auto& [offset, count] = *_freeRanges.begin();
+    return _freeRanges.size() == 1 && offset + count == _capacity;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+// Hands out ranges of [0, capacity) with a best fit search over a free list ordered by offset.
+// Freed ranges are merged with their free neighbours, so the list only holds the gaps between allocations.
+class RangeAllocator
+{
+public:
+    void Reset(uint32_t capacity);
+
+    [[nodiscard]] bool Allocate(
+        uint32_t count,
+        uint32_t& offset);
+    void Free(
+        uint32_t offset,
+        uint32_t count);
+
+    [[nodiscard]] uint32_t GetCapacity() const;
+    [[nodiscard]] uint32_t GetFreeCount() const;
+    [[nodiscard]] uint32_t GetLargestFreeRange() const;
+    [[nodiscard]] uint32_t GetFreeRangeCount() const;
+    // True when the allocated ranges are contiguous from offset 0, so all free space is at the end
+    [[nodiscard]] bool IsPacked() const;
+
+private:
+    uint32_t _capacity = 0;
+    uint32_t _freeCount = 0;
+    std::map<uint32_t, uint32_t> _freeRanges;
+};
@@ -0,0 +1,152 @@
+#include "RectanglePacker.hpp"
+
+RectanglePacker::RectanglePacker(
+    const uint32_t width,
+    const uint32_t height)
+{
+    _width = width;
+    _height = height;
+    _freeRectangles.push_back(Rectangle{ 0, 0, width, height });
+}
+
+bool RectanglePacker::Insert(
+    const uint32_t width,
+    const uint32_t height,
+    uint32_t& x,
+    uint32_t& y)
+{
+    if (width == 0 || height == 0)
+    {
+        return false;
+    }
+
+    // Best short side fit, ties go to the rectangle leaving the shorter long side
+    size_t bestIndex = _freeRectangles.size();
+    uint32_t bestShortSide = ~0u;
+    uint32_t bestLongSide = ~0u;
+    for (size_t i = 0; i < _freeRectangles.size(); i++)
+    {
+        const Rectangle& freeRectangle = _freeRectangles[i];
+        if (freeRectangle.Width < width || freeRectangle.Height < height)
+        {
+            continue;
+        }
+
+        const uint32_t leftoverWidth = freeRectangle.Width - width;
+        const uint32_t leftoverHeight = freeRectangle.Height - height;
+        const uint32_t shortSide = leftoverWidth < leftoverHeight ? leftoverWidth : leftoverHeight;
+        const uint32_t longSide = leftoverWidth < leftoverHeight ? leftoverHeight : leftoverWidth;
+        if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+        {
+            bestIndex = i;
+            bestShortSide = shortSide;
+            bestLongSide = longSide;
+        }
+    }
+
+    if (bestIndex == _freeRectangles.size())
+    {
+        return false;
+    }
+
+    const Rectangle usedRectangle{ _freeRectangles[bestIndex].X, _freeRectangles[bestIndex].Y, width, height };
+    SplitFreeRectangles(usedRectangle);
+    PruneFreeRectangles();
+
+    x = usedRectangle.X;
+    y = usedRectangle.Y;
+    _usedArea += static_cast<uint64_t>(width) * height;
+    return true;
+}
+
+uint32_t RectanglePacker::GetWidth() const
+{
+    return _width;
+}
+
+uint32_t RectanglePacker::GetHeight() const
+{
+    return _height;
+}
+
+float RectanglePacker::GetOccupancy() const
+{
+    const uint64_t area = static_cast<uint64_t>(_width) * _height;
+    return area > 0 ? static_cast<float>(_usedArea) / static_cast<float>(area) : 0.0f;
+}
+
+// Every free rectangle overlapping the used one is replaced by up to four maximal rectangles
+// of what remains of it on each side
+void RectanglePacker::SplitFreeRectangles(const Rectangle& usedRectangle)
+{
+    const uint32_t usedRight = usedRectangle.X + usedRectangle.Width;
+    const uint32_t usedBottom = usedRectangle.Y + usedRectangle.Height;
+
+    std::vector<Rectangle> splitRectangles;
+    for (size_t i = 0; i < _freeRectangles.size();)
+    {
+        const Rectangle freeRectangle = _freeRectangles[i];
+        const uint32_t freeRight = freeRectangle.X + freeRectangle.Width;
+        const uint32_t freeBottom = freeRectangle.Y + freeRectangle.Height;
+        if (usedRectangle.X >= freeRight || usedRight <= freeRectangle.X ||
+            usedRectangle.Y >= freeBottom || usedBottom <= freeRectangle.Y)
+        {
+            i++;
+            continue;
+        }
+
+        if (usedRectangle.X > freeRectangle.X)
+        {
+            splitRectangles.push_back(Rectangle{ freeRectangle.X, freeRectangle.Y, usedRectangle.X - freeRectangle.X, freeRectangle.Height });
+        }
+        if (usedRight < freeRight)
+        {
+            splitRectangles.push_back(Rectangle{ usedRight, freeRectangle.Y, freeRight - usedRight, freeRectangle.Height });
+        }
+        if (usedRectangle.Y > freeRectangle.Y)
+        {
+            splitRectangles.push_back(Rectangle{ freeRectangle.X, freeRectangle.Y, freeRectangle.Width, usedRectangle.Y - freeRectangle.Y });
+        }
+        if (usedBottom < freeBottom)
+        {
+            splitRectangles.push_back(Rectangle{ freeRectangle.X, usedBottom, freeRectangle.Width, freeBottom - usedBottom });
+        }
+
+        _freeRectangles[i] = _freeRectangles.back();
+        _freeRectangles.pop_back();
+    }
+
+    _freeRectangles.insert(_freeRectangles.end(), splitRectangles.begin(), splitRectangles.end());
+}
+
+void RectanglePacker::PruneFreeRectangles()
+{
+    const auto contains = [](const Rectangle& outer, const Rectangle& inner)
+    {
+        return inner.X >= outer.X &&
+               inner.Y >= outer.Y &&
+               inner.X + inner.Width <= outer.X + outer.Width &&
+               inner.Y + inner.Height <= outer.Y + outer.Height;
+    };
+
+    for (size_t i = 0; i < _freeRectangles.size(); i++)
+    {
+        for (size_t j = i + 1; j < _freeRectangles.size();)
+        {
+            if (contains(_freeRectangles[j], _freeRectangles[i]))
+            {
+                _freeRectangles.erase(_freeRectangles.begin() + i);
+                i--;
+                break;
+            }
+
+            if (contains(_freeRectangles[i], _freeRectangles[j]))
+            {
+                _freeRectangles.erase(_freeRectangles.begin() + j);
+                continue;
+            }
+
+            j++;
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Packs rectangles into a width x height area with the MaxRects algorithm. The free space is kept
+// as a list of maximal, possibly overlapping free rectangles. A new rectangle goes into the free
+// rectangle it leaves the shortest side over in, which is then split around it and pruned of
+// free rectangles contained in others. Rectangles are never rotated or freed again.
+class RectanglePacker
+{
+public:
+    RectanglePacker(
+        uint32_t width,
+        uint32_t height);
+
+    [[nodiscard]] bool Insert(
+        uint32_t width,
+        uint32_t height,
+        uint32_t& x,
+        uint32_t& y);
+
+    [[nodiscard]] uint32_t GetWidth() const;
+    [[nodiscard]] uint32_t GetHeight() const;
+    // The fraction of the area covered by inserted rectangles
+    [[nodiscard]] float GetOccupancy() const;
+
+private:
+    struct Rectangle
+    {
+        uint32_t X = 0;
+        uint32_t Y = 0;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+    };
+
+    void SplitFreeRectangles(const Rectangle& usedRectangle);
+    void PruneFreeRectangles();
+
+    uint32_t _width = 0;
+    uint32_t _height = 0;
+    uint64_t _usedArea = 0;
+    std::vector<Rectangle> _freeRectangles;
+};
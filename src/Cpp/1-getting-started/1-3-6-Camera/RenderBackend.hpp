@@ -0,0 +1,159 @@
+#pragma once
+
+#include "RenderTypes.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Everything DeviceContext, Pipeline and the factories need from a graphics device, in
+// backend neutral types so no D3D11 or Win32 header leaks into the code using it. The
+// context calls keep the names of the D3D11 calls they map to, D3D11RenderBackend is a
+// thin translation onto those and NullRenderBackend records them without a GPU or a window.
+// Objects are passed in as raw pointers and not retained, whoever binds them keeps them
+// alive for as long as they are bound, like DeviceContext does.
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual bool CreateBuffer(
+        const RenderBufferDescription& description,
+        const void* initialData,
+        std::shared_ptr<RenderBuffer>& buffer) = 0;
+    // initialData holds one entry per subresource when given
+    virtual bool CreateTexture2D(
+        const RenderTextureDescription& description,
+        const RenderSubresourceData* initialData,
+        std::shared_ptr<RenderTexture2D>& texture) = 0;
+    virtual bool CreateShaderResourceView(
+        RenderTexture2D* texture,
+        const RenderShaderResourceViewDescription& description,
+        std::shared_ptr<RenderShaderResourceView>& shaderResourceView) = 0;
+    virtual bool CreateSamplerState(
+        const RenderSamplerDescription& description,
+        std::shared_ptr<RenderSamplerState>& samplerState) = 0;
+    virtual bool CreateDepthStencilState(
+        const RenderDepthStencilDescription& description,
+        std::shared_ptr<RenderDepthStencilState>& depthStencilState) = 0;
+    virtual bool CreateRasterizerState(
+        const RenderRasterizerDescription& description,
+        std::shared_ptr<RenderRasterizerState>& rasterizerState) = 0;
+    virtual bool CreateVertexShader(
+        const void* byteCode,
+        size_t byteCodeSize,
+        std::shared_ptr<RenderVertexShader>& vertexShader) = 0;
+    virtual bool CreatePixelShader(
+        const void* byteCode,
+        size_t byteCodeSize,
+        std::shared_ptr<RenderPixelShader>& pixelShader) = 0;
+    virtual bool CreateInputLayout(
+        const RenderInputElement* elements,
+        uint32_t elementCount,
+        const void* byteCode,
+        size_t byteCodeSize,
+        std::shared_ptr<RenderInputLayout>& inputLayout) = 0;
+
+    // Called from several threads at once by PipelineFactory
+    virtual bool CompileShader(
+        const std::wstring& filePath,
+        const std::string& entryPoint,
+        const std::string& profile,
+        std::vector<uint8_t>& byteCode) = 0;
+    virtual void PrintShaderStatistics() const = 0;
+
+    virtual void ClearRenderTargetView(
+        RenderTargetView* renderTarget,
+        const float clearColor[4]) = 0;
+    virtual void ClearDepthStencilView(
+        RenderDepthStencilView* depthStencilView,
+        uint32_t clearFlags,
+        float clearDepth,
+        uint8_t clearStencil) = 0;
+    virtual void OMSetRenderTargets(
+        uint32_t renderTargetCount,
+        RenderTargetView* const* renderTargets,
+        RenderDepthStencilView* depthStencilView) = 0;
+    virtual void IASetInputLayout(RenderInputLayout* inputLayout) = 0;
+    virtual void IASetPrimitiveTopology(RenderPrimitiveTopology primitiveTopology) = 0;
+    virtual void IASetVertexBuffers(
+        uint32_t startSlot,
+        uint32_t bufferCount,
+        RenderBuffer* const* vertexBuffers,
+        const uint32_t* strides,
+        const uint32_t* offsets) = 0;
+    virtual void IASetIndexBuffer(
+        RenderBuffer* indexBuffer,
+        RenderFormat format,
+        uint32_t offset) = 0;
+    virtual void VSSetShader(RenderVertexShader* vertexShader) = 0;
+    virtual void PSSetShader(RenderPixelShader* pixelShader) = 0;
+    virtual void VSSetConstantBuffers(
+        uint32_t startSlot,
+        uint32_t bufferCount,
+        RenderBuffer* const* constantBuffers) = 0;
+    virtual void PSSetConstantBuffers(
+        uint32_t startSlot,
+        uint32_t bufferCount,
+        RenderBuffer* const* constantBuffers) = 0;
+    virtual void PSSetShaderResources(
+        uint32_t startSlot,
+        uint32_t viewCount,
+        RenderShaderResourceView* const* shaderResourceViews) = 0;
+    virtual void PSSetSamplers(
+        uint32_t startSlot,
+        uint32_t samplerCount,
+        RenderSamplerState* const* samplers) = 0;
+    virtual void OMSetDepthStencilState(
+        RenderDepthStencilState* depthStencilState,
+        uint32_t stencilReference) = 0;
+    virtual void RSSetViewports(
+        uint32_t viewportCount,
+        const RenderViewport* viewports) = 0;
+    virtual void RSSetState(RenderRasterizerState* rasterizerState) = 0;
+    virtual void UpdateSubresource(
+        RenderResource* resource,
+        uint32_t subresource,
+        const RenderBox* box,
+        const void* data,
+        uint32_t rowPitch,
+        uint32_t depthPitch) = 0;
+    virtual void CopySubresourceRegion(
+        RenderResource* destinationResource,
+        uint32_t destinationSubresource,
+        uint32_t destinationX,
+        uint32_t destinationY,
+        uint32_t destinationZ,
+        RenderResource* sourceResource,
+        uint32_t sourceSubresource,
+        const RenderBox* sourceBox) = 0;
+    virtual bool Map(
+        RenderResource* resource,
+        uint32_t subresource,
+        RenderMapType mapType,
+        RenderMappedSubresource* mappedSubresource) = 0;
+    virtual void Unmap(
+        RenderResource* resource,
+        uint32_t subresource) = 0;
+    virtual void Draw(
+        uint32_t vertexCount,
+        uint32_t startVertex) = 0;
+    virtual void DrawIndexed(
+        uint32_t indexCount,
+        uint32_t startIndex,
+        int32_t baseVertex) = 0;
+    virtual void Flush() = 0;
+
+    // The window's back buffer and its depth buffer, both null without a window
+    [[nodiscard]] virtual RenderTargetView* GetBackBufferRenderTarget() const = 0;
+    [[nodiscard]] virtual RenderDepthStencilView* GetBackBufferDepthStencil() const = 0;
+    virtual bool ResizeBackBuffer(
+        uint32_t width,
+        uint32_t height) = 0;
+    virtual void Present() = 0;
+
+    // Wraps the ImGui frame, ImGui's own platform backend is set up by the application
+    virtual void NewUiFrame() = 0;
+    virtual void RenderUiDrawData() = 0;
+};
@@ -0,0 +1,389 @@
+#pragma once
+
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Formats keep the values of their DXGI_FORMAT counterparts, so formats read from DDS files
+// and cooked models are converted with a cast. Only the ones this sample names are listed,
+// every other DXGI value passes through as it is.
+enum class RenderFormat : uint32_t
+{
+    Unknown = 0,
+    R32G32B32A32Float = 2,
+    R32G32B32Float = 6,
+    R16G16B16A16Float = 10,
+    R16G16B16A16Unorm = 11,
+    R32G32Float = 16,
+    R8G8B8A8Unorm = 28,
+    R8G8B8A8UnormSrgb = 29,
+    R16G16Float = 34,
+    R16G16Unorm = 35,
+    R16G16Snorm = 37,
+    D32Float = 40,
+    R32Uint = 42,
+    D24UnormS8Uint = 45,
+    R16Uint = 57,
+    Bc1Typeless = 70,
+    Bc1Unorm = 71,
+    Bc2Unorm = 74,
+    Bc3Unorm = 77,
+    Bc4Unorm = 80,
+    Bc5Unorm = 83,
+    Bc5Snorm = 84,
+    B8G8R8A8Unorm = 87,
+    Bc6hTypeless = 94,
+    Bc6hUf16 = 95,
+    Bc7Unorm = 98,
+    Bc7UnormSrgb = 99
+};
+
+inline bool IsBlockCompressed(const RenderFormat format)
+{
+    return (format >= RenderFormat::Bc1Typeless && format <= RenderFormat::Bc5Snorm) ||
+           (format >= RenderFormat::Bc6hTypeless && format <= RenderFormat::Bc7UnormSrgb);
+}
+
+inline uint32_t GetIndexSize(const RenderFormat indexFormat)
+{
+    return indexFormat == RenderFormat::R16Uint
+             ? sizeof(uint16_t)
+             : sizeof(uint32_t);
+}
+
+// Dynamic resources are written by the CPU with Map, nothing else is mapped
+enum class RenderUsage
+{
+    Default,
+    Immutable,
+    Dynamic
+};
+
+enum RenderBindFlags : uint32_t
+{
+    RenderBindNone = 0,
+    RenderBindVertexBuffer = 1 << 0,
+    RenderBindIndexBuffer = 1 << 1,
+    RenderBindConstantBuffer = 1 << 2,
+    RenderBindShaderResource = 1 << 3,
+    RenderBindRenderTarget = 1 << 4,
+    RenderBindDepthStencil = 1 << 5
+};
+
+enum RenderClearFlags : uint32_t
+{
+    RenderClearNone = 0,
+    RenderClearDepth = 1 << 0,
+    RenderClearStencil = 1 << 1
+};
+
+enum class RenderMapType
+{
+    WriteDiscard,
+    WriteNoOverwrite
+};
+
+enum class RenderPrimitiveTopology
+{
+    Undefined,
+    PointList,
+    LineList,
+    LineStrip,
+    TriangleList,
+    TriangleStrip
+};
+
+enum class RenderFilter
+{
+    MinMagMipPoint,
+    MinMagLinearMipPoint,
+    MinMagMipLinear,
+    Anisotropic
+};
+
+enum class RenderTextureAddressMode
+{
+    Wrap,
+    Mirror,
+    Clamp
+};
+
+enum class RenderComparisonFunction
+{
+    Never,
+    Less,
+    Equal,
+    LessEqual,
+    Greater,
+    NotEqual,
+    GreaterEqual,
+    Always
+};
+
+enum class RenderFillMode
+{
+    Solid,
+    Wireframe
+};
+
+enum class RenderCullMode
+{
+    None,
+    Front,
+    Back
+};
+
+enum class RenderResourceDimension
+{
+    Buffer,
+    Texture2D
+};
+
+enum class RenderShaderResourceViewDimension
+{
+    Texture2D,
+    Texture2DArray,
+    TextureCube
+};
+
+// The limits of D3D11, which every backend is held to
+constexpr uint32_t RenderVertexBufferSlotCount = 32;
+constexpr uint32_t RenderConstantBufferSlotCount = 14;
+constexpr uint32_t RenderShaderResourceSlotCount = 128;
+constexpr uint32_t RenderSamplerSlotCount = 16;
+constexpr uint32_t RenderMaxMipLevels = 15;
+constexpr uint32_t RenderMaxTextureDimension = 16384;
+constexpr uint32_t RenderMaxTextureArraySize = 2048;
+constexpr uint64_t RenderMaxResourceSize = 128ull * 1024ull * 1024ull;
+
+// The number of levels of a full mip chain down to 1x1
+inline uint32_t GetFullMipLevelCount(
+    const uint32_t width,
+    const uint32_t height)
+{
+    const uint32_t size = width > height ? width : height;
+    uint32_t mipLevels = 1;
+    while ((size >> mipLevels) > 0)
+    {
+        mipLevels++;
+    }
+    return mipLevels;
+}
+
+struct RenderBufferDescription
+{
+    uint32_t Size = 0;
+    RenderUsage Usage = RenderUsage::Default;
+    uint32_t BindFlags = RenderBindFlags::RenderBindNone;
+};
+
+// MipLevels 0 is the full chain down to 1x1
+struct RenderTextureDescription
+{
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t MipLevels = 1;
+    uint32_t ArraySize = 1;
+    RenderFormat Format = RenderFormat::Unknown;
+    RenderUsage Usage = RenderUsage::Default;
+    uint32_t BindFlags = RenderBindFlags::RenderBindNone;
+    bool IsCubemap = false;
+};
+
+// One per subresource, items follow each other with their full mip chains
+struct RenderSubresourceData
+{
+    const void* Data = nullptr;
+    uint32_t RowPitch = 0;
+    uint32_t SlicePitch = 0;
+};
+
+struct RenderShaderResourceViewDescription
+{
+    RenderFormat Format = RenderFormat::Unknown;
+    RenderShaderResourceViewDimension Dimension = RenderShaderResourceViewDimension::Texture2D;
+    uint32_t MostDetailedMip = 0;
+    uint32_t MipLevels = 1;
+    uint32_t FirstArraySlice = 0;
+    uint32_t ArraySize = 1;
+};
+
+struct RenderSamplerDescription
+{
+    RenderFilter Filter = RenderFilter::MinMagMipLinear;
+    RenderTextureAddressMode AddressU = RenderTextureAddressMode::Clamp;
+    RenderTextureAddressMode AddressV = RenderTextureAddressMode::Clamp;
+    RenderTextureAddressMode AddressW = RenderTextureAddressMode::Clamp;
+    uint32_t MaxAnisotropy = 1;
+    float MinLod = 0.0f;
+    float MaxLod = FLT_MAX;
+};
+
+struct RenderDepthStencilDescription
+{
+    bool IsDepthEnabled = true;
+    bool IsDepthWriteEnabled = true;
+    RenderComparisonFunction DepthFunction = RenderComparisonFunction::Less;
+};
+
+struct RenderRasterizerDescription
+{
+    RenderFillMode FillMode = RenderFillMode::Solid;
+    RenderCullMode CullMode = RenderCullMode::Back;
+    bool IsFrontCounterClockwise = false;
+    bool IsDepthClipEnabled = true;
+};
+
+// Per vertex data only, AlignedByteOffset is the element's offset within the vertex
+struct RenderInputElement
+{
+    const char* SemanticName = nullptr;
+    uint32_t SemanticIndex = 0;
+    RenderFormat Format = RenderFormat::Unknown;
+    uint32_t InputSlot = 0;
+    uint32_t AlignedByteOffset = 0;
+};
+
+struct RenderViewport
+{
+    float Left = 0.0f;
+    float Top = 0.0f;
+    float Width = 0.0f;
+    float Height = 0.0f;
+    float MinDepth = 0.0f;
+    float MaxDepth = 1.0f;
+};
+
+// In bytes for buffers, where only Left and Right are used, and in texels for textures
+struct RenderBox
+{
+    uint32_t Left = 0;
+    uint32_t Top = 0;
+    uint32_t Front = 0;
+    uint32_t Right = 0;
+    uint32_t Bottom = 1;
+    uint32_t Back = 1;
+};
+
+struct RenderMappedSubresource
+{
+    void* Data = nullptr;
+    uint32_t RowPitch = 0;
+    uint32_t DepthPitch = 0;
+};
+
+// Everything a RenderBackend creates. The descriptions are kept, so callers and backends can
+// look at what an object was created with without asking the device. Backends derive from
+// these to attach their native objects.
+class RenderObject
+{
+public:
+    virtual ~RenderObject() = default;
+
+    virtual void SetDebugName(const std::string& debugName);
+    [[nodiscard]] const std::string& GetDebugName() const;
+
+private:
+    std::string _debugName;
+};
+
+inline void RenderObject::SetDebugName(const std::string& debugName)
+{
+    _debugName = debugName;
+}
+
+inline const std::string& RenderObject::GetDebugName() const
+{
+    return _debugName;
+}
+
+class RenderResource : public RenderObject
+{
+public:
+    [[nodiscard]] virtual RenderResourceDimension GetDimension() const = 0;
+};
+
+template <typename TDescription>
+class RenderDescribedObject
+{
+public:
+    explicit RenderDescribedObject(const TDescription& description)
+        : _description(description)
+    {
+    }
+
+    [[nodiscard]] const TDescription& GetDescription() const
+    {
+        return _description;
+    }
+
+private:
+    TDescription _description;
+};
+
+class RenderBuffer : public RenderResource, public RenderDescribedObject<RenderBufferDescription>
+{
+public:
+    using RenderDescribedObject::RenderDescribedObject;
+
+    [[nodiscard]] RenderResourceDimension GetDimension() const override
+    {
+        return RenderResourceDimension::Buffer;
+    }
+};
+
+class RenderTexture2D : public RenderResource, public RenderDescribedObject<RenderTextureDescription>
+{
+public:
+    using RenderDescribedObject::RenderDescribedObject;
+
+    [[nodiscard]] RenderResourceDimension GetDimension() const override
+    {
+        return RenderResourceDimension::Texture2D;
+    }
+};
+
+class RenderShaderResourceView : public RenderObject, public RenderDescribedObject<RenderShaderResourceViewDescription>
+{
+public:
+    using RenderDescribedObject::RenderDescribedObject;
+};
+
+class RenderSamplerState : public RenderObject, public RenderDescribedObject<RenderSamplerDescription>
+{
+public:
+    using RenderDescribedObject::RenderDescribedObject;
+};
+
+class RenderDepthStencilState : public RenderObject, public RenderDescribedObject<RenderDepthStencilDescription>
+{
+public:
+    using RenderDescribedObject::RenderDescribedObject;
+};
+
+class RenderRasterizerState : public RenderObject, public RenderDescribedObject<RenderRasterizerDescription>
+{
+public:
+    using RenderDescribedObject::RenderDescribedObject;
+};
+
+class RenderVertexShader : public RenderObject
+{
+};
+
+class RenderPixelShader : public RenderObject
+{
+};
+
+class RenderInputLayout : public RenderObject
+{
+};
+
+class RenderTargetView : public RenderObject
+{
+};
+
+class RenderDepthStencilView : public RenderObject
+{
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "RenderTypes.hpp"
+
+#if __has_include(<bit>)
+#include <bit>
+#endif
+#if defined(_MSC_VER) && !defined(__cpp_lib_bitops)
+#include <intrin.h>
+#endif
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+// One entry per API slot of a single shader stage, plus a bit mask of the slots in use.
+// Pipeline fills these, DeviceContext keeps the same tables as its view of what is bound
+// and walks the masks to find the slots which differ. References keep what is bound alive,
+// Resources holds the same pointers contiguously, the way the backend takes them.
+template <typename TResource, uint32_t SlotCount>
+struct ResourceSlotTable
+{
+    static constexpr uint32_t MaskWordCount = (SlotCount + 63) / 64;
+
+    std::array<std::shared_ptr<TResource>, SlotCount> References = {};
+    std::array<TResource*, SlotCount> Resources = {};
+    std::array<uint64_t, MaskWordCount> UsedSlotMask = {};
+
+    void Set(const uint32_t slotIndex, const std::shared_ptr<TResource>& resource)
+    {
+        assert(slotIndex < SlotCount);
+        References[slotIndex] = resource;
+        Resources[slotIndex] = resource.get();
+
+        const uint64_t slotBit = uint64_t(1) << (slotIndex % 64);
+        if (resource != nullptr)
+        {
+            UsedSlotMask[slotIndex / 64] |= slotBit;
+        }
+        else
+        {
+            UsedSlotMask[slotIndex / 64] &= ~slotBit;
+        }
+    }
+};
+
+// mask must not be 0
+inline uint32_t FindFirstSetBit(const uint64_t mask)
+{
+#if defined(__cpp_lib_bitops)
+    return static_cast<uint32_t>(std::countr_zero(mask));
+#elif defined(_MSC_VER)
+    unsigned long bitIndex = 0;
+    _BitScanForward64(&bitIndex, mask);
+    return static_cast<uint32_t>(bitIndex);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(mask));
+#endif
+}
+
+using SamplerSlotTable = ResourceSlotTable<RenderSamplerState, RenderSamplerSlotCount>;
+using ShaderResourceSlotTable = ResourceSlotTable<RenderShaderResourceView, RenderShaderResourceSlotCount>;
+using ConstantBufferSlotTable = ResourceSlotTable<RenderBuffer, RenderConstantBufferSlotCount>;
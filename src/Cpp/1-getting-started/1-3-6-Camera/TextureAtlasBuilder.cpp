@@ -0,0 +1,390 @@
+#include "TextureAtlasBuilder.hpp"
+#include "RectanglePacker.hpp"
+
+#include <FreeImage.h>
+
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
+#include <iostream>
+#include <numeric>
+
+namespace
+{
+constexpr DXGI_FORMAT AtlasFormat = DXGI_FORMAT::DXGI_FORMAT_B8G8R8A8_UNORM;
+
+uint32_t AlignUp(
+    const uint32_t value,
+    const uint32_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Only the top level is kept, the atlas generates its own mips
+bool LoadDdsImage(
+    const std::filesystem::path& filePath,
+    DirectX::ScratchImage& image)
+{
+    DirectX::ScratchImage ddsImage;
+    DirectX::TexMetadata metaData = {};
+    if (FAILED(DirectX::LoadFromDDSFile(filePath.wstring().c_str(), DirectX::DDS_FLAGS_NONE, &metaData, ddsImage)) ||
+        metaData.dimension != DirectX::TEX_DIMENSION::TEX_DIMENSION_TEXTURE2D)
+    {
+        return false;
+    }
+
+    const DirectX::Image& topLevel = *ddsImage.GetImage(0, 0, 0);
+    if (DirectX::IsCompressed(metaData.format))
+    {
+        return SUCCEEDED(DirectX::Decompress(topLevel, AtlasFormat, image));
+    }
+
+    if (metaData.format == AtlasFormat)
+    {
+        return SUCCEEDED(image.InitializeFromImage(topLevel));
+    }
+
+    return SUCCEEDED(DirectX::Convert(topLevel, AtlasFormat, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, image));
+}
+
+// 32 bit FreeImage bitmaps are stored bottom up in BGRA order, so only the rows are flipped
+bool LoadFreeImageImage(
+    const std::filesystem::path& filePath,
+    DirectX::ScratchImage& image)
+{
+    FREE_IMAGE_FORMAT imageFormat = FreeImage_GetFileTypeU(filePath.wstring().c_str());
+    if (imageFormat == FIF_UNKNOWN)
+    {
+        imageFormat = FreeImage_GetFIFFromFilenameU(filePath.wstring().c_str());
+    }
+
+    if (imageFormat == FIF_UNKNOWN)
+    {
+        return false;
+    }
+
+    FIBITMAP* loadedImage = FreeImage_LoadU(imageFormat, filePath.wstring().c_str());
+    if (loadedImage == nullptr)
+    {
+        return false;
+    }
+
+    FIBITMAP* convertedImage = FreeImage_ConvertTo32Bits(loadedImage);
+    FreeImage_Unload(loadedImage);
+    if (convertedImage == nullptr)
+    {
+        return false;
+    }
+
+    const uint32_t width = FreeImage_GetWidth(convertedImage);
+    const uint32_t height = FreeImage_GetHeight(convertedImage);
+    if (FAILED(image.Initialize2D(AtlasFormat, width, height, 1, 1)))
+    {
+        FreeImage_Unload(convertedImage);
+        return false;
+    }
+
+    const DirectX::Image& destination = *image.GetImage(0, 0, 0);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        std::memcpy(destination.pixels + destination.rowPitch * y, FreeImage_GetScanLine(convertedImage, height - 1 - y), sizeof(uint32_t) * width);
+    }
+
+    FreeImage_Unload(convertedImage);
+    return true;
+}
+
+std::wstring GetPathKey(const std::filesystem::path& filePath)
+{
+    std::wstring key = filePath.lexically_normal().wstring();
+    std::transform(key.begin(), key.end(), key.begin(), [](const wchar_t character)
+                   { return static_cast<wchar_t>(std::towlower(character)); });
+    return key;
+}
+} // namespace
+
+TextureAtlasBuilder::TextureAtlasBuilder(const TextureAtlasSettings& settings)
+{
+    _settings = settings;
+    _settings.MipLevels = _settings.MipLevels < 1 ? 1 : _settings.MipLevels;
+    const uint32_t minimumPadding = _settings.MipLevels > 1 ? 1u << (_settings.MipLevels - 2) : 0;
+    _settings.Padding = _settings.Padding < minimumPadding ? minimumPadding : _settings.Padding;
+}
+
+uint32_t TextureAtlasBuilder::AddTexture(const std::filesystem::path& filePath)
+{
+    const std::wstring pathKey = GetPathKey(filePath);
+    const auto existingRegion = _regionsByPath.find(pathKey);
+    if (existingRegion != _regionsByPath.end())
+    {
+        return existingRegion->second;
+    }
+
+    AtlasEntry entry = {};
+    std::wstring extension = filePath.extension().wstring();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](const wchar_t character)
+                   { return static_cast<wchar_t>(std::towlower(character)); });
+    const bool isLoaded = extension == L".dds"
+                            ? LoadDdsImage(filePath, entry.Image)
+                            : LoadFreeImageImage(filePath, entry.Image);
+    if (!isLoaded)
+    {
+        return InvalidAtlasRegion;
+    }
+
+    const uint32_t region = static_cast<uint32_t>(_entries.size());
+    _entries.push_back(std::move(entry));
+    _regions.emplace_back();
+    _regionsByPath[pathKey] = region;
+    return region;
+}
+
+uint32_t TextureAtlasBuilder::AddSolidColor(const uint32_t color)
+{
+    const auto existingRegion = _regionsByColor.find(color);
+    if (existingRegion != _regionsByColor.end())
+    {
+        return existingRegion->second;
+    }
+
+    AtlasEntry entry = {};
+    if (FAILED(entry.Image.Initialize2D(AtlasFormat, 1, 1, 1, 1)))
+    {
+        return InvalidAtlasRegion;
+    }
+    std::memcpy(entry.Image.GetPixels(), &color, sizeof(color));
+
+    const uint32_t region = static_cast<uint32_t>(_entries.size());
+    _entries.push_back(std::move(entry));
+    _regions.emplace_back();
+    _regionsByColor[color] = region;
+    return region;
+}
+
+bool TextureAtlasBuilder::Build()
+{
+    if (_entries.empty())
+    {
+        std::cout << "TextureAtlasBuilder: No textures to pack\n";
+        return false;
+    }
+
+    // Every entry takes up a whole cell, its image with the gutters around it rounded up to the alignment
+    const uint32_t alignment = 1u << (_settings.MipLevels - 1);
+    const uint32_t padding = _settings.Padding;
+    const auto getCellWidth = [&](const AtlasEntry& entry)
+    {
+        return AlignUp(static_cast<uint32_t>(entry.Image.GetMetadata().width) + 2 * padding, alignment);
+    };
+    const auto getCellHeight = [&](const AtlasEntry& entry)
+    {
+        return AlignUp(static_cast<uint32_t>(entry.Image.GetMetadata().height) + 2 * padding, alignment);
+    };
+
+    // Tallest first keeps the packer's free rectangles large for as long as possible
+    std::vector<uint32_t> entryOrder(_entries.size());
+    std::iota(entryOrder.begin(), entryOrder.end(), 0);
+    std::sort(entryOrder.begin(), entryOrder.end(), [&](const uint32_t left, const uint32_t right)
+              {
+                  const uint32_t leftHeight = getCellHeight(_entries[left]);
+                  const uint32_t rightHeight = getCellHeight(_entries[right]);
+                  return leftHeight != rightHeight ? leftHeight > rightHeight : getCellWidth(_entries[left]) > getCellWidth(_entries[right]); });
+
+    uint64_t cellArea = 0;
+    for (const AtlasEntry& entry : _entries)
+    {
+        cellArea += static_cast<uint64_t>(getCellWidth(entry)) * getCellHeight(entry);
+    }
+
+    // Starting from the smallest power of two size with enough area, the width and then the height are doubled until everything fits
+    uint32_t width = alignment;
+    uint32_t height = alignment;
+    const auto grow = [&]()
+    {
+        if (width <= height)
+        {
+            width *= 2;
+        }
+        else
+        {
+            height *= 2;
+        }
+    };
+    while (static_cast<uint64_t>(width) * height < cellArea)
+    {
+        grow();
+    }
+
+    float occupancy = 0.0f;
+    while (true)
+    {
+        if (width > _settings.MaxSize || height > _settings.MaxSize)
+        {
+            std::cout << "TextureAtlasBuilder: Failed to fit " << _entries.size() << " textures into " << _settings.MaxSize << "x" << _settings.MaxSize << " texels\n";
+            return false;
+        }
+
+        RectanglePacker packer(width, height);
+        bool isPacked = true;
+        for (const uint32_t entryIndex : entryOrder)
+        {
+            AtlasEntry& entry = _entries[entryIndex];
+            if (!packer.Insert(getCellWidth(entry), getCellHeight(entry), entry.X, entry.Y))
+            {
+                isPacked = false;
+                break;
+            }
+        }
+
+        if (isPacked)
+        {
+            occupancy = packer.GetOccupancy();
+            break;
+        }
+
+        grow();
+    }
+
+    DirectX::ScratchImage atlasImage;
+    if (!BlitEntries(width, height, atlasImage))
+    {
+        std::cout << "TextureAtlasBuilder: Failed to create atlas image\n";
+        return false;
+    }
+
+    for (size_t i = 0; i < _entries.size(); i++)
+    {
+        const AtlasEntry& entry = _entries[i];
+        const DirectX::TexMetadata& metaData = entry.Image.GetMetadata();
+        AtlasRegion& region = _regions[i];
+        region.UvOffset = DirectX::XMFLOAT2(
+            static_cast<float>(entry.X + padding) / static_cast<float>(width),
+            static_cast<float>(entry.Y + padding) / static_cast<float>(height));
+        region.UvScale = DirectX::XMFLOAT2(
+            static_cast<float>(metaData.width) / static_cast<float>(width),
+            static_cast<float>(metaData.height) / static_cast<float>(height));
+    }
+
+    // Cells are only aligned for MipLevels levels, further ones would average neighbouring cells.
+    // The atlas is at least as large as the alignment, so it always has that many.
+    const uint32_t mipLevels = _settings.MipLevels;
+
+    if (mipLevels == 1)
+    {
+        _image = std::move(atlasImage);
+    }
+    else if (FAILED(DirectX::GenerateMipMaps(
+                 *atlasImage.GetImage(0, 0, 0),
+                 DirectX::TEX_FILTER_BOX | DirectX::TEX_FILTER_FORCE_NON_WIC,
+                 mipLevels,
+                 _image)))
+    {
+        std::cout << "DXTEX: Failed to generate atlas mips\n";
+        return false;
+    }
+
+    _statistics.Regions = static_cast<uint32_t>(_entries.size());
+    _statistics.Width = width;
+    _statistics.Height = height;
+    _statistics.MipLevels = mipLevels;
+    _statistics.Occupancy = occupancy;
+    return true;
+}
+
+bool TextureAtlasBuilder::Save(const std::filesystem::path& filePath) const
+{
+    if (_image.GetImageCount() == 0)
+    {
+        return false;
+    }
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(filePath.parent_path(), errorCode);
+
+    std::filesystem::path temporaryFilePath = filePath;
+    temporaryFilePath += ".tmp";
+    if (FAILED(DirectX::SaveToDDSFile(
+            _image.GetImages(),
+            _image.GetImageCount(),
+            _image.GetMetadata(),
+            DirectX::DDS_FLAGS_NONE,
+            temporaryFilePath.wstring().c_str())))
+    {
+        std::filesystem::remove(temporaryFilePath, errorCode);
+        return false;
+    }
+
+    std::filesystem::rename(temporaryFilePath, filePath, errorCode);
+    if (errorCode)
+    {
+        std::filesystem::remove(temporaryFilePath, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+const AtlasRegion& TextureAtlasBuilder::GetRegion(const uint32_t region) const
+{
+    return _regions[region];
+}
+
+const DirectX::ScratchImage& TextureAtlasBuilder::GetImage() const
+{
+    return _image;
+}
+
+const TextureAtlasStatistics& TextureAtlasBuilder::GetStatistics() const
+{
+    return _statistics;
+}
+
+void TextureAtlasBuilder::PrintStatistics() const
+{
+    std::cout << "TextureAtlasBuilder: " << _statistics.Regions << " textures packed into " << _statistics.Width << "x"
+              << _statistics.Height << " texels with " << _statistics.MipLevels << " levels, "
+              << _statistics.Occupancy * 100.0f << "% of it covered\n";
+}
+
+// The gutters and the rest of the cell repeat the image's edge texels. With the padding the
+// constructor enforces they are still half a texel wide on the last level, so bilinear filtering
+// at a region's border only ever reads texels of its own cell
+bool TextureAtlasBuilder::BlitEntries(
+    const uint32_t width,
+    const uint32_t height,
+    DirectX::ScratchImage& atlasImage) const
+{
+    if (FAILED(atlasImage.Initialize2D(AtlasFormat, width, height, 1, 1)))
+    {
+        return false;
+    }
+
+    const DirectX::Image& destination = *atlasImage.GetImage(0, 0, 0);
+    std::memset(destination.pixels, 0, destination.slicePitch);
+
+    const uint32_t alignment = 1u << (_settings.MipLevels - 1);
+    const int32_t padding = static_cast<int32_t>(_settings.Padding);
+    for (const AtlasEntry& entry : _entries)
+    {
+        const DirectX::Image& source = *entry.Image.GetImage(0, 0, 0);
+        const int32_t sourceWidth = static_cast<int32_t>(source.width);
+        const int32_t sourceHeight = static_cast<int32_t>(source.height);
+        const uint32_t cellWidth = AlignUp(static_cast<uint32_t>(source.width) + 2 * _settings.Padding, alignment);
+        const uint32_t cellHeight = AlignUp(static_cast<uint32_t>(source.height) + 2 * _settings.Padding, alignment);
+        for (uint32_t y = 0; y < cellHeight; y++)
+        {
+            int32_t sourceY = static_cast<int32_t>(y) - padding;
+            sourceY = sourceY < 0 ? 0 : (sourceY >= sourceHeight ? sourceHeight - 1 : sourceY);
+            const uint32_t* sourceRow = reinterpret_cast<const uint32_t*>(source.pixels + source.rowPitch * sourceY);
+            uint32_t* destinationRow = reinterpret_cast<uint32_t*>(destination.pixels + destination.rowPitch * (entry.Y + y)) + entry.X;
+            for (uint32_t x = 0; x < cellWidth; x++)
+            {
+                int32_t sourceX = static_cast<int32_t>(x) - padding;
+                sourceX = sourceX < 0 ? 0 : (sourceX >= sourceWidth ? sourceWidth - 1 : sourceX);
+                destinationRow[x] = sourceRow[sourceX];
+            }
+        }
+    }
+
+    return true;
+}
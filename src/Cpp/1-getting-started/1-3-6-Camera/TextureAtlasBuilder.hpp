@@ -0,0 +1,85 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <DirectXTex.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+constexpr uint32_t InvalidAtlasRegion = ~0u;
+
+// Padding is how many texels of the image's clamped edge surround every region. Regions start
+// and end on multiples of 2^(MipLevels - 1) texels, so no level of the mip chain averages texels
+// of two regions. The gutters halve with every level though, bilinear filtering at a region's
+// border stays inside it only while they are at least half a texel wide. Padding is therefore
+// raised to 2^(MipLevels - 2) when it is smaller. More levels waste more space on both.
+struct TextureAtlasSettings
+{
+    uint32_t MaxSize = 4096;
+    uint32_t Padding = 8;
+    uint32_t MipLevels = 5;
+};
+
+// Where a texture ended up, uvs in [0, 1] of the texture become UvOffset + uv * UvScale in the atlas
+struct AtlasRegion
+{
+    DirectX::XMFLOAT2 UvOffset = { 0.0f, 0.0f };
+    DirectX::XMFLOAT2 UvScale = { 1.0f, 1.0f };
+};
+
+struct TextureAtlasStatistics
+{
+    uint32_t Regions = 0;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t MipLevels = 0;
+    float Occupancy = 0.0f;
+};
+
+// Packs many small textures into one B8G8R8A8 texture with a RectanglePacker, so everything
+// using them can be drawn with a single texture bound. Textures are added first, Build packs
+// them largest first into the smallest power of two size they fit and generates the mips.
+class TextureAtlasBuilder
+{
+public:
+    TextureAtlasBuilder(const TextureAtlasSettings& settings);
+
+    // Returns the texture's region, the same one for a file added twice, or InvalidAtlasRegion when it cannot be loaded.
+    // DDS files are read with DirectXTex, everything else with FreeImage.
+    [[nodiscard]] uint32_t AddTexture(const std::filesystem::path& filePath);
+    // A single texel region for surfaces without a texture, color is 0xAARRGGBB
+    [[nodiscard]] uint32_t AddSolidColor(uint32_t color);
+
+    bool Build();
+    // Written to a temporary file first and renamed, like cooked models
+    bool Save(const std::filesystem::path& filePath) const;
+
+    [[nodiscard]] const AtlasRegion& GetRegion(uint32_t region) const;
+    [[nodiscard]] const DirectX::ScratchImage& GetImage() const;
+    [[nodiscard]] const TextureAtlasStatistics& GetStatistics() const;
+    void PrintStatistics() const;
+
+private:
+    struct AtlasEntry
+    {
+        DirectX::ScratchImage Image;
+        uint32_t X = 0;
+        uint32_t Y = 0;
+    };
+
+    bool BlitEntries(
+        uint32_t width,
+        uint32_t height,
+        DirectX::ScratchImage& atlasImage) const;
+
+    TextureAtlasSettings _settings = {};
+    std::vector<AtlasEntry> _entries;
+    std::vector<AtlasRegion> _regions;
+    std::unordered_map<std::wstring, uint32_t> _regionsByPath;
+    std::unordered_map<uint32_t, uint32_t> _regionsByColor;
+    DirectX::ScratchImage _image;
+    TextureAtlasStatistics _statistics = {};
+};
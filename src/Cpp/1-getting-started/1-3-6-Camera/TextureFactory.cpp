@@ -1,50 +1,304 @@
 #include "TextureFactory.hpp"
+#include "DdsReader.hpp"
+#include "RenderBackend.hpp"
+
+#include <Hash.hpp>
+#include <MemoryMappedFile.hpp>
 
 #include <DirectXTex.h>
 
+#include <cwctype>
+#include <filesystem>
 #include <iostream>
+#include <vector>
+
+namespace
+{
+// Paths differing in separators or relative parts name the same file, on Windows so do paths differing only in case
+std::wstring NormalizeFilePath(const std::wstring& filePath)
+{
+    std::error_code errorCode;
+    std::filesystem::path absolutePath = std::filesystem::absolute(filePath, errorCode);
+    if (errorCode)
+    {
+        absolutePath = filePath;
+    }
+
+    std::wstring normalizedPath = absolutePath.lexically_normal().make_preferred().wstring();
+#if defined(_WIN32)
+    for (wchar_t& character : normalizedPath)
+    {
+        character = static_cast<wchar_t>(std::towlower(character));
+    }
+#endif
+
+    return normalizedPath;
+}
+
+bool CreateShaderResourceView(
+    RenderBackend& renderBackend,
+    const DdsTexture& ddsTexture,
+    std::shared_ptr<RenderShaderResourceView>& shaderResourceView)
+{
+    RenderTextureDescription textureDescription = {};
+    textureDescription.Width = ddsTexture.Width;
+    textureDescription.Height = ddsTexture.Height;
+    textureDescription.MipLevels = ddsTexture.MipLevels;
+    textureDescription.ArraySize = ddsTexture.ArraySize;
+    textureDescription.Format = ddsTexture.Format;
+    textureDescription.Usage = RenderUsage::Immutable;
+    textureDescription.BindFlags = RenderBindFlags::RenderBindShaderResource;
+    textureDescription.IsCubemap = ddsTexture.IsCubemap;
+
+    std::shared_ptr<RenderTexture2D> texture = nullptr;
+    if (!renderBackend.CreateTexture2D(
+            textureDescription,
+            ddsTexture.Subresources.data(),
+            texture))
+    {
+        std::cout << "DXTEX: Failed to create texture out of image\n";
+        return false;
+    }
+
+    RenderShaderResourceViewDescription shaderResourceViewDescription = {};
+    shaderResourceViewDescription.Format = ddsTexture.Format;
+    shaderResourceViewDescription.MipLevels = textureDescription.MipLevels;
+    if (ddsTexture.IsCubemap)
+    {
+        shaderResourceViewDescription.Dimension = RenderShaderResourceViewDimension::TextureCube;
+        shaderResourceViewDescription.ArraySize = textureDescription.ArraySize;
+    }
+    else if (ddsTexture.ArraySize > 1)
+    {
+        shaderResourceViewDescription.Dimension = RenderShaderResourceViewDimension::Texture2DArray;
+        shaderResourceViewDescription.ArraySize = textureDescription.ArraySize;
+    }
+    else
+    {
+        shaderResourceViewDescription.Dimension = RenderShaderResourceViewDimension::Texture2D;
+    }
+
+    if (!renderBackend.CreateShaderResourceView(
+            texture.get(),
+            shaderResourceViewDescription,
+            shaderResourceView))
+    {
+        std::cout << "DXTEX: Failed to create shader resource view out of texture\n";
+        return false;
+    }
+
+    return true;
+}
+
+// DirectXTex converts whatever the mapping could not be used for as it is, into its own copy of the pixels
+bool ConvertDdsTexture(
+    const MemoryMappedFile& file,
+    DirectX::ScratchImage& scratchImage,
+    DdsTexture& ddsTexture)
+{
+    DirectX::TexMetadata metaData = {};
+    if (FAILED(DirectX::LoadFromDDSMemory(file.GetData(), file.GetSize(), DirectX::DDS_FLAGS_NONE, &metaData, scratchImage)))
+    {
+        std::cout << "DXTEX: Failed to load image\n";
+        return false;
+    }
+
+    if (metaData.dimension != DirectX::TEX_DIMENSION::TEX_DIMENSION_TEXTURE2D)
+    {
+        std::cout << "DXTEX: Only 2D textures are supported\n";
+        return false;
+    }
+
+    ddsTexture = {};
+    ddsTexture.Width = static_cast<uint32_t>(metaData.width);
+    ddsTexture.Height = static_cast<uint32_t>(metaData.height);
+    ddsTexture.MipLevels = static_cast<uint32_t>(metaData.mipLevels);
+    ddsTexture.ArraySize = static_cast<uint32_t>(metaData.arraySize);
+    ddsTexture.Format = static_cast<RenderFormat>(metaData.format);
+    ddsTexture.IsCubemap = metaData.IsCubemap();
+    ddsTexture.PixelBytes = scratchImage.GetPixelsSize();
+
+    // ScratchImage stores its images item by item, each with its full mip chain,
+    // which is exactly the subresource order D3D11 expects
+    ddsTexture.Subresources.resize(scratchImage.GetImageCount());
+    for (size_t i = 0; i < scratchImage.GetImageCount(); i++)
+    {
+        const DirectX::Image& image = scratchImage.GetImages()[i];
+        ddsTexture.Subresources[i].Data = image.pixels;
+        ddsTexture.Subresources[i].RowPitch = static_cast<uint32_t>(image.rowPitch);
+        ddsTexture.Subresources[i].SlicePitch = static_cast<uint32_t>(image.slicePitch);
+    }
+
+    return true;
+}
+} // namespace
+
+TextureFactory::TextureFactory(const std::shared_ptr<RenderBackend>& renderBackend)
+{
+    _renderBackend = renderBackend;
+}
 
-TextureFactory::TextureFactory(const WRL::ComPtr<ID3D11Device>& device)
+void TextureFactory::SetContentHashing(const bool isContentHashingEnabled)
 {
-    _device = device;
+    _isContentHashingEnabled = isContentHashingEnabled;
 }
 
 bool TextureFactory::CreateShaderResourceViewFromFile(
     const std::wstring& filePath,
-    WRL::ComPtr<ID3D11ShaderResourceView>& shaderResourceView) const
+    std::shared_ptr<RenderShaderResourceView>& shaderResourceView)
 {
-    DirectX::TexMetadata metaData = {};
-    DirectX::ScratchImage scratchImage;
-    if (FAILED(DirectX::LoadFromDDSFile(filePath.data(), DirectX::DDS_FLAGS_NONE, &metaData, scratchImage)))
+    const std::wstring normalizedFilePath = NormalizeFilePath(filePath);
+    const auto cachedTexture = _texturesByPath.find(normalizedFilePath);
+    if (cachedTexture != _texturesByPath.end())
+    {
+        _hits++;
+        AddReference(cachedTexture->second, normalizedFilePath);
+        shaderResourceView = _textures[cachedTexture->second].ShaderResourceView;
+        return true;
+    }
+
+    // Mapped rather than read, a DDS file's pixels can be uploaded straight out of the mapping
+    MemoryMappedFile file;
+    if (!file.Open(normalizedFilePath))
     {
         std::cout << "DXTEX: Failed to load image\n";
         return false;
     }
 
-    WRL::ComPtr<ID3D11Resource> texture = nullptr;
-    if (FAILED(DirectX::CreateTexture(
-            _device.Get(),
-            scratchImage.GetImages(),
-            scratchImage.GetImageCount(),
-            metaData,
-            &texture)))
+    uint64_t contentHash = 0;
+    if (_isContentHashingEnabled)
+    {
+        contentHash = HashBytes(file.GetData(), file.GetSize());
+        const auto cachedContent = _texturesByContent.find(contentHash);
+        if (cachedContent != _texturesByContent.end())
+        {
+            _contentHits++;
+            AddReference(cachedContent->second, normalizedFilePath);
+            shaderResourceView = _textures[cachedContent->second].ShaderResourceView;
+            return true;
+        }
+    }
+
+    DdsTexture ddsTexture = {};
+    DirectX::ScratchImage scratchImage;
+    if (ReadDdsTexture(file.GetData(), file.GetSize(), ddsTexture))
+    {
+        _mappedLoads++;
+    }
+    else if (ConvertDdsTexture(file, scratchImage, ddsTexture))
+    {
+        _convertedLoads++;
+    }
+    else
     {
-        std::cout << "DXTEX: Failed to create texture out of image\n";
-        scratchImage.Release();
         return false;
     }
 
-    if (FAILED(DirectX::CreateShaderResourceView(
-            _device.Get(),
-            scratchImage.GetImages(),
-            scratchImage.GetImageCount(),
-            metaData,
-            &shaderResourceView)))
+    std::shared_ptr<RenderShaderResourceView> tempShaderResourceView = nullptr;
+    if (!CreateShaderResourceView(*_renderBackend, ddsTexture, tempShaderResourceView))
     {
-        std::cout << "DXTEX: Failed to create shader resource view out of texture\n";
-        scratchImage.Release();
         return false;
     }
 
+    // The texture is created once with all its subresources as initial data, and the view is made of that very texture
+    _uploads++;
+    _uploadedBytes += ddsTexture.PixelBytes;
+
+    _misses++;
+    uint32_t textureIndex = static_cast<uint32_t>(_textures.size());
+    if (_freeTextureIndices.empty())
+    {
+        _textures.emplace_back();
+    }
+    else
+    {
+        textureIndex = _freeTextureIndices.back();
+        _freeTextureIndices.pop_back();
+    }
+
+    CachedTexture& texture = _textures[textureIndex];
+    texture.ShaderResourceView = tempShaderResourceView;
+    texture.ResidentBytes = ddsTexture.PixelBytes;
+    texture.ContentHash = contentHash;
+    texture.HasContentHash = _isContentHashingEnabled;
+    if (texture.HasContentHash)
+    {
+        _texturesByContent[contentHash] = textureIndex;
+    }
+
+    AddReference(textureIndex, normalizedFilePath);
+    shaderResourceView = std::move(tempShaderResourceView);
     return true;
 }
+
+void TextureFactory::ReleaseShaderResourceView(const std::wstring& filePath)
+{
+    const auto cachedTexture = _texturesByPath.find(NormalizeFilePath(filePath));
+    if (cachedTexture == _texturesByPath.end())
+    {
+        return;
+    }
+
+    const uint32_t textureIndex = cachedTexture->second;
+    CachedTexture& texture = _textures[textureIndex];
+    if (--texture.References > 0)
+    {
+        return;
+    }
+
+    // Views handed out earlier keep the texture itself alive until their owners let go of them
+    for (const std::wstring& texturePath : texture.FilePaths)
+    {
+        _texturesByPath.erase(texturePath);
+    }
+
+    if (texture.HasContentHash)
+    {
+        _texturesByContent.erase(texture.ContentHash);
+    }
+
+    texture = {};
+    _freeTextureIndices.push_back(textureIndex);
+}
+
+TextureCacheStatistics TextureFactory::GetStatistics() const
+{
+    TextureCacheStatistics statistics = {};
+    statistics.Textures = static_cast<uint32_t>(_textures.size() - _freeTextureIndices.size());
+    statistics.Hits = _hits;
+    statistics.ContentHits = _contentHits;
+    statistics.Misses = _misses;
+    statistics.MappedLoads = _mappedLoads;
+    statistics.ConvertedLoads = _convertedLoads;
+    statistics.Uploads = _uploads;
+    statistics.UploadedBytes = _uploadedBytes;
+    for (const CachedTexture& texture : _textures)
+    {
+        statistics.References += texture.References;
+        statistics.ResidentBytes += texture.ResidentBytes;
+    }
+
+    return statistics;
+}
+
+void TextureFactory::PrintStatistics() const
+{
+    const TextureCacheStatistics statistics = GetStatistics();
+    std::cout << "TextureFactory: " << statistics.Textures << " textures (" << statistics.ResidentBytes / 1024 << " KiB resident) with "
+              << statistics.References << " references, " << statistics.Hits << " hits, " << statistics.ContentHits
+              << " content hits, " << statistics.Misses << " misses (" << statistics.MappedLoads << " mapped, "
+              << statistics.ConvertedLoads << " converted), " << statistics.Uploads << " uploads ("
+              << statistics.UploadedBytes / 1024 << " KiB)\n";
+}
+
+void TextureFactory::AddReference(
+    const uint32_t textureIndex,
+    const std::wstring& filePath)
+{
+    CachedTexture& texture = _textures[textureIndex];
+    texture.References++;
+    if (_texturesByPath.emplace(filePath, textureIndex).second)
+    {
+        texture.FilePaths.push_back(filePath);
+    }
+}
@@ -1,19 +1,77 @@
 #pragma once
 
-#include "Definitions.hpp"
-#include <d3d11.h>
+#include "RenderTypes.hpp"
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+class RenderBackend;
+
+struct TextureCacheStatistics
+{
+    uint32_t Textures = 0;
+    uint32_t References = 0;
+    uint32_t Hits = 0;
+    uint32_t ContentHits = 0;
+    uint32_t Misses = 0;
+    uint64_t ResidentBytes = 0;
+    uint32_t MappedLoads = 0;
+    uint32_t ConvertedLoads = 0;
+    uint32_t Uploads = 0;
+    uint64_t UploadedBytes = 0;
+};
+
+// Textures are cached by their normalized path, so every material referring to the same file
+// shares one texture. With content hashing enabled, different files with identical contents
+// share one texture as well. Each successful create takes a reference the caller gives back
+// with ReleaseShaderResourceView, the texture leaves the cache with its last reference.
+// DDS files are memory mapped and uploaded straight out of the mapping, only formats which
+// need converting are copied into a ScratchImage first.
 class TextureFactory
 {
 public:
-    TextureFactory(const WRL::ComPtr<ID3D11Device>& device);
+    TextureFactory(const std::shared_ptr<RenderBackend>& renderBackend);
+
+    void SetContentHashing(bool isContentHashingEnabled);
 
     bool CreateShaderResourceViewFromFile(
         const std::wstring& filePath,
-        WRL::ComPtr<ID3D11ShaderResourceView>& shaderResourceView) const;
+        std::shared_ptr<RenderShaderResourceView>& shaderResourceView);
+    void ReleaseShaderResourceView(const std::wstring& filePath);
+
+    [[nodiscard]] TextureCacheStatistics GetStatistics() const;
+    void PrintStatistics() const;
 
 private:
-    WRL::ComPtr<ID3D11Device> _device = nullptr;
+    struct CachedTexture
+    {
+        std::shared_ptr<RenderShaderResourceView> ShaderResourceView = nullptr;
+        uint64_t ResidentBytes = 0;
+        uint64_t ContentHash = 0;
+        bool HasContentHash = false;
+        uint32_t References = 0;
+        // Every interned path resolving to this texture
+        std::vector<std::wstring> FilePaths;
+    };
+
+    void AddReference(
+        uint32_t textureIndex,
+        const std::wstring& filePath);
+
+    std::shared_ptr<RenderBackend> _renderBackend = nullptr;
+    bool _isContentHashingEnabled = false;
+    std::vector<CachedTexture> _textures;
+    std::vector<uint32_t> _freeTextureIndices;
+    std::unordered_map<std::wstring, uint32_t> _texturesByPath;
+    std::unordered_map<uint64_t, uint32_t> _texturesByContent;
+    uint32_t _hits = 0;
+    uint32_t _contentHits = 0;
+    uint32_t _misses = 0;
+    uint32_t _mappedLoads = 0;
+    uint32_t _convertedLoads = 0;
+    uint32_t _uploads = 0;
+    uint64_t _uploadedBytes = 0;
 };
@@ -0,0 +1,496 @@
+#include "TextureStreamer.hpp"
+#include "RenderBackend.hpp"
+
+#include <MemoryMappedFile.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+uint32_t GetMipSize(
+    const uint32_t size,
+    const uint32_t mip)
+{
+    const uint32_t mipSize = size >> mip;
+    return mipSize > 0 ? mipSize : 1;
+}
+
+// D3D11 only creates block compressed textures whose top level is a whole number of 4x4 blocks
+// wide and high. Every level above such a level is as well, so this is the deepest level the
+// resident texture may start at.
+uint32_t GetDeepestTopMip(const DdsTexture& ddsTexture)
+{
+    if (!IsBlockCompressed(ddsTexture.Format))
+    {
+        return ddsTexture.MipLevels - 1;
+    }
+
+    uint32_t mip = 0;
+    while (mip + 1 < ddsTexture.MipLevels &&
+           GetMipSize(ddsTexture.Width, mip + 1) % 4 == 0 &&
+           GetMipSize(ddsTexture.Height, mip + 1) % 4 == 0)
+    {
+        mip++;
+    }
+
+    return mip;
+}
+} // namespace
+
+TextureStreamer::TextureStreamer(
+    const std::shared_ptr<RenderBackend>& renderBackend,
+    const uint64_t memoryBudget,
+    const uint32_t tailSize,
+    const uint32_t ioThreadCount)
+{
+    _renderBackend = renderBackend;
+    _memoryBudget = memoryBudget;
+    _tailSize = tailSize;
+    for (uint32_t i = 0; i < ioThreadCount; i++)
+    {
+        _ioThreads.emplace_back(&TextureStreamer::RunIoThread, this);
+    }
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(_loadMutex);
+        _isStopping = true;
+    }
+    _loadCondition.notify_all();
+    for (std::thread& ioThread : _ioThreads)
+    {
+        ioThread.join();
+    }
+}
+
+bool TextureStreamer::CreateTexture(
+    const std::wstring& filePath,
+    StreamedTextureHandle& handle)
+{
+    auto file = std::make_shared<MemoryMappedFile>();
+    if (!file->Open(filePath))
+    {
+        std::cout << "TextureStreamer: Failed to open texture\n";
+        return false;
+    }
+
+    DdsTexture ddsTexture = {};
+    if (!ReadDdsTexture(file->GetData(), file->GetSize(), ddsTexture))
+    {
+        std::cout << "TextureStreamer: Texture can not be used as it is, it has to be loaded whole\n";
+        return false;
+    }
+
+    if (ddsTexture.ArraySize != 1 || ddsTexture.IsCubemap)
+    {
+        std::cout << "TextureStreamer: Only 2D textures are streamed\n";
+        return false;
+    }
+
+    if (IsBlockCompressed(ddsTexture.Format) && (ddsTexture.Width % 4 != 0 || ddsTexture.Height % 4 != 0))
+    {
+        std::cout << "TextureStreamer: Block compressed textures have to be a multiple of 4 texels wide and high to be streamed\n";
+        return false;
+    }
+
+    uint32_t textureIndex = static_cast<uint32_t>(_textures.size());
+    if (_freeTextureIndices.empty())
+    {
+        _textures.emplace_back();
+    }
+    else
+    {
+        textureIndex = _freeTextureIndices.back();
+        _freeTextureIndices.pop_back();
+    }
+
+    StreamedTexture& texture = _textures[textureIndex];
+    texture.File = std::move(file);
+    texture.Dds = std::move(ddsTexture);
+    texture.TailMip = GetDeepestTopMip(texture.Dds);
+    while (texture.TailMip > 0 &&
+           GetMipSize(texture.Dds.Width, texture.TailMip - 1) <= _tailSize &&
+           GetMipSize(texture.Dds.Height, texture.TailMip - 1) <= _tailSize)
+    {
+        texture.TailMip--;
+    }
+    texture.DesiredMip = texture.TailMip;
+    texture.LoadingMip = NoMip;
+    texture.IsAllocated = true;
+
+    // Only the tail is read here, the pages of the larger levels are not touched before they are streamed
+    if (!CreateResidentTexture(texture, texture.TailMip, nullptr))
+    {
+        DestroyTexture(textureIndex);
+        return false;
+    }
+
+    _uploads++;
+    _uploadedBytes += texture.ResidentBytes;
+    handle = textureIndex;
+    return true;
+}
+
+void TextureStreamer::DestroyTexture(const StreamedTextureHandle handle)
+{
+    if (handle >= _textures.size() || !_textures[handle].IsAllocated)
+    {
+        return;
+    }
+
+    // Loads still in flight for it no longer match the generation and are dropped when they finish
+    StreamedTexture& texture = _textures[handle];
+    _residentBytes -= texture.ResidentBytes;
+    const uint32_t generation = texture.Generation + 1;
+    texture = {};
+    texture.Generation = generation;
+    _freeTextureIndices.push_back(handle);
+}
+
+void TextureStreamer::RequestResidency(
+    const StreamedTextureHandle handle,
+    const float screenSize)
+{
+    StreamedTexture& texture = _textures[handle];
+    if (texture.LastUsedFrame != _frame || screenSize > texture.ScreenSize)
+    {
+        texture.ScreenSize = screenSize;
+    }
+    texture.LastUsedFrame = _frame;
+}
+
+void TextureStreamer::Update()
+{
+    for (StreamedTexture& texture : _textures)
+    {
+        if (texture.IsAllocated)
+        {
+            texture.DesiredMip = GetDesiredMip(texture);
+        }
+    }
+
+    std::vector<MipLoad> completedLoads;
+    {
+        std::lock_guard<std::mutex> lock(_loadMutex);
+        completedLoads.swap(_completedLoads);
+
+        // Loads which have not started yet follow the camera, those not needed anymore are dropped
+        for (auto pendingLoad = _pendingLoads.begin(); pendingLoad != _pendingLoads.end();)
+        {
+            StreamedTexture& texture = _textures[pendingLoad->TextureIndex];
+            const bool isCurrent = texture.Generation == pendingLoad->Generation;
+            if (isCurrent && texture.DesiredMip <= pendingLoad->Mip)
+            {
+                pendingLoad->Priority = texture.ScreenSize;
+                ++pendingLoad;
+                continue;
+            }
+
+            if (isCurrent)
+            {
+                texture.LoadingMip = NoMip;
+            }
+            _cancelledLoads++;
+            pendingLoad = _pendingLoads.erase(pendingLoad);
+        }
+    }
+
+    // What is largest on screen gets the room first
+    std::sort(completedLoads.begin(), completedLoads.end(), [](const MipLoad& a, const MipLoad& b)
+    {
+        return a.Priority > b.Priority;
+    });
+
+    for (const MipLoad& load : completedLoads)
+    {
+        StreamedTexture& texture = _textures[load.TextureIndex];
+        if (texture.Generation != load.Generation)
+        {
+            _cancelledLoads++;
+            continue;
+        }
+
+        texture.LoadingMip = NoMip;
+        if (load.Mip + 1 != texture.ResidentMip ||
+            texture.DesiredMip > load.Mip ||
+            !MakeRoom(load.Source.SlicePitch, texture) ||
+            !CreateResidentTexture(texture, load.Mip, &load))
+        {
+            _cancelledLoads++;
+            continue;
+        }
+
+        _loads++;
+        _uploads++;
+        _uploadedBytes += load.Source.SlicePitch;
+    }
+
+    // One level at a time per texture, each level is as large as all the ones below it together
+    std::vector<MipLoad> newLoads;
+    for (uint32_t i = 0; i < _textures.size(); i++)
+    {
+        StreamedTexture& texture = _textures[i];
+        if (!texture.IsAllocated || texture.LoadingMip != NoMip || texture.DesiredMip >= texture.ResidentMip)
+        {
+            continue;
+        }
+
+        const uint32_t mip = texture.ResidentMip - 1;
+        const RenderSubresourceData& source = texture.Dds.Subresources[mip];
+        if (!CanMakeRoom(source.SlicePitch, texture))
+        {
+            continue;
+        }
+
+        MipLoad load = {};
+        load.TextureIndex = i;
+        load.Generation = texture.Generation;
+        load.Mip = mip;
+        load.Priority = texture.ScreenSize;
+        load.File = texture.File;
+        load.Source = source;
+        newLoads.push_back(std::move(load));
+        texture.LoadingMip = mip;
+    }
+
+    if (!newLoads.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(_loadMutex);
+            for (MipLoad& load : newLoads)
+            {
+                _pendingLoads.push_back(std::move(load));
+            }
+        }
+        _loadCondition.notify_all();
+    }
+
+    _frame++;
+}
+
+const std::shared_ptr<RenderShaderResourceView>& TextureStreamer::GetShaderResourceView(const StreamedTextureHandle handle) const
+{
+    return _textures[handle].ShaderResourceView;
+}
+
+uint32_t TextureStreamer::GetResidentMip(const StreamedTextureHandle handle) const
+{
+    return _textures[handle].ResidentMip;
+}
+
+TextureStreamingStatistics TextureStreamer::GetStatistics() const
+{
+    TextureStreamingStatistics statistics = {};
+    statistics.Textures = static_cast<uint32_t>(_textures.size() - _freeTextureIndices.size());
+    statistics.ResidentBytes = _residentBytes;
+    statistics.MemoryBudget = _memoryBudget;
+    statistics.CompletedLoads = _loads;
+    statistics.CancelledLoads = _cancelledLoads;
+    statistics.Evictions = _evictions;
+    statistics.Uploads = _uploads;
+    statistics.UploadedBytes = _uploadedBytes;
+    {
+        std::lock_guard<std::mutex> lock(_loadMutex);
+        statistics.PendingLoads = static_cast<uint32_t>(_pendingLoads.size() + _completedLoads.size());
+    }
+
+    return statistics;
+}
+
+void TextureStreamer::PrintStatistics() const
+{
+    const TextureStreamingStatistics statistics = GetStatistics();
+    std::cout << "TextureStreamer: " << statistics.Textures << " textures (" << statistics.ResidentBytes / 1024 << " of "
+              << statistics.MemoryBudget / 1024 << " KiB resident), " << statistics.CompletedLoads << " levels streamed in, "
+              << statistics.CancelledLoads << " cancelled, " << statistics.PendingLoads << " pending, " << statistics.Evictions
+              << " evicted, " << statistics.Uploads << " uploads (" << statistics.UploadedBytes / 1024 << " KiB)\n";
+}
+
+void TextureStreamer::RunIoThread()
+{
+    std::unique_lock<std::mutex> lock(_loadMutex);
+    while (true)
+    {
+        _loadCondition.wait(lock, [this]()
+        {
+            return _isStopping || !_pendingLoads.empty();
+        });
+        if (_isStopping)
+        {
+            return;
+        }
+
+        const auto nextLoad = std::max_element(_pendingLoads.begin(), _pendingLoads.end(), [](const MipLoad& a, const MipLoad& b)
+        {
+            return a.Priority < b.Priority;
+        });
+        MipLoad load = std::move(*nextLoad);
+        _pendingLoads.erase(nextLoad);
+        lock.unlock();
+
+        // Touching the mapped pages is what reads them from disk, which is why it happens here and not on the render thread
+        const uint8_t* pixels = static_cast<const uint8_t*>(load.Source.Data);
+        load.Pixels.assign(pixels, pixels + load.Source.SlicePitch);
+
+        lock.lock();
+        _completedLoads.push_back(std::move(load));
+    }
+}
+
+bool TextureStreamer::CreateResidentTexture(
+    StreamedTexture& texture,
+    const uint32_t residentMip,
+    const MipLoad* load)
+{
+    const DdsTexture& ddsTexture = texture.Dds;
+    RenderTextureDescription textureDescription = {};
+    textureDescription.Width = GetMipSize(ddsTexture.Width, residentMip);
+    textureDescription.Height = GetMipSize(ddsTexture.Height, residentMip);
+    textureDescription.MipLevels = ddsTexture.MipLevels - residentMip;
+    textureDescription.ArraySize = 1;
+    textureDescription.Format = ddsTexture.Format;
+    textureDescription.Usage = RenderUsage::Default;
+    textureDescription.BindFlags = RenderBindFlags::RenderBindShaderResource;
+
+    // The first time the levels come straight out of the mapped file, afterwards the resident ones
+    // are copied over from the old texture and only a streamed in level is uploaded
+    std::shared_ptr<RenderTexture2D> newTexture = nullptr;
+    const RenderSubresourceData* initialData = texture.Texture == nullptr ? &ddsTexture.Subresources[residentMip] : nullptr;
+    if (!_renderBackend->CreateTexture2D(textureDescription, initialData, newTexture))
+    {
+        std::cout << "TextureStreamer: Failed to create texture\n";
+        return false;
+    }
+
+    uint64_t residentBytes = 0;
+    for (uint32_t mip = residentMip; mip < ddsTexture.MipLevels; mip++)
+    {
+        residentBytes += ddsTexture.Subresources[mip].SlicePitch;
+        if (texture.Texture == nullptr)
+        {
+            continue;
+        }
+
+        if (mip >= texture.ResidentMip)
+        {
+            _renderBackend->CopySubresourceRegion(newTexture.get(), mip - residentMip, 0, 0, 0, texture.Texture.get(), mip - texture.ResidentMip, nullptr);
+        }
+        else if (load != nullptr && load->Mip == mip)
+        {
+            _renderBackend->UpdateSubresource(newTexture.get(), mip - residentMip, nullptr, load->Pixels.data(), load->Source.RowPitch, load->Source.SlicePitch);
+        }
+    }
+
+    RenderShaderResourceViewDescription shaderResourceViewDescription = {};
+    shaderResourceViewDescription.Format = ddsTexture.Format;
+    shaderResourceViewDescription.Dimension = RenderShaderResourceViewDimension::Texture2D;
+    shaderResourceViewDescription.MipLevels = textureDescription.MipLevels;
+    std::shared_ptr<RenderShaderResourceView> newShaderResourceView = nullptr;
+    if (!_renderBackend->CreateShaderResourceView(newTexture.get(), shaderResourceViewDescription, newShaderResourceView))
+    {
+        std::cout << "TextureStreamer: Failed to create shader resource view out of texture\n";
+        return false;
+    }
+
+    // Views bound earlier keep the old texture alive until the device context lets go of them
+    texture.Texture = std::move(newTexture);
+    texture.ShaderResourceView = std::move(newShaderResourceView);
+    texture.ResidentMip = residentMip;
+    _residentBytes = _residentBytes - texture.ResidentBytes + residentBytes;
+    texture.ResidentBytes = residentBytes;
+    return true;
+}
+
+uint32_t TextureStreamer::GetDesiredMip(const StreamedTexture& texture) const
+{
+    if (texture.LastUsedFrame != _frame || texture.ScreenSize <= 0.0f)
+    {
+        return texture.TailMip;
+    }
+
+    // A level with more texels than the pixels it covers would only alias, the mip chain would skip it anyway
+    const uint32_t size = texture.Dds.Width > texture.Dds.Height ? texture.Dds.Width : texture.Dds.Height;
+    uint32_t mip = 0;
+    while (mip < texture.TailMip && static_cast<float>(GetMipSize(size, mip + 1)) >= texture.ScreenSize)
+    {
+        mip++;
+    }
+
+    return mip;
+}
+
+bool TextureStreamer::IsEvictable(
+    const StreamedTexture& texture,
+    const StreamedTexture& requester) const
+{
+    if (!texture.IsAllocated || &texture == &requester || texture.ResidentMip >= texture.TailMip)
+    {
+        return false;
+    }
+
+    // Levels more detailed than the texture needs right now go first, then those of textures used less recently or smaller on screen
+    return texture.ResidentMip < texture.DesiredMip ||
+           texture.LastUsedFrame < requester.LastUsedFrame ||
+           (texture.LastUsedFrame == requester.LastUsedFrame && texture.ScreenSize < requester.ScreenSize);
+}
+
+bool TextureStreamer::CanMakeRoom(
+    const uint64_t size,
+    const StreamedTexture& requester) const
+{
+    uint64_t evictableBytes = 0;
+    for (const StreamedTexture& texture : _textures)
+    {
+        if (!IsEvictable(texture, requester))
+        {
+            continue;
+        }
+
+        for (uint32_t mip = texture.ResidentMip; mip < texture.TailMip; mip++)
+        {
+            evictableBytes += texture.Dds.Subresources[mip].SlicePitch;
+        }
+    }
+
+    return _residentBytes + size <= _memoryBudget + evictableBytes;
+}
+
+bool TextureStreamer::MakeRoom(
+    const uint64_t size,
+    const StreamedTexture& requester)
+{
+    while (_residentBytes + size > _memoryBudget)
+    {
+        StreamedTexture* victim = nullptr;
+        for (StreamedTexture& texture : _textures)
+        {
+            if (!IsEvictable(texture, requester))
+            {
+                continue;
+            }
+
+            const bool isUnneeded = texture.ResidentMip < texture.DesiredMip;
+            const bool isVictimUnneeded = victim != nullptr && victim->ResidentMip < victim->DesiredMip;
+            if (victim == nullptr ||
+                (isUnneeded && !isVictimUnneeded) ||
+                (isUnneeded == isVictimUnneeded &&
+                 (texture.LastUsedFrame < victim->LastUsedFrame ||
+                  (texture.LastUsedFrame == victim->LastUsedFrame && texture.ScreenSize < victim->ScreenSize))))
+            {
+                victim = &texture;
+            }
+        }
+
+        // Dropping a level means copying the others into a smaller texture, the victim's most detailed level goes
+        if (victim == nullptr || !CreateResidentTexture(*victim, victim->ResidentMip + 1, nullptr))
+        {
+            return false;
+        }
+        _evictions++;
+    }
+
+    return true;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "DdsReader.hpp"
+#include "RenderTypes.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class MemoryMappedFile;
+class RenderBackend;
+
+using StreamedTextureHandle = uint32_t;
+constexpr StreamedTextureHandle InvalidStreamedTextureHandle = ~0u;
+
+struct TextureStreamingStatistics
+{
+    uint32_t Textures = 0;
+    uint64_t ResidentBytes = 0;
+    uint64_t MemoryBudget = 0;
+    uint32_t PendingLoads = 0;
+    uint32_t CompletedLoads = 0;
+    uint32_t CancelledLoads = 0;
+    uint32_t Evictions = 0;
+    uint32_t Uploads = 0;
+    uint64_t UploadedBytes = 0;
+};
+
+// Streams the mips of 2D DDS textures in as they are needed. Creating a texture only uploads its
+// mip tail, the levels at most tailSize texels wide and high, so it can be drawn right away.
+// Every frame the textures in use report how large they are on screen, and Update has the I/O
+// threads read the next level of those needing more detail, largest on screen first. Levels are
+// added and dropped by recreating the texture with one level more or less and copying the others
+// over on the GPU, so only resident levels take up memory. When a level does not fit into the
+// memory budget, levels nobody needs and then those of the least recently used textures are
+// dropped to make room. Tails are never dropped. Block compressed tails start no deeper than the
+// last level which is still a multiple of 4 texels wide and high, D3D11 creates no others.
+class TextureStreamer
+{
+public:
+    TextureStreamer(
+        const std::shared_ptr<RenderBackend>& renderBackend,
+        uint64_t memoryBudget,
+        uint32_t tailSize,
+        uint32_t ioThreadCount);
+    ~TextureStreamer();
+
+    bool CreateTexture(
+        const std::wstring& filePath,
+        StreamedTextureHandle& handle);
+    void DestroyTexture(StreamedTextureHandle handle);
+
+    // screenSize is how many pixels across the surfaces using the texture cover this frame,
+    // the texture streams towards the smallest level with at least as many texels
+    void RequestResidency(
+        StreamedTextureHandle handle,
+        float screenSize);
+    // Called once a frame after the requests, applies finished loads and starts new ones
+    void Update();
+
+    // The view changes whenever levels come or go, so it is looked up again every frame
+    [[nodiscard]] const std::shared_ptr<RenderShaderResourceView>& GetShaderResourceView(StreamedTextureHandle handle) const;
+    [[nodiscard]] uint32_t GetResidentMip(StreamedTextureHandle handle) const;
+    [[nodiscard]] TextureStreamingStatistics GetStatistics() const;
+    void PrintStatistics() const;
+
+private:
+    static constexpr uint32_t NoMip = ~0u;
+
+    struct StreamedTexture
+    {
+        // Kept alive by loads in flight as well, a texture may be destroyed while its level is read
+        std::shared_ptr<MemoryMappedFile> File = nullptr;
+        DdsTexture Dds = {};
+        std::shared_ptr<RenderTexture2D> Texture = nullptr;
+        std::shared_ptr<RenderShaderResourceView> ShaderResourceView = nullptr;
+        uint32_t TailMip = 0;
+        uint32_t ResidentMip = 0;
+        uint32_t DesiredMip = 0;
+        uint32_t LoadingMip = NoMip;
+        uint64_t ResidentBytes = 0;
+        uint64_t LastUsedFrame = 0;
+        float ScreenSize = 0.0f;
+        uint32_t Generation = 0;
+        bool IsAllocated = false;
+    };
+
+    struct MipLoad
+    {
+        uint32_t TextureIndex = 0;
+        uint32_t Generation = 0;
+        uint32_t Mip = 0;
+        float Priority = 0.0f;
+        std::shared_ptr<MemoryMappedFile> File = nullptr;
+        RenderSubresourceData Source = {};
+        std::vector<uint8_t> Pixels;
+    };
+
+    void RunIoThread();
+    bool CreateResidentTexture(
+        StreamedTexture& texture,
+        uint32_t residentMip,
+        const MipLoad* load);
+    [[nodiscard]] uint32_t GetDesiredMip(const StreamedTexture& texture) const;
+    [[nodiscard]] bool IsEvictable(
+        const StreamedTexture& texture,
+        const StreamedTexture& requester) const;
+    [[nodiscard]] bool CanMakeRoom(
+        uint64_t size,
+        const StreamedTexture& requester) const;
+    bool MakeRoom(
+        uint64_t size,
+        const StreamedTexture& requester);
+
+    std::shared_ptr<RenderBackend> _renderBackend = nullptr;
+    uint64_t _memoryBudget = 0;
+    uint32_t _tailSize = 0;
+    std::vector<StreamedTexture> _textures;
+    std::vector<uint32_t> _freeTextureIndices;
+    uint64_t _residentBytes = 0;
+    uint64_t _frame = 1;
+
+    std::vector<std::thread> _ioThreads;
+    mutable std::mutex _loadMutex;
+    std::condition_variable _loadCondition;
+    std::vector<MipLoad> _pendingLoads;
+    std::vector<MipLoad> _completedLoads;
+    bool _isStopping = false;
+
+    uint32_t _loads = 0;
+    uint32_t _cancelledLoads = 0;
+    uint32_t _evictions = 0;
+    uint32_t _uploads = 0;
+    uint64_t _uploadedBytes = 0;
+};
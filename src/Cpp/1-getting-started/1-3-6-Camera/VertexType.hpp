@@ -2,13 +2,19 @@
 
 #include <DirectXMath.h>
 
+#include <cstddef>
+#include <cstdint>
+
 enum class VertexType
 {
     PositionColor,
-    PositionColorUv
+    PositionColorUv,
+    QuantizedPositionNormalColorHalfUv,
+    QuantizedPositionNormalColorUnormUv
 };
 
 using Position = DirectX::XMFLOAT3;
+using Normal = DirectX::XMFLOAT3;
 using Color = DirectX::XMFLOAT3;
 using Uv = DirectX::XMFLOAT2;
 
@@ -24,3 +30,37 @@ struct VertexPositionColorUv
     Color color;
     Uv uv;
 };
+
+// Full precision vertex models are imported into before they are converted to what the GPU reads
+struct VertexPositionNormalColorUv
+{
+    Position position;
+    Normal normal;
+    Color color;
+    Uv uv;
+};
+
+// Positions are unorm16 within the submesh bounds, see Submesh::PositionScale. Normals are
+// octahedral encoded snorm16, colors unorm8 and uvs half floats or unorm16 depending on the VertexType.
+struct VertexQuantizedPositionNormalColorUv
+{
+    uint16_t position[4];
+    int16_t normal[2];
+    uint8_t color[4];
+    uint16_t uv[2];
+};
+
+inline size_t GetVertexSize(const VertexType vertexType)
+{
+    switch (vertexType)
+    {
+    case VertexType::PositionColor:
+        return sizeof(VertexPositionColor);
+    case VertexType::PositionColorUv:
+        return sizeof(VertexPositionColorUv);
+    case VertexType::QuantizedPositionNormalColorHalfUv:
+    case VertexType::QuantizedPositionNormalColorUnormUv:
+        return sizeof(VertexQuantizedPositionNormalColorUv);
+    }
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include "VertexWelder.hpp"
+#include "Model.hpp"
+
+#include <Hash.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace
+{
+constexpr uint32_t InvalidVertex = ~0u;
+
+bool IsWithinEpsilon(
+    const VertexPositionNormalColorUv& left,
+    const VertexPositionNormalColorUv& right,
+    const float epsilon)
+{
+    // The vertex is a tightly packed struct of floats, so it can be compared as an array
+    constexpr uint32_t componentCount = sizeof(VertexPositionNormalColorUv) / sizeof(float);
+    float leftComponents[componentCount];
+    float rightComponents[componentCount];
+    std::memcpy(leftComponents, &left, sizeof(VertexPositionNormalColorUv));
+    std::memcpy(rightComponents, &right, sizeof(VertexPositionNormalColorUv));
+    for (uint32_t i = 0; i < componentCount; i++)
+    {
+        if (std::fabs(leftComponents[i] - rightComponents[i]) > epsilon)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+uint64_t HashCell(
+    const int64_t x,
+    const int64_t y,
+    const int64_t z)
+{
+    const int64_t cell[] = { x, y, z };
+    return HashBytes(cell, sizeof(cell));
+}
+} // namespace
+
+VertexWelder::VertexWelder(const float epsilon)
+{
+    _epsilon = epsilon;
+}
+
+void VertexWelder::Weld(
+    std::vector<VertexPositionNormalColorUv>& vertices,
+    std::vector<uint32_t>& indices,
+    std::vector<Submesh>& submeshes)
+{
+    _statistics = {};
+    _statistics.VerticesBefore = static_cast<uint32_t>(vertices.size());
+
+    std::vector<VertexPositionNormalColorUv> uniqueVertices;
+    uniqueVertices.reserve(vertices.size());
+    std::vector<uint32_t> vertexRemap;
+    for (Submesh& submesh : submeshes)
+    {
+        const uint32_t baseVertex = static_cast<uint32_t>(uniqueVertices.size());
+        _bucketHeads.clear();
+        _nextInBucket.clear();
+
+        vertexRemap.resize(submesh.VertexCount);
+        for (uint32_t i = 0; i < submesh.VertexCount; i++)
+        {
+            const VertexPositionNormalColorUv& vertex = vertices[submesh.BaseVertex + i];
+            uint64_t bucketKey = 0;
+            const uint32_t uniqueVertex = _epsilon > 0.0f
+                                            ? FindNearbyVertex(uniqueVertices, baseVertex, vertex, bucketKey)
+                                            : FindExactVertex(uniqueVertices, baseVertex, vertex, bucketKey);
+            if (uniqueVertex != InvalidVertex)
+            {
+                vertexRemap[i] = uniqueVertex;
+                continue;
+            }
+
+            const uint32_t newVertex = static_cast<uint32_t>(uniqueVertices.size()) - baseVertex;
+            const auto bucketHead = _bucketHeads.find(bucketKey);
+            _nextInBucket.push_back(bucketHead != _bucketHeads.end() ? bucketHead->second : InvalidVertex);
+            _bucketHeads[bucketKey] = newVertex;
+            uniqueVertices.push_back(vertex);
+            vertexRemap[i] = newVertex;
+        }
+
+        for (uint32_t i = submesh.IndexOffset; i < submesh.IndexOffset + submesh.IndexCount; i++)
+        {
+            indices[i] = vertexRemap[indices[i]];
+        }
+
+        submesh.BaseVertex = static_cast<int32_t>(baseVertex);
+        submesh.VertexCount = static_cast<uint32_t>(uniqueVertices.size()) - baseVertex;
+    }
+
+    vertices = std::move(uniqueVertices);
+    _statistics.VerticesAfter = static_cast<uint32_t>(vertices.size());
+}
+
+const VertexWelderStatistics& VertexWelder::GetStatistics() const
+{
+    return _statistics;
+}
+
+void VertexWelder::PrintStatistics() const
+{
+    std::cout << "VertexWelder: " << _statistics.VerticesBefore << " -> " << _statistics.VerticesAfter << " vertices"
+              << (_epsilon > 0.0f ? " (epsilon " + std::to_string(_epsilon) + ")\n" : " (exact)\n");
+}
+
+uint32_t VertexWelder::FindExactVertex(
+    const std::vector<VertexPositionNormalColorUv>& uniqueVertices,
+    const uint32_t baseVertex,
+    const VertexPositionNormalColorUv& vertex,
+    uint64_t& bucketKey) const
+{
+    bucketKey = HashBytes(&vertex, sizeof(VertexPositionNormalColorUv));
+    const auto bucketHead = _bucketHeads.find(bucketKey);
+    if (bucketHead == _bucketHeads.end())
+    {
+        return InvalidVertex;
+    }
+
+    for (uint32_t candidate = bucketHead->second; candidate != InvalidVertex; candidate = _nextInBucket[candidate])
+    {
+        if (std::memcmp(&uniqueVertices[baseVertex + candidate], &vertex, sizeof(VertexPositionNormalColorUv)) == 0)
+        {
+            return candidate;
+        }
+    }
+
+    return InvalidVertex;
+}
+
+// Positions are bucketed into cells of epsilon size, a match can only be in the
+// vertex's own cell or one of its 26 neighbours
+uint32_t VertexWelder::FindNearbyVertex(
+    const std::vector<VertexPositionNormalColorUv>& uniqueVertices,
+    const uint32_t baseVertex,
+    const VertexPositionNormalColorUv& vertex,
+    uint64_t& bucketKey) const
+{
+    const int64_t cellX = static_cast<int64_t>(std::floor(vertex.position.x / _epsilon));
+    const int64_t cellY = static_cast<int64_t>(std::floor(vertex.position.y / _epsilon));
+    const int64_t cellZ = static_cast<int64_t>(std::floor(vertex.position.z / _epsilon));
+    bucketKey = HashCell(cellX, cellY, cellZ);
+
+    for (int64_t z = cellZ - 1; z <= cellZ + 1; z++)
+    {
+        for (int64_t y = cellY - 1; y <= cellY + 1; y++)
+        {
+            for (int64_t x = cellX - 1; x <= cellX + 1; x++)
+            {
+                const auto bucketHead = _bucketHeads.find(HashCell(x, y, z));
+                if (bucketHead == _bucketHeads.end())
+                {
+                    continue;
+                }
+
+                for (uint32_t candidate = bucketHead->second; candidate != InvalidVertex; candidate = _nextInBucket[candidate])
+                {
+                    if (IsWithinEpsilon(uniqueVertices[baseVertex + candidate], vertex, _epsilon))
+                    {
+                        return candidate;
+                    }
+                }
+            }
+        }
+    }
+
+    return InvalidVertex;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "VertexType.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct Submesh;
+
+struct VertexWelderStatistics
+{
+    uint32_t VerticesBefore = 0;
+    uint32_t VerticesAfter = 0;
+};
+
+// Merges duplicate vertices within each submesh and remaps its indices to the unique ones.
+// With an epsilon of 0 only bitwise identical vertices are merged, otherwise a vertex is merged
+// into the first unique vertex whose position, normal, color and uv are all within epsilon of it.
+class VertexWelder
+{
+public:
+    VertexWelder(float epsilon);
+
+    void Weld(
+        std::vector<VertexPositionNormalColorUv>& vertices,
+        std::vector<uint32_t>& indices,
+        std::vector<Submesh>& submeshes);
+
+    [[nodiscard]] const VertexWelderStatistics& GetStatistics() const;
+    void PrintStatistics() const;
+
+private:
+    uint32_t FindExactVertex(
+        const std::vector<VertexPositionNormalColorUv>& uniqueVertices,
+        uint32_t baseVertex,
+        const VertexPositionNormalColorUv& vertex,
+        uint64_t& bucketKey) const;
+    uint32_t FindNearbyVertex(
+        const std::vector<VertexPositionNormalColorUv>& uniqueVertices,
+        uint32_t baseVertex,
+        const VertexPositionNormalColorUv& vertex,
+        uint64_t& bucketKey) const;
+
+    float _epsilon = 0.0f;
+    VertexWelderStatistics _statistics = {};
+
+    // Unique vertices of the current submesh chained per bucket, indices are relative to the submesh
+    std::unordered_map<uint64_t, uint32_t> _bucketHeads;
+    std::vector<uint32_t> _nextInBucket;
+};
@@ -17,6 +17,14 @@ Application::~Application()
 
 bool Application::Initialize()
 {
+    if (_isHeadless)
+    {
+        _width = 1280;
+        _height = 720;
+        _currentTime = std::chrono::high_resolution_clock::now();
+        return true;
+    }
+
     if (!glfwInit())
     {
         std::cerr << "GLFW: Failed to initialize\n";
@@ -65,6 +73,11 @@ void Application::OnResize(
 
 void Application::Cleanup()
 {
+    if (_isHeadless)
+    {
+        return;
+    }
+
     glfwDestroyWindow(_window);
     glfwTerminate();
 }
@@ -88,6 +101,46 @@ void Application::Run()
     }
 }
 
+bool Application::RunHeadless(const uint32_t frameCount)
+{
+    _isHeadless = true;
+    if (!Initialize())
+    {
+        std::cerr << "Application: Failed to initialize the headless run\n";
+        return false;
+    }
+
+    if (!Load())
+    {
+        std::cerr << "Application: Failed to load the headless run\n";
+        return false;
+    }
+
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        Update();
+        Render();
+    }
+    const std::chrono::duration<double, std::milli> elapsedTime = std::chrono::high_resolution_clock::now() - startTime;
+
+    std::cout << "Application: Ran " << frameCount << " headless frames in " << elapsedTime.count() << " ms";
+    if (frameCount > 0)
+    {
+        std::cout << " (" << elapsedTime.count() / frameCount << " ms per frame)";
+    }
+    std::cout << "\n";
+
+    const uint64_t validationErrorCount = GetValidationErrorCount();
+    if (validationErrorCount > 0)
+    {
+        std::cerr << "Application: Headless run failed with " << validationErrorCount << " validation errors\n";
+        return false;
+    }
+
+    return true;
+}
+
 void Application::HandleResize(
     GLFWwindow* window,
     const int32_t width,
@@ -97,6 +150,11 @@ void Application::HandleResize(
     application->OnResize(width, height);
 }
 
+bool Application::IsHeadless() const
+{
+    return _isHeadless;
+}
+
 GLFWwindow* Application::GetWindow() const
 {
     return _window;
@@ -112,6 +170,11 @@ int32_t Application::GetWindowHeight() const
     return _height;
 }
 
+uint64_t Application::GetValidationErrorCount() const
+{
+    return 0;
+}
+
 void Application::Update()
 {
     auto oldTime = _currentTime;
@@ -119,5 +182,8 @@ void Application::Update()
 
     std::chrono::duration<double, std::milli> timeSpan = (_currentTime - oldTime);
     _deltaTime = static_cast<float>(timeSpan.count() / 1000.0);
-    glfwPollEvents();
+    if (!_isHeadless)
+    {
+        glfwPollEvents();
+    }
 }
@@ -14,6 +14,9 @@ public:
     virtual ~Application();
 
     void Run();
+    // Runs Update and Render for frameCount frames without creating a window. Fails when
+    // initializing or loading fails, or when the application reports validation errors
+    [[nodiscard]] bool RunHeadless(uint32_t frameCount);
 
 protected:
     static void HandleResize(
@@ -29,7 +32,10 @@ protected:
     virtual void Cleanup();
     virtual void Render() = 0;
     virtual void Update();
+    // Errors the render backend found in the calls of a headless run, 0 when it does not check them
+    [[nodiscard]] virtual uint64_t GetValidationErrorCount() const;
 
+    [[nodiscard]] bool IsHeadless() const;
     [[nodiscard]] GLFWwindow* GetWindow() const;
     [[nodiscard]] int32_t GetWindowWidth() const;
     [[nodiscard]] int32_t GetWindowHeight() const;
@@ -41,4 +47,5 @@ private:
     std::chrono::high_resolution_clock::time_point _currentTime;
     GLFWwindow* _window = nullptr;
     std::string _title;
+    bool _isHeadless = false;
 };
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+constexpr uint64_t HashSeed = 14695981039346656037ull;
+
+// FNV-1a, stable across runs and platforms so hashes can be stored in files on disk
+inline uint64_t HashBytes(
+    const void* data,
+    const size_t size,
+    uint64_t hash = HashSeed)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
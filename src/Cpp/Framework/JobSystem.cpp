@@ -0,0 +1,134 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+
+JobSystem::JobSystem()
+{
+    const uint32_t threadCount = std::thread::hardware_concurrency();
+    for (uint32_t i = 1; i < threadCount; i++)
+    {
+        _workers.emplace_back(&JobSystem::RunWorker, this);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _batchAdded.notify_all();
+
+    for (std::thread& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+JobSystem& JobSystem::Get()
+{
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+bool JobSystem::RunJobs(
+    const uint32_t jobCount,
+    const std::function<bool(uint32_t)>& job)
+{
+    if (jobCount == 0)
+    {
+        return true;
+    }
+
+    JobBatch batch;
+    batch.Job = &job;
+    batch.JobCount = jobCount;
+
+    // A single job runs on the calling thread alone, waking the workers would only cost time
+    const bool isShared = jobCount > 1 && !_workers.empty();
+    if (isShared)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _batches.push_back(&batch);
+        }
+        _batchAdded.notify_all();
+    }
+
+    RunBatch(batch);
+
+    if (isShared)
+    {
+        // The batch lives on this stack, so it stays listed until no worker holds on to it anymore
+        std::unique_lock<std::mutex> lock(_mutex);
+        _batchFinished.wait(lock, [&]()
+        {
+            return batch.FinishedJobCount == batch.JobCount && batch.WorkerCount == 0;
+        });
+        _batches.erase(std::find(_batches.begin(), _batches.end(), &batch));
+    }
+
+    return !batch.HasFailed;
+}
+
+uint32_t JobSystem::GetWorkerCount() const
+{
+    return static_cast<uint32_t>(_workers.size());
+}
+
+void JobSystem::RunWorker()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        JobBatch* batch = nullptr;
+        _batchAdded.wait(lock, [&]()
+        {
+            batch = FindBatch();
+            return _isStopping || batch != nullptr;
+        });
+
+        if (_isStopping)
+        {
+            return;
+        }
+
+        batch->WorkerCount++;
+        lock.unlock();
+        RunBatch(*batch);
+        lock.lock();
+        batch->WorkerCount--;
+        _batchFinished.notify_all();
+    }
+}
+
+void JobSystem::RunBatch(JobBatch& batch)
+{
+    for (uint32_t jobIndex = batch.NextJob++; jobIndex < batch.JobCount; jobIndex = batch.NextJob++)
+    {
+        if (!batch.HasFailed && !(*batch.Job)(jobIndex))
+        {
+            batch.HasFailed = true;
+        }
+
+        // Skipped jobs count as finished as well, so a failed batch still completes
+        if (++batch.FinishedJobCount == batch.JobCount)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _batchFinished.notify_all();
+        }
+    }
+}
+
+JobSystem::JobBatch* JobSystem::FindBatch() const
+{
+    for (JobBatch* batch : _batches)
+    {
+        if (batch->NextJob < batch->JobCount)
+        {
+            return batch;
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A pool of worker threads shared by everything in the process. It is started on first use with
+// one thread less than the hardware has, because the thread calling RunJobs works on its jobs too.
+// Several threads may run batches at the same time, and jobs may run batches of their own.
+class JobSystem
+{
+public:
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    static JobSystem& Get();
+
+    // Calls job with every index below jobCount, spread over the workers and the calling thread, and
+    // returns once all of them finished. A job returns false to fail the batch, the jobs which did not
+    // start yet are skipped then.
+    bool RunJobs(
+        uint32_t jobCount,
+        const std::function<bool(uint32_t)>& job);
+
+    [[nodiscard]] uint32_t GetWorkerCount() const;
+
+private:
+    struct JobBatch
+    {
+        const std::function<bool(uint32_t)>* Job = nullptr;
+        uint32_t JobCount = 0;
+        std::atomic<uint32_t> NextJob = 0;
+        std::atomic<uint32_t> FinishedJobCount = 0;
+        std::atomic<bool> HasFailed = false;
+        uint32_t WorkerCount = 0;
+    };
+
+    JobSystem();
+
+    void RunWorker();
+    void RunBatch(JobBatch& batch);
+    [[nodiscard]] JobBatch* FindBatch() const;
+
+    std::vector<std::thread> _workers;
+    std::vector<JobBatch*> _batches;
+    std::mutex _mutex;
+    std::condition_variable _batchAdded;
+    std::condition_variable _batchFinished;
+    bool _isStopping = false;
+};
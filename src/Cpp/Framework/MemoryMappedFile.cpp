@@ -0,0 +1,154 @@
+#include "MemoryMappedFile.hpp"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    Close();
+}
+
+#if defined(_WIN32)
+bool MemoryMappedFile::Open(const std::filesystem::path& filePath)
+{
+    Close();
+
+    const HANDLE file = CreateFileW(
+        filePath.wstring().c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    _file = reinterpret_cast<intptr_t>(file);
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        Close();
+        return false;
+    }
+
+    // Empty files cannot be mapped, they are still valid files though
+    _size = static_cast<size_t>(fileSize.QuadPart);
+    if (_size == 0)
+    {
+        return true;
+    }
+
+    _mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    _data = static_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (_data == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MemoryMappedFile::Close()
+{
+    if (_data != nullptr)
+    {
+        UnmapViewOfFile(_data);
+        _data = nullptr;
+    }
+    if (_mapping != nullptr)
+    {
+        CloseHandle(_mapping);
+        _mapping = nullptr;
+    }
+    if (_file != -1)
+    {
+        CloseHandle(reinterpret_cast<HANDLE>(_file));
+        _file = -1;
+    }
+    _size = 0;
+}
+#else
+bool MemoryMappedFile::Open(const std::filesystem::path& filePath)
+{
+    Close();
+
+    const int file = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file == -1)
+    {
+        return false;
+    }
+    _file = file;
+
+    struct stat fileStatus = {};
+    if (fstat(file, &fileStatus) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    // Empty files cannot be mapped, they are still valid files though
+    _size = static_cast<size_t>(fileStatus.st_size);
+    if (_size == 0)
+    {
+        return true;
+    }
+
+    void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+    _data = static_cast<const uint8_t*>(data);
+
+    // Same as FILE_FLAG_SEQUENTIAL_SCAN, only a hint
+    madvise(data, _size, MADV_SEQUENTIAL);
+    return true;
+}
+
+void MemoryMappedFile::Close()
+{
+    if (_data != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(_data), _size);
+        _data = nullptr;
+    }
+    if (_file != -1)
+    {
+        close(static_cast<int>(_file));
+        _file = -1;
+    }
+    _size = 0;
+}
+#endif
+
+bool MemoryMappedFile::IsOpen() const
+{
+    return _file != -1;
+}
+
+const uint8_t* MemoryMappedFile::GetData() const
+{
+    return _data;
+}
+
+size_t MemoryMappedFile::GetSize() const
+{
+    return _size;
+}
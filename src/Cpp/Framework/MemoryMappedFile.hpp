@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// Read-only view of a whole file, the pages are only read from disk when they are touched
+class MemoryMappedFile
+{
+public:
+    MemoryMappedFile() = default;
+    ~MemoryMappedFile();
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    bool Open(const std::filesystem::path& filePath);
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const;
+    [[nodiscard]] const uint8_t* GetData() const;
+    [[nodiscard]] size_t GetSize() const;
+
+private:
+    // A HANDLE on Windows and a file descriptor elsewhere, both use -1 as the invalid value.
+    // Only Windows needs a mapping object next to the view
+    intptr_t _file = -1;
+    void* _mapping = nullptr;
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+};
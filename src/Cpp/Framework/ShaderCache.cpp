@@ -0,0 +1,325 @@
+#include "ShaderCache.hpp"
+#include "Hash.hpp"
+
+#include <d3dcompiler.h>
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+constexpr uint32_t CacheFileMagic = 0x43534C44; // "DLSC"
+constexpr uint32_t CacheFileVersion = 1;
+
+struct ShaderInclude
+{
+    std::string FilePath;
+    uint64_t ContentHash = 0;
+};
+
+enum class CacheEntryState
+{
+    Missing,
+    Stale,
+    Valid
+};
+
+bool ReadFile(const std::filesystem::path& filePath, std::string& content)
+{
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+
+    content.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(content.data(), static_cast<std::streamsize>(content.size()));
+    return file.good() || content.empty();
+}
+
+template <typename T>
+void WriteValue(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadValue(std::ifstream& file, T& value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Resolves includes relative to the including file, the way D3D_COMPILE_STANDARD_FILE_INCLUDE
+// does, and remembers every file it opened so the cache entry can be validated later
+class RecordingIncludeHandler final : public ID3DInclude
+{
+public:
+    RecordingIncludeHandler(const std::filesystem::path& rootDirectory)
+        : _rootDirectory(rootDirectory)
+    {
+    }
+
+    HRESULT STDMETHODCALLTYPE Open(
+        D3D_INCLUDE_TYPE includeType,
+        LPCSTR fileName,
+        LPCVOID parentData,
+        LPCVOID* data,
+        UINT* byteSize) override
+    {
+        std::filesystem::path directory = _rootDirectory;
+        const auto parent = _openedFiles.find(parentData);
+        if (parent != _openedFiles.end())
+        {
+            directory = parent->second.parent_path();
+        }
+
+        const std::filesystem::path filePath = (directory / fileName).lexically_normal();
+        auto content = std::make_unique<std::string>();
+        if (!ReadFile(filePath, *content))
+        {
+            return E_FAIL;
+        }
+
+        _includes.push_back({ filePath.u8string(), HashBytes(content->data(), content->size()) });
+        _openedFiles[content->data()] = filePath;
+        *data = content->data();
+        *byteSize = static_cast<UINT>(content->size());
+        _contents.push_back(std::move(content));
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE Close(LPCVOID data) override
+    {
+        // Contents stay alive until the handler is destroyed, the compiler may still refer to them
+        return S_OK;
+    }
+
+    [[nodiscard]] const std::vector<ShaderInclude>& GetIncludes() const
+    {
+        return _includes;
+    }
+
+private:
+    std::filesystem::path _rootDirectory;
+    std::unordered_map<const void*, std::filesystem::path> _openedFiles;
+    std::vector<std::unique_ptr<std::string>> _contents;
+    std::vector<ShaderInclude> _includes;
+};
+
+CacheEntryState ReadCacheEntry(
+    const std::filesystem::path& cacheFilePath,
+    const uint64_t key,
+    Microsoft::WRL::ComPtr<ID3DBlob>& shaderBlob)
+{
+    std::ifstream file(cacheFilePath, std::ios::binary);
+    if (!file)
+    {
+        return CacheEntryState::Missing;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t storedKey = 0;
+    uint32_t includeCount = 0;
+    if (!ReadValue(file, magic) ||
+        !ReadValue(file, version) ||
+        !ReadValue(file, storedKey) ||
+        !ReadValue(file, includeCount) ||
+        magic != CacheFileMagic ||
+        version != CacheFileVersion ||
+        storedKey != key)
+    {
+        return CacheEntryState::Stale;
+    }
+
+    std::string includeContent;
+    for (uint32_t i = 0; i < includeCount; i++)
+    {
+        uint32_t filePathLength = 0;
+        uint64_t contentHash = 0;
+        if (!ReadValue(file, filePathLength))
+        {
+            return CacheEntryState::Stale;
+        }
+
+        std::string filePath(filePathLength, '\0');
+        if (!file.read(filePath.data(), filePathLength) || !ReadValue(file, contentHash))
+        {
+            return CacheEntryState::Stale;
+        }
+
+        if (!ReadFile(std::filesystem::u8path(filePath), includeContent) ||
+            HashBytes(includeContent.data(), includeContent.size()) != contentHash)
+        {
+            return CacheEntryState::Stale;
+        }
+    }
+
+    uint64_t byteCodeSize = 0;
+    if (!ReadValue(file, byteCodeSize) || byteCodeSize == 0)
+    {
+        return CacheEntryState::Stale;
+    }
+
+    Microsoft::WRL::ComPtr<ID3DBlob> tempShaderBlob = nullptr;
+    if (FAILED(D3DCreateBlob(static_cast<SIZE_T>(byteCodeSize), &tempShaderBlob)) ||
+        !file.read(static_cast<char*>(tempShaderBlob->GetBufferPointer()), static_cast<std::streamsize>(byteCodeSize)))
+    {
+        return CacheEntryState::Stale;
+    }
+
+    shaderBlob = std::move(tempShaderBlob);
+    return CacheEntryState::Valid;
+}
+
+bool WriteCacheEntry(
+    const std::filesystem::path& cacheFilePath,
+    const uint64_t key,
+    const std::vector<ShaderInclude>& includes,
+    ID3DBlob* shaderBlob)
+{
+    std::error_code errorCode;
+    std::filesystem::create_directories(cacheFilePath.parent_path(), errorCode);
+
+    // Written to a temporary file first so a crash or a concurrent reader never sees half an entry
+    std::filesystem::path temporaryFilePath = cacheFilePath;
+    temporaryFilePath += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+
+        WriteValue(file, CacheFileMagic);
+        WriteValue(file, CacheFileVersion);
+        WriteValue(file, key);
+        WriteValue(file, static_cast<uint32_t>(includes.size()));
+        for (const ShaderInclude& include : includes)
+        {
+            WriteValue(file, static_cast<uint32_t>(include.FilePath.size()));
+            file.write(include.FilePath.data(), static_cast<std::streamsize>(include.FilePath.size()));
+            WriteValue(file, include.ContentHash);
+        }
+
+        WriteValue(file, static_cast<uint64_t>(shaderBlob->GetBufferSize()));
+        file.write(static_cast<const char*>(shaderBlob->GetBufferPointer()), static_cast<std::streamsize>(shaderBlob->GetBufferSize()));
+        if (!file)
+        {
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporaryFilePath, cacheFilePath, errorCode);
+    if (errorCode)
+    {
+        std::filesystem::remove(temporaryFilePath, errorCode);
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+ShaderCache::ShaderCache(const std::filesystem::path& cacheDirectory)
+    : _cacheDirectory(cacheDirectory)
+{
+}
+
+bool ShaderCache::CompileShader(
+    const std::wstring& filePath,
+    const std::string& entryPoint,
+    const std::string& profile,
+    const uint32_t compileFlags,
+    Microsoft::WRL::ComPtr<ID3DBlob>& shaderBlob)
+{
+    std::string source;
+    if (!ReadFile(filePath, source))
+    {
+        std::cerr << "D3D11: Failed to read shader from file\n";
+        return false;
+    }
+
+    // Names are hashed including their terminator, so "Main" + "vs_5_0" differs from "Mainv" + "s_5_0"
+    constexpr uint32_t compilerVersion = D3D_COMPILER_VERSION;
+    uint64_t key = HashBytes(source.data(), source.size());
+    key = HashBytes(filePath.c_str(), (filePath.size() + 1) * sizeof(wchar_t), key);
+    key = HashBytes(entryPoint.c_str(), entryPoint.size() + 1, key);
+    key = HashBytes(profile.c_str(), profile.size() + 1, key);
+    key = HashBytes(&compileFlags, sizeof(compileFlags), key);
+    key = HashBytes(&compilerVersion, sizeof(compilerVersion), key);
+
+    char cacheFileName[32] = {};
+    snprintf(cacheFileName, sizeof(cacheFileName), "%016llx.cso", static_cast<unsigned long long>(key));
+    const std::filesystem::path cacheFilePath = _cacheDirectory / cacheFileName;
+
+    switch (ReadCacheEntry(cacheFilePath, key, shaderBlob))
+    {
+    case CacheEntryState::Valid:
+        _hits++;
+        return true;
+    case CacheEntryState::Stale:
+        _invalidations++;
+        break;
+    case CacheEntryState::Missing:
+        break;
+    }
+    _misses++;
+
+    const std::filesystem::path sourcePath = filePath;
+    const std::string sourceName = sourcePath.u8string();
+    RecordingIncludeHandler includeHandler(sourcePath.parent_path());
+
+    Microsoft::WRL::ComPtr<ID3DBlob> tempShaderBlob = nullptr;
+    Microsoft::WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
+    if (FAILED(D3DCompile(
+            source.data(),
+            source.size(),
+            sourceName.c_str(),
+            nullptr,
+            &includeHandler,
+            entryPoint.c_str(),
+            profile.c_str(),
+            compileFlags,
+            0,
+            &tempShaderBlob,
+            &errorBlob)))
+    {
+        std::cerr << "D3D11: Failed to compile shader from file\n";
+        if (errorBlob != nullptr)
+        {
+            std::cerr << "D3D11: With message: " << static_cast<const char*>(errorBlob->GetBufferPointer()) << "\n";
+        }
+
+        return false;
+    }
+
+    if (!WriteCacheEntry(cacheFilePath, key, includeHandler.GetIncludes(), tempShaderBlob.Get()))
+    {
+        std::cerr << "ShaderCache: Failed to write " << cacheFilePath.u8string() << "\n";
+    }
+
+    shaderBlob = std::move(tempShaderBlob);
+    return true;
+}
+
+ShaderCacheStatistics ShaderCache::GetStatistics() const
+{
+    ShaderCacheStatistics statistics = {};
+    statistics.Hits = _hits;
+    statistics.Misses = _misses;
+    statistics.Invalidations = _invalidations;
+    return statistics;
+}
+
+void ShaderCache::PrintStatistics() const
+{
+    std::cout << "ShaderCache: " << _hits << " hits, " << _misses << " misses (" << _invalidations << " invalidated)\n";
+}
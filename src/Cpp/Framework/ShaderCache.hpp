@@ -0,0 +1,42 @@
+#pragma once
+
+#include <d3dcommon.h>
+#include <wrl/client.h>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+struct ShaderCacheStatistics
+{
+    uint32_t Hits = 0;
+    uint32_t Misses = 0;
+    uint32_t Invalidations = 0;
+};
+
+// Keeps compiled shader bytecode on disk so later runs do not have to invoke the compiler.
+// Entries are named after a hash of the shader source, entry point, profile, compile flags and
+// compiler version. Each entry also records every file the shader included together with a hash
+// of its contents, an entry is only used when all of those still match.
+class ShaderCache
+{
+public:
+    ShaderCache(const std::filesystem::path& cacheDirectory);
+
+    bool CompileShader(
+        const std::wstring& filePath,
+        const std::string& entryPoint,
+        const std::string& profile,
+        uint32_t compileFlags,
+        Microsoft::WRL::ComPtr<ID3DBlob>& shaderBlob);
+
+    [[nodiscard]] ShaderCacheStatistics GetStatistics() const;
+    void PrintStatistics() const;
+
+private:
+    std::filesystem::path _cacheDirectory;
+    std::atomic<uint32_t> _hits = 0;
+    std::atomic<uint32_t> _misses = 0;
+    std::atomic<uint32_t> _invalidations = 0;
+};